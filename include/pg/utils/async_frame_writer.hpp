@@ -0,0 +1,356 @@
+/**
+ * @file async_frame_writer.hpp
+ * @brief 后台线程池异步保存图像帧
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_ASYNC_FRAME_WRITER_HPP_
+#define PG_UTILS_ASYNC_FRAME_WRITER_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "pg/utils/mpmc_queue.hpp"
+#include "pg/utils/opencv_helper.hpp"
+#include "vision_type/base_type.hpp"
+#include "vision_type/image_frame_ops.hpp"
+
+namespace pg {
+namespace utils {
+
+enum class FrameFileFormat {
+  /// 无损，16 位视差按 CV_16U 保存
+  kPng,
+  /// 16 位图像不支持 JPEG，按 PNG 保存
+  kJpeg,
+  /// 按 Stride() 原样写出主平面与 UV 平面，不编码
+  kRaw,
+};
+
+/**
+ * @brief 异步保存配置
+ */
+struct AsyncFrameWriterConfig {
+  /// 输出目录
+  std::string directory = ".";
+  FrameFileFormat format = FrameFileFormat::kPng;
+  /// 编码线程数，0 表示 hardware_concurrency() - 1（至少 1）
+  int num_threads = 0;
+  /// 待保存帧数上限，满时丢弃最旧的帧
+  size_t queue_depth = 32;
+  /// cv::IMWRITE_PNG_COMPRESSION，压缩级别越低越快
+  int png_compression = 1;
+  int jpeg_quality = 95;
+};
+
+/**
+ * @brief 异步保存统计
+ */
+struct AsyncFrameWriterStats {
+  uint64_t enqueued = 0;
+  uint64_t written = 0;
+  /// 因队列满丢弃的帧数
+  uint64_t dropped = 0;
+  /// 格式不支持或写文件失败的帧数
+  uint64_t failed = 0;
+  /// 编码（含颜色转换与写文件）耗时，微秒
+  double encode_us_avg = 0;
+  uint64_t encode_us_max = 0;
+  /// 入队到开始编码的等待时间，微秒
+  double queue_us_avg = 0;
+  size_t queued = 0;
+};
+
+/**
+ * @brief 把图像帧交给后台线程池编码为 PNG/JPEG 或原样写出
+ * @note Enqueue 只增加 ImageFramePtr 的引用计数，不拷贝像素，不加锁；只有
+ * 编码线程全部空闲时才会加锁唤醒。队列中的帧在写出前不会归还缓存池，
+ * queue_depth 不宜超过帧来源的缓存容量。文件名与示例程序一致：
+ * "<time_stamp>_ns_<channel_id>.png"，raw 格式为
+ * "<time_stamp>_ns_<channel_id>_<width>x<height>.<格式名>"。
+ * YUV 格式编码前转换为 BGR，GRAY 与 16 位视差直接编码。
+ */
+class AsyncFrameWriter {
+ public:
+  explicit AsyncFrameWriter(
+      const AsyncFrameWriterConfig &config = AsyncFrameWriterConfig())
+      : config_(config), queue_(config.queue_depth) {
+    int threads = config.num_threads;
+    if (threads <= 0) {
+      threads = std::max(
+          static_cast<int>(std::thread::hardware_concurrency()) - 1, 1);
+    }
+    for (int i = 0; i < threads; ++i) {
+      workers_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~AsyncFrameWriter() { Stop(); }
+
+  AsyncFrameWriter(const AsyncFrameWriter &) = delete;
+  AsyncFrameWriter &operator=(const AsyncFrameWriter &) = delete;
+
+  /**
+   * @brief  提交一帧，队列满时丢弃最旧的帧
+   * @retval true 未发生丢弃，false 丢弃了旧帧或已停止
+   */
+  bool Enqueue(const phigent::vision::ImageFramePtr &frame) {
+    if (!frame || stop_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    Item item{frame, Clock::now()};
+    bool no_drop = true;
+    while (!queue_.TryPush(item)) {
+      Item oldest;
+      if (queue_.TryPop(&oldest)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        no_drop = false;
+      }
+    }
+    enqueued_.fetch_add(1, std::memory_order_relaxed);
+    // 与 Wait 中的 sleepers_ 自增配对，保证不丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_one();
+    }
+    return no_drop;
+  }
+
+  /// 阻塞到队列中的帧全部写出
+  void Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cond_.wait(lock, [this] {
+      return workers_.empty() ||
+             enqueued_.load() ==
+                 written_.load() + failed_.load() + dropped_.load();
+    });
+  }
+
+  /// 写完队列中的帧后停止编码线程，之后 Enqueue 返回 false
+  void Stop() {
+    if (stop_.exchange(true)) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_all();
+    }
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    workers_.clear();
+    idle_cond_.notify_all();
+  }
+
+  AsyncFrameWriterStats Stats() const {
+    AsyncFrameWriterStats stats;
+    stats.enqueued = enqueued_.load();
+    stats.written = written_.load();
+    stats.dropped = dropped_.load();
+    stats.failed = failed_.load();
+    uint64_t done = stats.written + stats.failed;
+    if (done > 0) {
+      stats.encode_us_avg = static_cast<double>(encode_us_sum_.load()) / done;
+      stats.queue_us_avg = static_cast<double>(queue_us_sum_.load()) / done;
+    }
+    stats.encode_us_max = encode_us_max_.load();
+    stats.queued = queue_.SizeApprox();
+    return stats;
+  }
+
+  /**
+   * @brief  同步保存一帧，编码线程使用，也可直接调用
+   * @retval 0 成功，-1 格式不支持，-2 写文件失败
+   */
+  static int WriteFrame(const phigent::vision::ImageFramePtr &frame,
+                        const AsyncFrameWriterConfig &config) {
+    char name[96];
+    snprintf(name, sizeof(name), "/%llu_ns_%u",
+             static_cast<unsigned long long>(frame->time_stamp),
+             frame->channel_id);
+    std::string path = config.directory + name;
+    if (config.format == FrameFileFormat::kRaw) {
+      return WriteRaw(frame, path);
+    }
+    cv::Mat mat;
+    phigent::vision::ImageFramePtr bgr;
+    if (IsYuv(frame->pixel_format)) {
+      bgr = phigent::vision::CvtColorFrame(*frame, kPGPixelFormatRawBGR);
+      if (!bgr || helper::ImageFrame2CvMatRef(bgr, mat) != 0) {
+        return -1;
+      }
+    } else if (helper::ImageFrame2CvMatRef(frame, mat) != 0) {
+      return -1;
+    }
+    // mat 与调用方的帧共享内存，转换写到新的 Mat，不能原地修改
+    if (frame->pixel_format == kPGPixelFormatRawRGB) {
+      cv::Mat converted;
+      cv::cvtColor(mat, converted, cv::COLOR_RGB2BGR);
+      mat = converted;
+    } else if (frame->pixel_format == kPGPixelFormatRawRGBA) {
+      cv::Mat converted;
+      cv::cvtColor(mat, converted, cv::COLOR_RGBA2BGRA);
+      mat = converted;
+    }
+    std::vector<int> params;
+    bool jpeg = config.format == FrameFileFormat::kJpeg &&
+                mat.depth() == CV_8U;
+    if (mat.depth() == CV_16S) {
+      // PNG 只支持无符号 16 位，视差按位保存
+      mat = cv::Mat(mat.rows, mat.cols, CV_16UC1, mat.data, mat.step);
+    }
+    if (jpeg) {
+      path += ".jpg";
+      params = {cv::IMWRITE_JPEG_QUALITY, config.jpeg_quality};
+    } else {
+      path += ".png";
+      params = {cv::IMWRITE_PNG_COMPRESSION, config.png_compression};
+    }
+    try {
+      if (!cv::imwrite(path, mat, params)) {
+        return -2;
+      }
+    } catch (const cv::Exception &) {
+      return -1;
+    }
+    return 0;
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Item {
+    phigent::vision::ImageFramePtr frame;
+    Clock::time_point enqueue_time;
+  };
+
+  static bool IsYuv(PGPixelFormat format) {
+    switch (format) {
+      case kPGPixelFormatRawNV12:
+      case kPGPixelFormatRawNV21:
+      case kPGPixelFormatRawI420:
+      case kPGPixelFormatRawYV12:
+      case kPGPixelFormatYUYV:
+      case kPGPixelFormatUYVY:
+        return true;
+      default:
+        return false;
+    }
+  }
+
+  static int WriteRaw(const phigent::vision::ImageFramePtr &frame,
+                      std::string path) {
+    PGPixelFormat format = frame->pixel_format;
+    std::string format_name;
+    phigent::vision::StrCvtPixelFormat(format, format_name, true);
+    char suffix[48];
+    snprintf(suffix, sizeof(suffix), "_%ux%u.%s", frame->Width(),
+             frame->Height(),
+             format_name.empty() ? "raw" : format_name.c_str());
+    path += suffix;
+    if (frame->Data() == nullptr) {
+      return -1;
+    }
+    FILE *fd = fopen(path.c_str(), "wb");
+    if (fd == nullptr) {
+      return -2;
+    }
+    size_t size = frame->DataSize() != 0
+                      ? frame->DataSize()
+                      : static_cast<size_t>(frame->Stride()) * frame->Height();
+    bool ok = fwrite(frame->Data(), 1, size, fd) == size;
+    if (ok && frame->DataUV() != nullptr && frame->DataUVSize() > 0) {
+      ok = fwrite(frame->DataUV(), 1, frame->DataUVSize(), fd) ==
+           frame->DataUVSize();
+    }
+    ok = fclose(fd) == 0 && ok;
+    return ok ? 0 : -2;
+  }
+
+  bool Wait(Item *item) {
+    while (true) {
+      if (queue_.TryPop(item)) {
+        return true;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      if (queue_.TryPop(item)) {
+        sleepers_.fetch_sub(1);
+        return true;
+      }
+      if (stop_.load(std::memory_order_acquire)) {
+        sleepers_.fetch_sub(1);
+        return false;
+      }
+      cond_.wait(lock);
+      sleepers_.fetch_sub(1);
+    }
+  }
+
+  void Run() {
+    Item item;
+    while (Wait(&item)) {
+      auto start = Clock::now();
+      int ret = WriteFrame(item.frame, config_);
+      auto end = Clock::now();
+      uint64_t queue_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                              start - item.enqueue_time)
+                              .count();
+      uint64_t encode_us =
+          std::chrono::duration_cast<std::chrono::microseconds>(end - start)
+              .count();
+      queue_us_sum_.fetch_add(queue_us, std::memory_order_relaxed);
+      encode_us_sum_.fetch_add(encode_us, std::memory_order_relaxed);
+      uint64_t max = encode_us_max_.load(std::memory_order_relaxed);
+      while (encode_us > max &&
+             !encode_us_max_.compare_exchange_weak(max, encode_us)) {
+      }
+      item = Item();
+      if (ret == 0) {
+        written_.fetch_add(1);
+      } else {
+        failed_.fetch_add(1);
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      idle_cond_.notify_all();
+    }
+  }
+
+  AsyncFrameWriterConfig config_;
+  MpmcQueue<Item> queue_;
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::condition_variable idle_cond_;
+  std::atomic<int> sleepers_{0};
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> enqueued_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<uint64_t> failed_{0};
+  std::atomic<uint64_t> encode_us_sum_{0};
+  std::atomic<uint64_t> encode_us_max_{0};
+  std::atomic<uint64_t> queue_us_sum_{0};
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_ASYNC_FRAME_WRITER_HPP_
@@ -0,0 +1,105 @@
+/**
+ * @file bounded_queue.hpp
+ * @brief 定长阻塞队列，队列满时丢弃最旧元素
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_BOUNDED_QUEUE_HPP_
+#define PG_UTILS_BOUNDED_QUEUE_HPP_
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 预分配存储的环形队列，Push 不阻塞、不分配内存
+ * @note 多生产者/多消费者安全；生产者持锁时间为 O(1)
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  explicit BoundedQueue(size_t capacity)
+      : buf_(capacity > 0 ? capacity : 1) {}
+
+  /**
+   * @brief  入队，队列满时丢弃最旧的元素
+   * @param  item: 入队元素
+   * @retval true 未发生丢弃，false 丢弃了一个旧元素或队列已关闭
+   */
+  bool PushDropOldest(T item) {
+    bool no_drop = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        return false;
+      }
+      if (size_ == buf_.size()) {
+        buf_[head_] = T();
+        head_ = (head_ + 1) % buf_.size();
+        --size_;
+        no_drop = false;
+      }
+      buf_[(head_ + size_) % buf_.size()] = std::move(item);
+      ++size_;
+    }
+    cond_.notify_one();
+    return no_drop;
+  }
+
+  /**
+   * @brief  阻塞出队
+   * @param  *item: 出队元素
+   * @retval true 成功，false 队列已关闭且为空
+   */
+  bool Pop(T *item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return size_ > 0 || closed_; });
+    if (size_ == 0) {
+      return false;
+    }
+    *item = std::move(buf_[head_]);
+    buf_[head_] = T();
+    head_ = (head_ + 1) % buf_.size();
+    --size_;
+    return true;
+  }
+
+  /// 关闭队列，唤醒所有等待的消费者；已入队的元素仍可取出
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      closed_ = true;
+    }
+    cond_.notify_all();
+  }
+
+  size_t Size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+  }
+
+  size_t Capacity() const { return buf_.size(); }
+
+ private:
+  std::vector<T> buf_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  bool closed_ = false;
+  mutable std::mutex mutex_;
+  std::condition_variable cond_;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_BOUNDED_QUEUE_HPP_
@@ -0,0 +1,246 @@
+/**
+ * @file dispatch_queue.hpp
+ * @brief 可配置满队列策略的无锁分发队列
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_DISPATCH_QUEUE_HPP_
+#define PG_UTILS_DISPATCH_QUEUE_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "pg/utils/mpmc_queue.hpp"
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 队列满时的处理策略
+ */
+enum class QueuePolicy {
+  /// 丢弃最旧的元素，保留最新数据
+  kDropOldest = 0,
+  /// 丢弃新到的元素，保留已排队的数据
+  kDropNewest,
+  /// 阻塞生产者直到有空位，不丢数据
+  kBlock,
+  /// 只保留最新的一个元素，适合低延迟控制环
+  kLatestOnly,
+};
+
+/**
+ * @brief  解析策略名：drop_oldest/drop_newest/block/latest_only
+ * @retval 0 成功，-1 名称无效
+ */
+inline int ParseQueuePolicy(const std::string &name, QueuePolicy *policy) {
+  if (name == "drop_oldest") {
+    *policy = QueuePolicy::kDropOldest;
+  } else if (name == "drop_newest") {
+    *policy = QueuePolicy::kDropNewest;
+  } else if (name == "block") {
+    *policy = QueuePolicy::kBlock;
+  } else if (name == "latest_only") {
+    *policy = QueuePolicy::kLatestOnly;
+  } else {
+    return -1;
+  }
+  return 0;
+}
+
+inline const char *QueuePolicyName(QueuePolicy policy) {
+  switch (policy) {
+    case QueuePolicy::kDropOldest:
+      return "drop_oldest";
+    case QueuePolicy::kDropNewest:
+      return "drop_newest";
+    case QueuePolicy::kBlock:
+      return "block";
+    case QueuePolicy::kLatestOnly:
+      return "latest_only";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * @brief 基于 MpmcQueue 的分发队列，Push 按策略处理满队列
+ * @note 入队与出队不加锁、不分配内存；只有消费者空闲等待，或 kBlock
+ * 策略下生产者等待空位时才加锁。容量向上取整为 2 的幂，kLatestOnly
+ * 时队列中最多保留一个元素。Push 只应在一个线程调用，Pop 可在多个线程调用。
+ */
+template <typename T>
+class DispatchQueue {
+ public:
+  DispatchQueue(size_t capacity, QueuePolicy policy)
+      : queue_(policy == QueuePolicy::kLatestOnly ? 1 : capacity),
+        policy_(policy) {}
+
+  DispatchQueue(const DispatchQueue &) = delete;
+  DispatchQueue &operator=(const DispatchQueue &) = delete;
+
+  /**
+   * @brief  入队
+   * @param  item: 入队元素
+   * @retval true 未发生丢弃，false 丢弃了一个元素或队列已关闭
+   */
+  bool Push(T item) {
+    if (closed_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    bool no_drop = true;
+    T dropped;
+    switch (policy_) {
+      case QueuePolicy::kLatestOnly:
+        while (queue_.TryPop(&dropped)) {
+          no_drop = false;
+        }
+        while (!queue_.TryPush(item)) {
+          if (queue_.TryPop(&dropped)) {
+            no_drop = false;
+          }
+        }
+        break;
+      case QueuePolicy::kDropNewest:
+        if (!queue_.TryPush(item)) {
+          return false;
+        }
+        break;
+      case QueuePolicy::kBlock:
+        if (!queue_.TryPush(item) && !WaitPush(&item)) {
+          return false;
+        }
+        break;
+      default:
+        while (!queue_.TryPush(item)) {
+          if (queue_.TryPop(&dropped)) {
+            no_drop = false;
+          }
+        }
+        break;
+    }
+    // 与 Pop 中的 sleepers_ 自增配对，保证不丢失唤醒
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) > 0) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pop_cond_.notify_one();
+    }
+    return no_drop;
+  }
+
+  /**
+   * @brief  阻塞出队
+   * @param  *item: 出队元素
+   * @retval true 成功，false 队列已关闭且为空
+   */
+  bool Pop(T *item) { return PopUntil(item, nullptr); }
+
+  /**
+   * @brief  出队，最多等待 timeout_ms 毫秒
+   * @retval true 成功，false 超时或队列已关闭且为空
+   */
+  bool PopFor(T *item, int timeout_ms) {
+    auto deadline =
+        Clock::now() + std::chrono::milliseconds(std::max(timeout_ms, 0));
+    return PopUntil(item, &deadline);
+  }
+
+  /// 关闭队列，唤醒等待的生产者与消费者；已入队的元素仍可取出
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_.store(true, std::memory_order_release);
+    pop_cond_.notify_all();
+    push_cond_.notify_all();
+  }
+
+  /// 近似的元素个数
+  size_t Size() const { return queue_.SizeApprox(); }
+
+  size_t Capacity() const {
+    return policy_ == QueuePolicy::kLatestOnly ? 1 : queue_.Capacity();
+  }
+
+  QueuePolicy Policy() const { return policy_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  bool PopUntil(T *item, const Clock::time_point *deadline) {
+    while (true) {
+      if (queue_.TryPop(item)) {
+        NotifyProducer();
+        return true;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      if (queue_.TryPop(item)) {
+        sleepers_.fetch_sub(1);
+        lock.unlock();
+        NotifyProducer();
+        return true;
+      }
+      if (closed_.load(std::memory_order_acquire)) {
+        sleepers_.fetch_sub(1);
+        return false;
+      }
+      if (deadline == nullptr) {
+        pop_cond_.wait(lock);
+      } else if (pop_cond_.wait_until(lock, *deadline) ==
+                 std::cv_status::timeout) {
+        sleepers_.fetch_sub(1);
+        lock.unlock();
+        if (queue_.TryPop(item)) {
+          NotifyProducer();
+          return true;
+        }
+        return false;
+      }
+      sleepers_.fetch_sub(1);
+    }
+  }
+
+  bool WaitPush(T *item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    producer_waiting_.store(true, std::memory_order_seq_cst);
+    bool pushed = false;
+    while (!(pushed = queue_.TryPush(*item)) &&
+           !closed_.load(std::memory_order_acquire)) {
+      push_cond_.wait(lock);
+    }
+    producer_waiting_.store(false, std::memory_order_relaxed);
+    return pushed;
+  }
+
+  void NotifyProducer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_waiting_.load(std::memory_order_relaxed)) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      push_cond_.notify_one();
+    }
+  }
+
+  MpmcQueue<T> queue_;
+  QueuePolicy policy_;
+  std::mutex mutex_;
+  std::condition_variable pop_cond_;
+  std::condition_variable push_cond_;
+  std::atomic<int> sleepers_{0};
+  std::atomic<bool> producer_waiting_{false};
+  std::atomic<bool> closed_{false};
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_DISPATCH_QUEUE_HPP_
@@ -0,0 +1,112 @@
+/**
+ * @file frame_pool_group.hpp
+ * @brief 按通道划分的图像帧缓存池
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_FRAME_POOL_GROUP_HPP_
+#define PG_UTILS_FRAME_POOL_GROUP_HPP_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "pg/utils/json_helper.hpp"
+#include "vision_type/image_frame_pool.hpp"
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 每个通道一个 ImageFramePool，容量由配置决定
+ */
+class FramePoolGroup {
+ public:
+  explicit FramePoolGroup(size_t default_capacity = 4)
+      : default_capacity_(default_capacity) {}
+
+  /**
+   * @brief  从 Init 使用的 json 中读取缓存池配置，缺省时保持默认值
+   * @param  conf_json: json 字符串
+   * {
+   *    "ImageFramePool": {
+   *        "capacity": 4,
+   *        "channel_id": [0, 1, 2],
+   *        "channel_capacity": [6, 6, 3]
+   *    }
+   * }
+   * @retval 0 成功，否则为错误码
+   */
+  int Init(const std::string &conf_json) {
+    cv::FileStorage fs;
+    if (json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    cv::FileNode node = fs["ImageFramePool"];
+    if (node.empty()) {
+      return 0;
+    }
+    int capacity = json::GetInt(node["capacity"],
+                                static_cast<int>(default_capacity_));
+    auto channel_ids = json::GetIntArray(node["channel_id"]);
+    auto channel_capacity = json::GetIntArray(node["channel_capacity"]);
+    if (capacity < 0 || channel_ids.size() != channel_capacity.size()) {
+      return -1;
+    }
+    // 全部校验通过后再修改，失败时保持原配置
+    for (size_t i = 0; i < channel_ids.size(); ++i) {
+      if (channel_ids[i] < 0 || channel_capacity[i] < 0) {
+        return -1;
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    default_capacity_ = static_cast<size_t>(capacity);
+    for (size_t i = 0; i < channel_ids.size(); ++i) {
+      capacity_[static_cast<uint32_t>(channel_ids[i])] =
+          static_cast<size_t>(channel_capacity[i]);
+    }
+    pools_.clear();
+    return 0;
+  }
+
+  /// 获取通道对应的缓存池，首次访问时创建
+  phigent::vision::ImageFramePoolPtr Get(uint32_t channel_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pools_.find(channel_id);
+    if (it != pools_.end()) {
+      return it->second;
+    }
+    auto cap = capacity_.find(channel_id);
+    auto pool = std::make_shared<phigent::vision::ImageFramePool>(
+        cap != capacity_.end() ? cap->second : default_capacity_);
+    pools_[channel_id] = pool;
+    return pool;
+  }
+
+  /// 各通道的缓存池统计信息
+  std::map<uint32_t, phigent::vision::ImageFramePoolStats> Stats() const {
+    std::map<uint32_t, phigent::vision::ImageFramePoolStats> stats;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &it : pools_) {
+      stats[it.first] = it.second->Stats();
+    }
+    return stats;
+  }
+
+ private:
+  size_t default_capacity_;
+  std::map<uint32_t, size_t> capacity_;
+  std::map<uint32_t, phigent::vision::ImageFramePoolPtr> pools_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_FRAME_POOL_GROUP_HPP_
@@ -0,0 +1,95 @@
+/**
+ * @file json_helper.hpp
+ * @brief 基于 cv::FileStorage 的 json 配置读取
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_JSON_HELPER_HPP_
+#define PG_UTILS_JSON_HELPER_HPP_
+
+#include <string>
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+
+namespace pg {
+namespace utils {
+namespace json {
+
+/**
+ * @brief  从字符串打开 json 配置
+ * @param  conf_json: json 字符串，允许带结尾的'\0'
+ * @param  *fs: [out]
+ * @retval 0 成功，否则为错误码
+ */
+inline int Open(const std::string &conf_json, cv::FileStorage *fs) {
+  try {
+    fs->open(cv::String(conf_json.c_str()),
+             cv::FileStorage::READ | cv::FileStorage::MEMORY |
+                 cv::FileStorage::FORMAT_JSON);
+  } catch (const cv::Exception &) {
+    return -1;
+  }
+  return fs->isOpened() ? 0 : -1;
+}
+
+inline int GetInt(const cv::FileNode &node, int default_value) {
+  if (node.isInt()) {
+    return static_cast<int>(node);
+  }
+  if (node.isReal()) {
+    return static_cast<int>(static_cast<double>(node));
+  }
+  return default_value;
+}
+
+inline double GetDouble(const cv::FileNode &node, double default_value) {
+  if (node.isInt() || node.isReal()) {
+    return static_cast<double>(node);
+  }
+  return default_value;
+}
+
+inline std::string GetString(const cv::FileNode &node,
+                             const std::string &default_value) {
+  if (node.isString()) {
+    return static_cast<std::string>(node);
+  }
+  return default_value;
+}
+
+inline bool GetBool(const cv::FileNode &node, bool default_value) {
+  if (node.isInt()) {
+    return static_cast<int>(node) != 0;
+  }
+  if (node.isString()) {
+    std::string value = static_cast<std::string>(node);
+    return value == "true" || value == "1";
+  }
+  return default_value;
+}
+
+/// 读取整数数组，单个整数视为长度为1的数组
+inline std::vector<int> GetIntArray(const cv::FileNode &node) {
+  std::vector<int> values;
+  if (node.isSeq()) {
+    for (auto it = node.begin(); it != node.end(); ++it) {
+      values.push_back(GetInt(*it, 0));
+    }
+  } else if (node.isInt()) {
+    values.push_back(static_cast<int>(node));
+  }
+  return values;
+}
+
+}  // namespace json
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_JSON_HELPER_HPP_
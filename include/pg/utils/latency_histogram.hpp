@@ -0,0 +1,185 @@
+/**
+ * @file latency_histogram.hpp
+ * @brief 无锁的滑动窗口延迟直方图
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_LATENCY_HISTOGRAM_HPP_
+#define PG_UTILS_LATENCY_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 延迟分位数
+ */
+struct LatencyPercentiles {
+  /// 窗口内的样本数
+  uint64_t count = 0;
+  /// 单位均为微秒，分位数为所在桶的上界，相对误差不超过 1/16
+  uint64_t p50_us = 0;
+  uint64_t p95_us = 0;
+  uint64_t p99_us = 0;
+  uint64_t max_us = 0;
+};
+
+/**
+ * @brief 对数-线性分桶的延迟直方图，按时间分片实现滑动窗口
+ * @note Record 只有原子加，不加锁、不分配内存，可在多个线程并发调用。
+ * 分片过期时由第一个写入者清零，清零期间并发写入的少量样本可能丢失，
+ * 统计结果为近似值。
+ */
+class LatencyHistogram {
+ public:
+  /// 每个 2 的幂区间再等分 16 份
+  static constexpr int kSubBits = 4;
+  static constexpr int kSubCount = 1 << kSubBits;
+  /// 不小于 2^27 微秒（约 134 秒）的值计入最后一个桶
+  static constexpr int kMaxBits = 26;
+  static constexpr int kBuckets = (kMaxBits - kSubBits + 2) * kSubCount;
+
+  /**
+   * @param  slots: 窗口分片数
+   * @param  slot_ns: 每个分片的时长，窗口长度为 slots * slot_ns
+   */
+  explicit LatencyHistogram(int slots = 5, uint64_t slot_ns = 2000000000ull)
+      : slot_count_(std::max(slots, 1)),
+        slot_ns_(std::max<uint64_t>(slot_ns, 1)),
+        slots_(new Slot[slot_count_]) {}
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  /**
+   * @brief  记录一个样本
+   * @param  value_us: 延迟，微秒
+   * @param  now_ns: 当前单调时钟，ns
+   */
+  void Record(uint64_t value_us, uint64_t now_ns) {
+    uint64_t epoch = now_ns / slot_ns_ + 1;
+    Slot &slot = slots_[epoch % slot_count_];
+    uint64_t seen = slot.epoch.load(std::memory_order_acquire);
+    if (seen < epoch &&
+        slot.epoch.compare_exchange_strong(seen, epoch,
+                                           std::memory_order_acq_rel)) {
+      for (auto &count : slot.counts) {
+        count.store(0, std::memory_order_relaxed);
+      }
+      slot.max.store(0, std::memory_order_relaxed);
+    }
+    slot.counts[BucketIndex(value_us)].fetch_add(1,
+                                                 std::memory_order_relaxed);
+    uint64_t max = slot.max.load(std::memory_order_relaxed);
+    while (value_us > max &&
+           !slot.max.compare_exchange_weak(max, value_us,
+                                           std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief  统计窗口内的分位数
+   * @param  now_ns: 当前单调时钟，ns
+   */
+  LatencyPercentiles Percentiles(uint64_t now_ns) const {
+    uint64_t epoch = now_ns / slot_ns_ + 1;
+    uint64_t counts[kBuckets] = {0};
+    LatencyPercentiles out;
+    for (int i = 0; i < slot_count_; ++i) {
+      const Slot &slot = slots_[i];
+      uint64_t slot_epoch = slot.epoch.load(std::memory_order_acquire);
+      if (slot_epoch == 0 || slot_epoch > epoch ||
+          epoch - slot_epoch >= static_cast<uint64_t>(slot_count_)) {
+        continue;
+      }
+      for (int b = 0; b < kBuckets; ++b) {
+        uint64_t n = slot.counts[b].load(std::memory_order_relaxed);
+        counts[b] += n;
+        out.count += n;
+      }
+      out.max_us =
+          std::max(out.max_us, slot.max.load(std::memory_order_relaxed));
+    }
+    if (out.count == 0) {
+      return out;
+    }
+    uint64_t rank50 = (out.count * 50 + 99) / 100;
+    uint64_t rank95 = (out.count * 95 + 99) / 100;
+    uint64_t rank99 = (out.count * 99 + 99) / 100;
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; ++b) {
+      if (counts[b] == 0) {
+        continue;
+      }
+      seen += counts[b];
+      uint64_t upper = b == kBuckets - 1
+                           ? out.max_us
+                           : std::min(BucketUpper(b), out.max_us);
+      if (out.p50_us == 0 && seen >= rank50) {
+        out.p50_us = upper;
+      }
+      if (out.p95_us == 0 && seen >= rank95) {
+        out.p95_us = upper;
+      }
+      if (seen >= rank99) {
+        out.p99_us = upper;
+        break;
+      }
+    }
+    return out;
+  }
+
+  /// 桶下标，[0, kSubCount) 为精确值
+  static int BucketIndex(uint64_t value) {
+    if (value < static_cast<uint64_t>(kSubCount)) {
+      return static_cast<int>(value);
+    }
+    int msb = 63 - __builtin_clzll(value);
+    if (msb > kMaxBits) {
+      return kBuckets - 1;
+    }
+    int sub = static_cast<int>((value >> (msb - kSubBits)) & (kSubCount - 1));
+    return (msb - kSubBits + 1) * kSubCount + sub;
+  }
+
+  /// 桶内的最大值
+  static uint64_t BucketUpper(int index) {
+    if (index < kSubCount) {
+      return static_cast<uint64_t>(index);
+    }
+    int msb = index / kSubCount + kSubBits - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubCount);
+    uint64_t width = 1ull << (msb - kSubBits);
+    return (1ull << msb) + (sub + 1) * width - 1;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<uint64_t> max{0};
+    std::atomic<uint64_t> counts[kBuckets];
+    Slot() {
+      for (auto &count : counts) {
+        count.store(0, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  int slot_count_;
+  uint64_t slot_ns_;
+  std::unique_ptr<Slot[]> slots_;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_LATENCY_HISTOGRAM_HPP_
@@ -0,0 +1,133 @@
+/**
+ * @file mpmc_queue.hpp
+ * @brief 无锁的多生产者/多消费者定长队列
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_MPMC_QUEUE_HPP_
+#define PG_UTILS_MPMC_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 基于序号的环形队列（Dmitry Vyukov 的 bounded MPMC queue）
+ * @note TryPush/TryPop 不加锁、不分配内存，失败时立即返回；容量向上取整为
+ * 2 的幂。元素在出队前一直保存在槽位中。
+ */
+template <typename T>
+class MpmcQueue {
+ public:
+  explicit MpmcQueue(size_t capacity) {
+    size_t size = 2;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_.reset(new Cell[size]);
+    for (size_t i = 0; i < size; ++i) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue &) = delete;
+  MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+  /**
+   * @brief  入队
+   * @param  &item: 成功时被移走，失败时保持不变
+   * @retval true 成功，false 队列满
+   */
+  bool TryPush(T &item) {
+    Cell *cell = nullptr;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->data = std::move(item);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief  出队
+   * @retval true 成功，false 队列空
+   */
+  bool TryPop(T *item) {
+    Cell *cell = nullptr;
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t seq = cell->sequence.load(std::memory_order_acquire);
+      intptr_t diff =
+          static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *item = std::move(cell->data);
+    // 及时释放元素持有的资源（如共享指针）
+    cell->data = T();
+    cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t Capacity() const { return mask_ + 1; }
+
+  /// 近似的元素个数，并发修改时仅供统计
+  size_t SizeApprox() const {
+    size_t enqueue = enqueue_pos_.load(std::memory_order_relaxed);
+    size_t dequeue = dequeue_pos_.load(std::memory_order_relaxed);
+    return enqueue > dequeue ? enqueue - dequeue : 0;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T data;
+  };
+  static constexpr size_t kCacheLine = 64;
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_ = 0;
+  // 用填充而不是 alignas 隔开读写位置，C++14 的 new 不保证扩展对齐
+  char pad0_[kCacheLine];
+  std::atomic<size_t> enqueue_pos_{0};
+  char pad1_[kCacheLine - sizeof(std::atomic<size_t>)];
+  std::atomic<size_t> dequeue_pos_{0};
+  char pad2_[kCacheLine - sizeof(std::atomic<size_t>)];
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_MPMC_QUEUE_HPP_
@@ -22,6 +22,11 @@ namespace helper {
 int ImageFrame2CvMatBGR(phigent::vision::ImageFrame &img, cv::Mat &mat,
                         bool deep_copy);
 
+/**
+ * @brief  ImageFrame 转 cv::Mat
+ * @note   deep_copy 为 false 时返回的 cv::Mat 不持有 img 的引用，
+ * 需要保证 img 的生命周期；需要安全的零拷贝时使用 ImageFrame2CvMatRef
+ */
 int ImageFrame2CvMat(phigent::vision::ImageFrame &img, cv::Mat &mat,
                      bool deep_copy, bool is_dev_addr);
 
@@ -30,6 +35,186 @@ phigent::vision::ImageFramePtr CvMat2ImageFrame(cv::Mat &mat,
                                                 bool deep_copy,
                                                 bool is_dev_addr);
 
+namespace detail {
+
+/// cv::Mat 通过 UMatData::userdata 持有图像帧
+struct FrameMatHolder {
+  phigent::vision::ImageFramePtr frame;
+  phigent::vision::DataBufferPtr buffer;
+};
+
+class FrameMatAllocator : public cv::MatAllocator {
+ public:
+  static FrameMatAllocator *Instance() {
+    static FrameMatAllocator allocator;
+    return &allocator;
+  }
+
+  cv::UMatData *allocate(int dims, const int *sizes, int type, void *data,
+                         size_t *step, cv::AccessFlag flags,
+                         cv::UMatUsageFlags usage_flags) const override {
+    return cv::Mat::getDefaultAllocator()->allocate(dims, sizes, type, data,
+                                                    step, flags, usage_flags);
+  }
+  bool allocate(cv::UMatData *data, cv::AccessFlag flags,
+                cv::UMatUsageFlags usage_flags) const override {
+    return cv::Mat::getDefaultAllocator()->allocate(data, flags, usage_flags);
+  }
+  void deallocate(cv::UMatData *data) const override {
+    if (data == nullptr) {
+      return;
+    }
+    delete static_cast<FrameMatHolder *>(data->userdata);
+    data->userdata = nullptr;
+    delete data;
+  }
+};
+
+inline int WrapFramePlane(const phigent::vision::ImageFramePtr &img,
+                          uint8_t *data, int rows, int cols, int type,
+                          size_t step, cv::Mat &mat) {
+  if (data == nullptr || rows <= 0 || cols <= 0) {
+    return -1;
+  }
+  cv::Mat header(rows, cols, type, data, step);
+  cv::UMatData *u = new cv::UMatData(FrameMatAllocator::Instance());
+  u->data = u->origdata = data;
+  u->size = step * rows;
+  u->flags = cv::UMatData::USER_ALLOCATED;
+  u->refcount = 1;
+  u->userdata = new FrameMatHolder{img, img->GetDataBuffer()};
+  header.u = u;
+  mat = header;
+  return 0;
+}
+
+/// 单平面格式对应的 cv::Mat 类型，多平面格式返回 -1
+inline int SinglePlaneCvType(PGPixelFormat format) {
+  switch (format) {
+    case kPGPixelFormatRawGRAY:
+    case kPGPixelFormatUint8:
+      return CV_8UC1;
+    case kPGPixelFormatInt8:
+      return CV_8SC1;
+    case kPGPixelFormatRawBGR:
+    case kPGPixelFormatRawRGB:
+    case kPGPixelFormatYUV444:
+      return CV_8UC3;
+    case kPGPixelFormatRawRGBA:
+    case kPGPixelFormatRawBGRA:
+    case kPGPixelFormatRawARGB:
+    case kPGPixelFormatRawABGR:
+      return CV_8UC4;
+    case kPGPixelFormatYUYV:
+    case kPGPixelFormatUYVY:
+    case kPGPixelFormatRawRGB565:
+      return CV_8UC2;
+    case kPGPixelFormatInt16:
+      return CV_16SC1;
+    case kPGPixelFormatInt32:
+      return CV_32SC1;
+    case kPGPixelFormatFloat32:
+      return CV_32FC1;
+    default:
+      return -1;
+  }
+}
+
+inline bool IsYuv420(PGPixelFormat format) {
+  return format == kPGPixelFormatRawNV12 || format == kPGPixelFormatRawNV21 ||
+         format == kPGPixelFormatRawI420 || format == kPGPixelFormatRawYV12;
+}
+
+}  // namespace detail
+
+/**
+ * @brief  零拷贝地将 ImageFrame 包装为 cv::Mat，按 Stride() 设置行步长
+ * @note   返回的 cv::Mat（及其拷贝、ROI）持有 img 和其 DataBuffer 的引用，
+ * 最后一个 cv::Mat 释放前图像内存不会被释放或被缓存池复用。
+ * 支持 GRAY/Uint8/Int8、BGR/RGB/YUV444、RGBA 系列、YUYV/UYVY、Int16（视差）、
+ * Int32、Float32，以及 UV 平面紧跟 Y 平面存放的 NV12/NV21/I420/YV12
+ * （输出为 height*3/2 行的单通道 cv::Mat，可直接用于 cv::cvtColor）。
+ * YUV420 平面不连续时返回 -2，可改用 ImageFrame2CvMatPlanes。
+ * @param  img: 图像帧
+ * @param  mat: [out] 与 img 共享内存的 cv::Mat
+ * @retval 0 成功，-1 不支持的格式或空数据，-2 YUV 平面不连续
+ */
+inline int ImageFrame2CvMatRef(const phigent::vision::ImageFramePtr &img,
+                               cv::Mat &mat) {
+  if (!img || img->Data() == nullptr) {
+    return -1;
+  }
+  PGPixelFormat format = img->pixel_format;
+  int rows = static_cast<int>(img->Height());
+  int cols = static_cast<int>(img->Width());
+  int type = detail::SinglePlaneCvType(format);
+  if (type >= 0) {
+    size_t step = phigent::vision::FrameRowStep(img->Stride(), img->Width(),
+                                                CV_ELEM_SIZE(type));
+    return detail::WrapFramePlane(img, img->Data(), rows, cols, type, step,
+                                  mat);
+  }
+  if (!detail::IsYuv420(format)) {
+    return -1;
+  }
+  size_t step = phigent::vision::FrameRowStep(img->Stride(), img->Width(), 1);
+  uint8_t *uv = img->DataUV();
+  if (uv != nullptr) {
+    bool semi_planar =
+        format == kPGPixelFormatRawNV12 || format == kPGPixelFormatRawNV21;
+    size_t expect_uv_step = semi_planar ? step : step / 2;
+    size_t uv_step = img->StrideUV() == 0 ? expect_uv_step : img->StrideUV();
+    if (uv != img->Data() + step * rows || uv_step != expect_uv_step) {
+      return -2;
+    }
+  }
+  return detail::WrapFramePlane(img, img->Data(), rows + rows / 2, cols,
+                                CV_8UC1, step, mat);
+}
+
+/**
+ * @brief  零拷贝地将 YUV420 图像帧按平面包装为 cv::Mat，平面可以不连续
+ * @note   NV12/NV21 输出 {Y, UV(CV_8UC2)}，I420/YV12 输出 {Y, 第一色度平面,
+ * 第二色度平面}（I420 为 U、V，YV12 为 V、U），第二色度平面紧跟第一色度平面。
+ * 每个 cv::Mat 都持有 img 的引用
+ * @param  img: 图像帧
+ * @param  planes: [out] 各平面
+ * @retval 0 成功，否则为错误码
+ */
+inline int ImageFrame2CvMatPlanes(const phigent::vision::ImageFramePtr &img,
+                                  std::vector<cv::Mat> &planes) {
+  if (!img || img->Data() == nullptr || img->DataUV() == nullptr ||
+      !detail::IsYuv420(img->pixel_format)) {
+    return -1;
+  }
+  int rows = static_cast<int>(img->Height());
+  int cols = static_cast<int>(img->Width());
+  int uv_rows = (rows + 1) / 2;
+  int uv_cols = (cols + 1) / 2;
+  size_t step = phigent::vision::FrameRowStep(img->Stride(), img->Width(), 1);
+  planes.resize(1);
+  if (detail::WrapFramePlane(img, img->Data(), rows, cols, CV_8UC1, step,
+                             planes[0]) != 0) {
+    return -1;
+  }
+  if (img->pixel_format == kPGPixelFormatRawNV12 ||
+      img->pixel_format == kPGPixelFormatRawNV21) {
+    size_t uv_step = phigent::vision::FrameRowStep(img->StrideUV(), uv_cols, 2);
+    planes.resize(2);
+    return detail::WrapFramePlane(img, img->DataUV(), uv_rows, uv_cols,
+                                  CV_8UC2, uv_step, planes[1]);
+  }
+  size_t uv_step = phigent::vision::FrameRowStep(img->StrideUV(), uv_cols, 1);
+  planes.resize(3);
+  if (detail::WrapFramePlane(img, img->DataUV(), uv_rows, uv_cols, CV_8UC1,
+                             uv_step, planes[1]) != 0) {
+    return -1;
+  }
+  return detail::WrapFramePlane(img, img->DataUV() + uv_step * uv_rows,
+                                uv_rows, uv_cols, CV_8UC1, uv_step,
+                                planes[2]);
+}
+
 #ifdef USE_GPU
 int ImageFrame2CvGpuMat(phigent::vision::ImageFrame &img, cv::cuda::GpuMat &mat,
                         bool deep_copy);
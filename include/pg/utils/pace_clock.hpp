@@ -0,0 +1,88 @@
+/**
+ * @file pace_clock.hpp
+ * @brief 按设备时间戳控制回放节奏
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_PACE_CLOCK_HPP_
+#define PG_UTILS_PACE_CLOCK_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 把设备时间戳（ns）映射到本机单调时钟，按倍速等待数据到期
+ * @note 非线程安全，由持有者加锁
+ */
+class PaceClock {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * @brief  重新开始计时，下一个 WaitUntil 的时间戳立即到期
+   * @param  speed: 回放倍速，<=0 表示不限速
+   */
+  void Reset(double speed) {
+    speed_ = speed;
+    started_ = false;
+  }
+
+  /// 修改倍速，以最近一次到期的时间戳为新的起点，不产生跳变
+  void SetSpeed(double speed) {
+    if (started_) {
+      base_wall_ = Clock::now();
+      base_ts_ = last_ts_;
+    }
+    speed_ = speed;
+  }
+
+  double Speed() const { return speed_; }
+
+  /**
+   * @brief  等待时间戳 ts_ns 到期
+   * @param  ts_ns: 设备时间戳，单位 ns，应单调不减
+   * @param  timeout_ms: 最长等待时间
+   * @retval true 已到期，false 等待超时
+   */
+  bool WaitUntil(uint64_t ts_ns, int timeout_ms) {
+    if (!started_) {
+      started_ = true;
+      base_wall_ = Clock::now();
+      base_ts_ = ts_ns;
+    }
+    if (speed_ > 0 && ts_ns > base_ts_) {
+      auto due = base_wall_ + std::chrono::duration_cast<Clock::duration>(
+                                  std::chrono::duration<double, std::nano>(
+                                      (ts_ns - base_ts_) / speed_));
+      auto deadline = Clock::now() + std::chrono::milliseconds(timeout_ms);
+      if (due > deadline) {
+        std::this_thread::sleep_until(deadline);
+        return false;
+      }
+      std::this_thread::sleep_until(due);
+    }
+    last_ts_ = ts_ns;
+    return true;
+  }
+
+ private:
+  double speed_ = 1.0;
+  bool started_ = false;
+  Clock::time_point base_wall_;
+  uint64_t base_ts_ = 0;
+  uint64_t last_ts_ = 0;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_PACE_CLOCK_HPP_
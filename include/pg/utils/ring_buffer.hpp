@@ -0,0 +1,104 @@
+/**
+ * @file ring_buffer.hpp
+ * @brief 预分配的定长环形缓存
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_RING_BUFFER_HPP_
+#define PG_UTILS_RING_BUFFER_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 定长环形缓存，写满后覆盖最旧的元素
+ * @note 存储在 Reset 时一次性分配，之后的读写都不分配内存；非线程安全
+ */
+template <typename T>
+class RingBuffer {
+ public:
+  RingBuffer() = default;
+  explicit RingBuffer(size_t capacity) : buf_(capacity) {}
+
+  /// 重新分配存储并清空
+  void Reset(size_t capacity) {
+    buf_.assign(capacity, T());
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * @brief  取得下一个写入位置，直接在原地填充，避免拷贝
+   * @retval 写入位置，容量为0时返回 nullptr
+   */
+  T *PushSlot() {
+    if (buf_.empty()) {
+      return nullptr;
+    }
+    if (size_ == buf_.size()) {
+      head_ = (head_ + 1) % buf_.size();
+      --size_;
+      ++overwritten_;
+    }
+    T *slot = &buf_[(head_ + size_) % buf_.size()];
+    ++size_;
+    return slot;
+  }
+
+  bool Push(const T &item) {
+    T *slot = PushSlot();
+    if (slot == nullptr) {
+      return false;
+    }
+    *slot = item;
+    return true;
+  }
+
+  /// 取出最旧的元素
+  bool PopFront(T *item) {
+    if (size_ == 0) {
+      return false;
+    }
+    *item = std::move(buf_[head_]);
+    head_ = (head_ + 1) % buf_.size();
+    --size_;
+    return true;
+  }
+
+  /// 按时间顺序访问，0 为最旧的元素
+  T &At(size_t i) { return buf_[(head_ + i) % buf_.size()]; }
+  const T &At(size_t i) const { return buf_[(head_ + i) % buf_.size()]; }
+
+  /// 清空但保留存储
+  void Clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  size_t Size() const { return size_; }
+  size_t Capacity() const { return buf_.size(); }
+  bool Empty() const { return size_ == 0; }
+  /// 因写满被覆盖的元素数量
+  uint64_t Overwritten() const { return overwritten_; }
+
+ private:
+  std::vector<T> buf_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  uint64_t overwritten_ = 0;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_RING_BUFFER_HPP_
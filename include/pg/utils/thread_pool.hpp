@@ -0,0 +1,177 @@
+/**
+ * @file thread_pool.hpp
+ * @brief 固定线程数的行分块并行执行
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_THREAD_POOL_HPP_
+#define PG_UTILS_THREAD_POOL_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief 常驻工作线程，用于把一帧图像按行分块并行处理
+ * @note ParallelFor 阻塞到所有分块完成，调用线程也参与计算；同一时刻只执行
+ * 一个 ParallelFor，多个线程同时调用时依次执行
+ */
+class ThreadPool {
+ public:
+  /**
+   * @param num_threads: 总并行度（含调用线程），0 表示
+   * std::thread::hardware_concurrency()
+   */
+  explicit ThreadPool(int num_threads = 0) {
+    num_threads = ResolveNumThreads(num_threads);
+    for (int i = 1; i < num_threads; ++i) {
+      workers_.emplace_back([this] { Run(); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /// 把配置中的并行度（0 表示自动）换算为实际线程数
+  static int ResolveNumThreads(int num_threads) {
+    if (num_threads <= 0) {
+      num_threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return std::max(num_threads, 1);
+  }
+
+  /// 总并行度（含调用线程）
+  int NumThreads() const { return static_cast<int>(workers_.size()) + 1; }
+
+  /**
+   * @brief  把 [begin, end) 按 grain 分块并行执行 fn(block_begin, block_end)
+   * @param  begin: 起始行
+   * @param  end: 结束行（不含）
+   * @param  grain: 每块最少行数
+   * @param  fn: 分块处理函数，需可重入
+   */
+  void ParallelFor(int begin, int end, int grain,
+                   const std::function<void(int, int)> &fn) {
+    if (end <= begin) {
+      return;
+    }
+    grain = std::max(grain, 1);
+    int total = end - begin;
+    // 每个线程约 4 块，兼顾负载均衡与调度开销
+    int blocks = std::min((total + grain - 1) / grain, NumThreads() * 4);
+    if (blocks <= 1 || workers_.empty()) {
+      fn(begin, end);
+      return;
+    }
+    std::lock_guard<std::mutex> call_lock(call_mutex_);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_ = &fn;
+      job_begin_ = begin;
+      job_total_ = total;
+      job_blocks_ = blocks;
+      next_block_.store(0, std::memory_order_relaxed);
+      pending_ = blocks;
+      ++generation_;
+    }
+    cond_.notify_all();
+    RunBlocks();
+    std::unique_lock<std::mutex> lock(mutex_);
+    // 等待所有分块完成且没有工作线程仍在访问本次任务
+    done_cond_.wait(lock, [this] { return pending_ == 0 && running_ == 0; });
+    job_ = nullptr;
+  }
+
+ private:
+  void Run() {
+    uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+        // 被唤醒时任务可能已经结束
+        if (job_ == nullptr) {
+          continue;
+        }
+        ++running_;
+      }
+      RunBlocks();
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--running_ == 0) {
+        done_cond_.notify_all();
+      }
+    }
+  }
+
+  void RunBlocks() {
+    int finished = 0;
+    while (true) {
+      int block = next_block_.fetch_add(1, std::memory_order_relaxed);
+      if (block >= job_blocks_) {
+        break;
+      }
+      int64_t b = job_begin_ + static_cast<int64_t>(job_total_) * block /
+                                   job_blocks_;
+      int64_t e = job_begin_ + static_cast<int64_t>(job_total_) *
+                                   (block + 1) / job_blocks_;
+      (*job_)(static_cast<int>(b), static_cast<int>(e));
+      ++finished;
+    }
+    if (finished == 0) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_ -= finished;
+    if (pending_ == 0) {
+      done_cond_.notify_all();
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex call_mutex_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+  std::condition_variable done_cond_;
+  const std::function<void(int, int)> *job_ = nullptr;
+  int job_begin_ = 0;
+  int job_total_ = 0;
+  int job_blocks_ = 0;
+  std::atomic<int> next_block_{0};
+  int pending_ = 0;
+  int running_ = 0;
+  uint64_t generation_ = 0;
+  bool stop_ = false;
+};
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_THREAD_POOL_HPP_
@@ -0,0 +1,264 @@
+/**
+ * @file thread_util.hpp
+ * @brief 线程 CPU 绑定、调度策略与命名
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_UTILS_THREAD_UTIL_HPP_
+#define PG_UTILS_THREAD_UTIL_HPP_
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pg {
+namespace utils {
+
+/**
+ * @brief  把当前线程绑定到指定的 CPU
+ * @param  cpus: CPU 编号，为空时不修改
+ * @retval 0 成功，-1 编号无效，-2 系统调用失败
+ */
+inline int SetCurrentThreadAffinity(const std::vector<int> &cpus) {
+  if (cpus.empty()) {
+    return 0;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE) {
+      return -1;
+    }
+    CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0 ? 0
+                                                                        : -2;
+}
+
+/**
+ * @brief  设置当前线程名，超过 15 个字符时截断
+ * @retval 0 成功，否则为错误码
+ */
+inline int SetCurrentThreadName(const std::string &name) {
+  char buf[16];
+  strncpy(buf, name.c_str(), sizeof(buf) - 1);
+  buf[sizeof(buf) - 1] = '\0';
+  return pthread_setname_np(pthread_self(), buf) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief  设置本进程内任意线程的名称，超过 15 个字符时截断
+ * @note   用于命名不是由本库创建的线程，如 SDK 内部线程
+ * @retval 0 成功，否则为错误码
+ */
+inline int SetThreadName(int tid, const std::string &name) {
+  std::ofstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+  if (!comm) {
+    return -1;
+  }
+  comm << name.substr(0, 15);
+  comm.flush();
+  return comm ? 0 : -1;
+}
+
+/**
+ * @brief 线程的 CPU 绑定与调度配置
+ */
+struct ThreadConfig {
+  /// 绑定的 CPU，为空时不修改
+  std::vector<int> cpus;
+  /// 调度策略：other/fifo/rr，为空时不修改
+  std::string sched;
+  /// fifo/rr 的实时优先级，1~99
+  int priority = 0;
+  /// 是否设置 nice
+  bool set_nice = false;
+  /// other 策略下的 nice 值，-20~19
+  int nice = 0;
+
+  /// 是否需要修改线程属性
+  bool Empty() const { return cpus.empty() && sched.empty() && !set_nice; }
+};
+
+/**
+ * @brief 线程的当前状态
+ */
+struct ThreadInfo {
+  /// 内核线程号
+  int tid = 0;
+  std::string name;
+  /// 线程用途，由调用方填写
+  std::string role;
+  /// 允许运行的 CPU
+  std::vector<int> cpus;
+  /// 调度策略：other/fifo/rr/batch/idle
+  std::string sched;
+  int priority = 0;
+  int nice = 0;
+};
+
+/// 当前线程的内核线程号
+inline int CurrentThreadId() { return static_cast<int>(syscall(SYS_gettid)); }
+
+/**
+ * @brief  解析调度策略名
+ * @retval 0 成功，-1 名称无效
+ */
+inline int ParseSchedPolicy(const std::string &name, int *policy) {
+  if (name == "other") {
+    *policy = SCHED_OTHER;
+  } else if (name == "fifo") {
+    *policy = SCHED_FIFO;
+  } else if (name == "rr") {
+    *policy = SCHED_RR;
+  } else {
+    return -1;
+  }
+  return 0;
+}
+
+inline const char *SchedPolicyName(int policy) {
+  switch (policy) {
+    case SCHED_OTHER:
+      return "other";
+    case SCHED_FIFO:
+      return "fifo";
+    case SCHED_RR:
+      return "rr";
+    case SCHED_BATCH:
+      return "batch";
+    case SCHED_IDLE:
+      return "idle";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * @brief  按配置修改本进程内任意线程的 CPU 绑定、调度策略与 nice
+ * @note   fifo/rr 通常需要 CAP_SYS_NICE 或足够的 RLIMIT_RTPRIO，
+ * 失败时已完成的修改不回退
+ * @param  tid: 内核线程号，0 表示当前线程
+ * @retval 0 成功，-1 配置无效，-2 系统调用失败（权限不足等）
+ */
+inline int ApplyThreadConfig(int tid, const ThreadConfig &config) {
+  int policy = SCHED_OTHER;
+  if (!config.sched.empty() &&
+      ParseSchedPolicy(config.sched, &policy) != 0) {
+    return -1;
+  }
+  bool realtime = policy == SCHED_FIFO || policy == SCHED_RR;
+  if (!config.sched.empty() &&
+      (realtime ? config.priority < 1 || config.priority > 99
+                : config.priority != 0)) {
+    return -1;
+  }
+  if (config.set_nice && (config.nice < -20 || config.nice > 19)) {
+    return -1;
+  }
+  if (!config.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : config.cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return -1;
+      }
+      CPU_SET(cpu, &set);
+    }
+    if (sched_setaffinity(tid, sizeof(set), &set) != 0) {
+      return -2;
+    }
+  }
+  if (!config.sched.empty()) {
+    sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = config.priority;
+    if (sched_setscheduler(tid, policy, &param) != 0) {
+      return -2;
+    }
+  }
+  if (config.set_nice &&
+      setpriority(PRIO_PROCESS, static_cast<id_t>(tid), config.nice) != 0) {
+    return -2;
+  }
+  return 0;
+}
+
+/**
+ * @brief  读取本进程内线程的名称、CPU 绑定与调度状态
+ * @param  tid: 内核线程号，0 表示当前线程
+ * @param  *info: [out] role 保持不变
+ * @retval 0 成功，-1 线程不存在
+ */
+inline int GetThreadInfo(int tid, ThreadInfo *info) {
+  if (tid == 0) {
+    tid = CurrentThreadId();
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  int policy = sched_getscheduler(tid);
+  if (policy < 0 || sched_getaffinity(tid, sizeof(set), &set) != 0) {
+    return -1;
+  }
+  info->tid = tid;
+  info->sched = SchedPolicyName(policy);
+  sched_param param;
+  info->priority =
+      sched_getparam(tid, &param) == 0 ? param.sched_priority : 0;
+  errno = 0;
+  int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+  info->nice = errno == 0 ? nice : 0;
+  info->cpus.clear();
+  for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+    if (CPU_ISSET(cpu, &set)) {
+      info->cpus.push_back(cpu);
+    }
+  }
+  info->name.clear();
+  std::ifstream comm("/proc/self/task/" + std::to_string(tid) + "/comm");
+  std::getline(comm, info->name);
+  return 0;
+}
+
+/**
+ * @brief  列出本进程当前的全部线程
+ * @param  *tids: [out] 内核线程号
+ * @retval 0 成功，-1 无法读取 /proc
+ */
+inline int ListThreadIds(std::vector<int> *tids) {
+  DIR *dir = opendir("/proc/self/task");
+  if (dir == nullptr) {
+    return -1;
+  }
+  tids->clear();
+  while (dirent *entry = readdir(dir)) {
+    int tid = atoi(entry->d_name);
+    if (tid > 0) {
+      tids->push_back(tid);
+    }
+  }
+  closedir(dir);
+  std::sort(tids->begin(), tids->end());
+  return 0;
+}
+
+}  // namespace utils
+
+}  // namespace pg
+
+#endif  // PG_UTILS_THREAD_UTIL_HPP_
@@ -0,0 +1,44 @@
+/**
+ * @file vidar_backend.hpp
+ * @brief 按类型名创建 VidarInterface，包括不需要设备的回放与合成数据
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_BACKEND_HPP_
+#define PG_VIDAR_BACKEND_HPP_
+
+#include <string>
+
+#include "pg/vidar_interface.hpp"
+#include "pg/vidar_replay.hpp"
+#include "pg/vidar_synthetic.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief  创建双目视觉雷达数据界面
+ * @note   "replay" 见 ReplayVidar，"synthetic" 见 SyntheticVidar，
+ * 其他类型交给 VidarInterface::Create。返回的对象由调用者 delete
+ * @param  type: 类型名
+ * @retval 失败时返回 nullptr
+ */
+inline VidarInterface *CreateVidarInterface(const string &type = "default") {
+  if (type == "replay") {
+    return new ReplayVidar();
+  }
+  if (type == "synthetic") {
+    return new SyntheticVidar();
+  }
+  return VidarInterface::Create(type);
+}
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_BACKEND_HPP_
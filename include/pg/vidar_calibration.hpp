@@ -0,0 +1,219 @@
+/**
+ * @file vidar_calibration.hpp
+ * @brief 解析 GetConfig 返回的相机标定信息
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_CALIBRATION_HPP_
+#define PG_VIDAR_CALIBRATION_HPP_
+
+#include <cmath>
+#include <string>
+
+#include "opencv2/core/core.hpp"
+#include "pg/utils/json_helper.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 双目标定参数，矩阵命名与 cv::stereoCalibrate/cv::stereoRectify 一致
+ */
+struct StereoCalibration {
+  /// 左/右相机内参与畸变
+  cv::Mat M1, D1, M2, D2;
+  /// 右相机相对左相机的旋转与平移
+  cv::Mat R, T;
+  /// 校正旋转与校正后的投影矩阵
+  cv::Mat R1, R2, P1, P2;
+  /// 视差到深度的重投影矩阵
+  cv::Mat Q;
+  /// 标定时的图像尺寸，未提供时为 0
+  int image_width = 0;
+  int image_height = 0;
+  /// GetConfig 返回的 "shift"，-1 表示未设置
+  int shift = -1;
+  std::string product_number;
+  std::string serial_number;
+  std::string version;
+
+  /// 至少包含计算深度所需的焦距与基线
+  bool Valid() const { return Focal() > 0 && Baseline() > 0; }
+
+  /// 校正后的焦距（像素），优先取 P1，否则取 M1
+  double Focal() const {
+    if (P1.rows == 3 && P1.cols == 4) {
+      return P1.at<double>(0, 0);
+    }
+    if (M1.rows == 3 && M1.cols == 3) {
+      return M1.at<double>(0, 0);
+    }
+    return 0;
+  }
+
+  /// 基线长度，单位与 T 相同，优先取 P2，否则取 T
+  double Baseline() const {
+    if (P2.rows == 3 && P2.cols == 4 && P2.at<double>(0, 0) != 0) {
+      return std::fabs(P2.at<double>(0, 3) / P2.at<double>(0, 0));
+    }
+    if (T.total() >= 3) {
+      return std::fabs(T.at<double>(0));
+    }
+    return 0;
+  }
+
+  /// 左右校正图像主点的水平偏差（像素），即 P2(0,2) - P1(0,2)
+  double PrincipalPointOffset() const {
+    if (P1.rows == 3 && P1.cols == 4 && P2.rows == 3 && P2.cols == 4) {
+      return P2.at<double>(0, 2) - P1.at<double>(0, 2);
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  视差重投影矩阵 [X Y Z W]^T = Q * [u v d 1]^T，优先取 Q，
+   * 否则按 cv::stereoRectify 的定义由 P1/P2 构造
+   * @param  *q: [out] 重投影矩阵
+   * @retval true 成功，false 标定中没有足够信息
+   */
+  bool GetReprojection(cv::Matx44d *q) const {
+    if (Q.rows == 4 && Q.cols == 4) {
+      *q = cv::Matx44d(Q);
+      return true;
+    }
+    if (P1.rows != 3 || P1.cols != 4 || P2.rows != 3 || P2.cols != 4 ||
+        P2.at<double>(0, 0) == 0 || P2.at<double>(0, 3) == 0) {
+      return false;
+    }
+    double cx = P1.at<double>(0, 2);
+    double cy = P1.at<double>(1, 2);
+    double tx = P2.at<double>(0, 3) / P2.at<double>(0, 0);
+    *q = cv::Matx44d(1, 0, 0, -cx,  //
+                     0, 1, 0, -cy,  //
+                     0, 0, 0, P1.at<double>(0, 0),  //
+                     0, 0, -1 / tx, (cx - P2.at<double>(0, 2)) / tx);
+    return true;
+  }
+};
+
+namespace detail {
+
+inline void ReadCalibMat(const cv::FileNode &node, cv::Mat *mat) {
+  if (node.empty()) {
+    return;
+  }
+  cv::Mat value;
+  node >> value;
+  if (!value.empty()) {
+    value.convertTo(*mat, CV_64F);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief  解析 OpenCV FileStorage 格式（"%YAML:1.0"）的标定字符串
+ * @param  calib: 标定字符串，包含 M1/D1/M2/D2/R/T/R1/R2/P1/P2/Q，
+ * 可选 image_width/image_height
+ * @param  *out: [out] 标定参数，未出现的矩阵保持为空
+ * @retval 0 成功，-1 解析失败，-2 缺少计算深度所需的焦距或基线
+ */
+inline int ParseStereoCalibration(const std::string &calib,
+                                  StereoCalibration *out) {
+  cv::FileStorage fs;
+  try {
+    fs.open(cv::String(calib.c_str()),
+            cv::FileStorage::READ | cv::FileStorage::MEMORY);
+  } catch (const cv::Exception &) {
+    return -1;
+  }
+  if (!fs.isOpened()) {
+    return -1;
+  }
+  StereoCalibration result;
+  result.shift = out->shift;
+  result.product_number = out->product_number;
+  result.serial_number = out->serial_number;
+  result.version = out->version;
+  try {
+    detail::ReadCalibMat(fs["M1"], &result.M1);
+    detail::ReadCalibMat(fs["D1"], &result.D1);
+    detail::ReadCalibMat(fs["M2"], &result.M2);
+    detail::ReadCalibMat(fs["D2"], &result.D2);
+    detail::ReadCalibMat(fs["R"], &result.R);
+    detail::ReadCalibMat(fs["T"], &result.T);
+    detail::ReadCalibMat(fs["R1"], &result.R1);
+    detail::ReadCalibMat(fs["R2"], &result.R2);
+    detail::ReadCalibMat(fs["P1"], &result.P1);
+    detail::ReadCalibMat(fs["P2"], &result.P2);
+    detail::ReadCalibMat(fs["Q"], &result.Q);
+  } catch (const cv::Exception &) {
+    return -1;
+  }
+  result.image_width = utils::json::GetInt(fs["image_width"], 0);
+  result.image_height = utils::json::GetInt(fs["image_height"], 0);
+  *out = result;
+  return out->Valid() ? 0 : -2;
+}
+
+/**
+ * @brief  解析 GetConfig 返回的 json，见 VidarInterface::GetConfig
+ * @param  return_conf_json: GetConfig 输出的 json 字符串
+ * @param  *out: [out] 标定参数与相机信息
+ * @retval 0 成功，-1 json 或标定字符串解析失败，-2 标定不完整
+ */
+inline int ParseCameraConfig(const std::string &return_conf_json,
+                             StereoCalibration *out) {
+  cv::FileStorage fs;
+  if (utils::json::Open(return_conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode camera = fs["camera"];
+  if (camera.empty()) {
+    return -1;
+  }
+  StereoCalibration result;
+  result.shift = utils::json::GetInt(camera["shift"], -1);
+  result.product_number =
+      utils::json::GetString(camera["product_number"], "");
+  result.serial_number = utils::json::GetString(camera["serial_number"], "");
+  result.version = utils::json::GetString(camera["version"], "");
+  int ret = ParseStereoCalibration(
+      utils::json::GetString(camera["calib"], ""), &result);
+  if (ret == -1) {
+    return -1;
+  }
+  *out = result;
+  return ret;
+}
+
+/**
+ * @brief  只读取 GetConfig 返回的序列号，不解析标定 YAML
+ * @param  return_conf_json: GetConfig 输出的 json 字符串
+ * @param  *serial: [out] 序列号，可能为空
+ * @retval 0 带有相机信息（"calib" 非空），-1 没有相机信息
+ */
+inline int ParseCameraSerial(const std::string &return_conf_json,
+                             std::string *serial) {
+  cv::FileStorage fs;
+  if (utils::json::Open(return_conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode camera = fs["camera"];
+  if (camera.empty() ||
+      utils::json::GetString(camera["calib"], "").empty()) {
+    return -1;
+  }
+  *serial = utils::json::GetString(camera["serial_number"], "");
+  return 0;
+}
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_CALIBRATION_HPP_
@@ -0,0 +1,337 @@
+/**
+ * @file vidar_calibration_cache.hpp
+ * @brief 按序列号缓存已解析的标定，热启动时跳过 GetConfig 重试与 YAML 解析
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_CALIBRATION_CACHE_HPP_
+#define PG_VIDAR_CALIBRATION_CACHE_HPP_
+
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pg/vidar_calibration.hpp"
+#include "pg/vidar_interface.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 标定的磁盘缓存，每个序列号一个二进制文件 <dir>/<serial>.pgcal
+ * @note 文件保存 StereoCalibration 的全部字段（矩阵为 double 原始数据），
+ * 读取时不经过 cv::FileStorage。写入先写临时文件再 rename，多个进程同时
+ * 读写同一目录是安全的；文件带校验和，损坏或截断的文件视为未命中。
+ */
+class CalibrationCache {
+ public:
+  /**
+   * @param  dir: 缓存目录，须已存在
+   */
+  explicit CalibrationCache(const std::string &dir) : dir_(dir) {}
+
+  /**
+   * @brief  读取缓存的标定
+   * @param  key: 序列号，通常为 serial_number
+   * @param  version: 期望的标定版本，为空表示不校验
+   * @param  *out: [out] 标定参数
+   * @retval 0 命中，-1 没有缓存，-2 文件损坏或版本不符
+   */
+  int Load(const std::string &key, const std::string &version,
+           StereoCalibration *out) const {
+    if (key.empty()) {
+      return -1;
+    }
+    FILE *fd = fopen(Path(key).c_str(), "rb");
+    if (fd == nullptr) {
+      return -1;
+    }
+    std::vector<char> buf;
+    char chunk[4096];
+    size_t n = 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), fd)) > 0) {
+      buf.insert(buf.end(), chunk, chunk + n);
+    }
+    fclose(fd);
+    StereoCalibration result;
+    if (Decode(buf, &result) != 0 ||
+        (!version.empty() && result.version != version)) {
+      return -2;
+    }
+    *out = result;
+    return 0;
+  }
+
+  /**
+   * @brief  写入缓存，覆盖该序列号之前的版本
+   * @param  &calib: 标定参数
+   * @param  key: 序列号，为空时使用 calib.serial_number
+   * @retval 0 成功，-1 没有序列号，-2 写文件失败
+   */
+  int Store(const StereoCalibration &calib,
+            const std::string &key = "") const {
+    const std::string &name = key.empty() ? calib.serial_number : key;
+    if (name.empty()) {
+      return -1;
+    }
+    std::vector<char> buf;
+    Encode(calib, &buf);
+    std::string path = Path(name);
+    std::string tmp = path + ".tmp" + std::to_string(getpid());
+    FILE *fd = fopen(tmp.c_str(), "wb");
+    if (fd == nullptr) {
+      return -2;
+    }
+    bool ok = fwrite(buf.data(), 1, buf.size(), fd) == buf.size();
+    ok = fclose(fd) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+      remove(tmp.c_str());
+      return -2;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  删除缓存
+   * @retval 0 成功，-1 没有缓存
+   */
+  int Remove(const std::string &key) const {
+    return key.empty() || remove(Path(key).c_str()) != 0 ? -1 : 0;
+  }
+
+  /// 缓存文件路径，序列号中文件名不允许的字符替换为 '_'
+  std::string Path(const std::string &key) const {
+    std::string name = key;
+    for (auto &c : name) {
+      bool safe = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+                  (c >= 'A' && c <= 'Z') || c == '-' || c == '.';
+      if (!safe) {
+        c = '_';
+      }
+    }
+    return dir_ + "/" + name + ".pgcal";
+  }
+
+ private:
+  static constexpr uint32_t kMagic = 0x4C414347;  // "GCAL"
+  static constexpr uint32_t kFormat = 1;
+
+  static std::vector<const cv::Mat *> Mats(const StereoCalibration &c) {
+    return {&c.M1, &c.D1, &c.M2, &c.D2, &c.R,  &c.T,
+            &c.R1, &c.R2, &c.P1, &c.P2, &c.Q};
+  }
+
+  static uint64_t Checksum(const char *data, size_t size) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i) {
+      hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+  }
+
+  template <typename T>
+  static void Put(T value, std::vector<char> *buf) {
+    const char *p = reinterpret_cast<const char *>(&value);
+    buf->insert(buf->end(), p, p + sizeof(T));
+  }
+
+  static void PutString(const std::string &value, std::vector<char> *buf) {
+    Put(static_cast<uint32_t>(value.size()), buf);
+    buf->insert(buf->end(), value.begin(), value.end());
+  }
+
+  static void Encode(const StereoCalibration &calib, std::vector<char> *buf) {
+    buf->clear();
+    Put(kMagic, buf);
+    Put(kFormat, buf);
+    PutString(calib.product_number, buf);
+    PutString(calib.serial_number, buf);
+    PutString(calib.version, buf);
+    Put(static_cast<int32_t>(calib.shift), buf);
+    Put(static_cast<int32_t>(calib.image_width), buf);
+    Put(static_cast<int32_t>(calib.image_height), buf);
+    for (const cv::Mat *mat : Mats(calib)) {
+      cv::Mat value;
+      if (!mat->empty()) {
+        mat->convertTo(value, CV_64F);
+      }
+      Put(static_cast<int32_t>(value.rows), buf);
+      Put(static_cast<int32_t>(value.cols), buf);
+      for (int r = 0; r < value.rows; ++r) {
+        const char *row = value.ptr<char>(r);
+        buf->insert(buf->end(), row, row + value.cols * sizeof(double));
+      }
+    }
+    Put(Checksum(buf->data(), buf->size()), buf);
+  }
+
+  /// 顺序读取，越界时置 ok 为 false
+  struct Reader {
+    const std::vector<char> &buf;
+    size_t pos;
+    bool ok;
+
+    template <typename T>
+    T Get() {
+      T value{};
+      if (pos + sizeof(T) > buf.size()) {
+        ok = false;
+        return value;
+      }
+      memcpy(&value, buf.data() + pos, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    std::string GetString() {
+      uint32_t size = Get<uint32_t>();
+      if (!ok || pos + size > buf.size()) {
+        ok = false;
+        return std::string();
+      }
+      std::string value(buf.data() + pos, size);
+      pos += size;
+      return value;
+    }
+  };
+
+  static int Decode(const std::vector<char> &buf, StereoCalibration *out) {
+    if (buf.size() < sizeof(uint64_t)) {
+      return -1;
+    }
+    size_t payload = buf.size() - sizeof(uint64_t);
+    uint64_t checksum = 0;
+    memcpy(&checksum, buf.data() + payload, sizeof(checksum));
+    if (checksum != Checksum(buf.data(), payload)) {
+      return -1;
+    }
+    Reader reader{buf, 0, true};
+    if (reader.Get<uint32_t>() != kMagic ||
+        reader.Get<uint32_t>() != kFormat) {
+      return -1;
+    }
+    out->product_number = reader.GetString();
+    out->serial_number = reader.GetString();
+    out->version = reader.GetString();
+    out->shift = reader.Get<int32_t>();
+    out->image_width = reader.Get<int32_t>();
+    out->image_height = reader.Get<int32_t>();
+    cv::Mat *mats[] = {&out->M1, &out->D1, &out->M2, &out->D2,
+                       &out->R,  &out->T,  &out->R1, &out->R2,
+                       &out->P1, &out->P2, &out->Q};
+    for (cv::Mat *mat : mats) {
+      int32_t rows = reader.Get<int32_t>();
+      int32_t cols = reader.Get<int32_t>();
+      size_t bytes = static_cast<size_t>(rows) * cols * sizeof(double);
+      if (!reader.ok || rows < 0 || cols < 0 || rows > 16 || cols > 16 ||
+          reader.pos + bytes > payload) {
+        return -1;
+      }
+      if (rows == 0 || cols == 0) {
+        *mat = cv::Mat();
+        continue;
+      }
+      cv::Mat(rows, cols, CV_64F,
+              const_cast<char *>(buf.data() + reader.pos))
+          .copyTo(*mat);
+      reader.pos += bytes;
+    }
+    return reader.ok && reader.pos == payload ? 0 : -1;
+  }
+
+  std::string dir_;
+};
+
+/// LoadCameraCalibration 两次 GetConfig 重试之间的间隔，毫秒
+constexpr int kGetConfigRetryMs = 100;
+
+/**
+ * @brief  激活板端输出并取得标定，优先使用缓存
+ * @note   key 命中缓存时 GetConfig 只用于激活板端输出，返回 1（已激活但
+ * 未取得相机信息）也视为成功，不再重试也不解析 YAML；否则每隔
+ * kGetConfigRetryMs 重试 GetConfig，直到取得相机信息（返回 0 或 2 但不带
+ * 相机信息同样重试）。key 为空时用返回的序列号查找缓存，未命中才解析
+ * YAML，解析成功后写入缓存。缓存命中时不会与设备上的标定比对，设备重新
+ * 标定后应删除缓存或指定 version。
+ * @param  *vidar: 已 Init 的数据接口
+ * @param  flow_json: GetConfig 请求 json
+ * @param  retries: GetConfig 未取得相机信息时的重试次数
+ * @param  *cache: 可为空，为空时不使用缓存
+ * @param  key: 缓存的序列号，为空时使用 GetConfig 返回的序列号
+ * @param  version: 期望的标定版本，为空表示不校验
+ * @param  *out: [out] 标定参数
+ * @param  *from_cache: [out] 可为空，标定是否来自缓存
+ * @retval 0 成功，<0 为 GetConfig 或 ParseCameraConfig 的错误码，重试后
+ * 仍没有相机信息时为 -1
+ */
+inline int LoadCameraCalibration(VidarInterface *vidar,
+                                 const std::string &flow_json, int retries,
+                                 const CalibrationCache *cache,
+                                 const std::string &key,
+                                 const std::string &version,
+                                 StereoCalibration *out,
+                                 bool *from_cache = nullptr) {
+  bool hit = cache != nullptr && cache->Load(key, version, out) == 0;
+  if (from_cache != nullptr) {
+    *from_cache = false;
+  }
+  std::string ret_json;
+  std::string serial;
+  bool camera = false;
+  int ret = -1;
+  for (int i = 0; i <= retries; ++i) {
+    if (i > 0) {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(kGetConfigRetryMs));
+    }
+    ret = vidar->GetConfig(flow_json, ret_json);
+    if (ret < 0) {
+      continue;
+    }
+    camera = (ret == 0 || ret == 2) &&
+             ParseCameraSerial(ret_json, &serial) == 0;
+    if (camera || hit) {
+      break;
+    }
+  }
+  if (ret < 0) {
+    return ret;
+  }
+  if (!hit && !camera) {
+    return -1;
+  }
+  if (!hit && key.empty() && cache != nullptr) {
+    hit = cache->Load(serial, version, out) == 0;
+  }
+  if (hit) {
+    if (from_cache != nullptr) {
+      *from_cache = true;
+    }
+    return 0;
+  }
+  ret = ParseCameraConfig(ret_json, out);
+  if (ret == 0 && cache != nullptr) {
+    cache->Store(*out);
+    if (!key.empty() && key != out->serial_number) {
+      cache->Store(*out, key);
+    }
+  }
+  return ret;
+}
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_CALIBRATION_CACHE_HPP_
@@ -0,0 +1,311 @@
+/**
+ * @file vidar_clock_sync.hpp
+ * @brief 设备时钟到主机单调时钟的映射
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_CLOCK_SYNC_HPP_
+#define PG_VIDAR_CLOCK_SYNC_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 时钟同步参数
+ */
+struct ClockSyncConfig {
+  /// 分块时长（设备时钟），每块只保留传输延迟最小的样本
+  uint64_t block_ns = 500000000ull;
+  /// 参与回归的块数，窗口长度为 window_blocks * block_ns
+  int window_blocks = 32;
+  /// 块数达到该值后才估计漂移，之前只估计偏移
+  int min_blocks = 8;
+  /// 漂移估计超过该值时视为异常，只估计偏移
+  double max_drift_ppm = 500;
+  /// 观测偏移比预测小超过该值时认为设备时钟重置，清空窗口
+  uint64_t reset_threshold_ns = 1000000000ull;
+  /// 偏移比预测大超过 reset_threshold_ns 的样本连续出现该次数时才认为
+  /// 重置，单个迟到样本（主机卡顿、调度延迟）只作为普通噪声
+  int reset_late_samples = 8;
+};
+
+/**
+ * @brief 时钟同步状态
+ */
+struct ClockSyncState {
+  bool synced = false;
+  /// 最新参考点处的偏移，host = device + offset_ns
+  int64_t offset_ns = 0;
+  /// 设备时钟相对主机时钟的漂移
+  double drift_ppm = 0;
+  /// 各块最小偏移相对回归直线的均方根，微秒
+  double residual_us = 0;
+  uint64_t samples = 0;
+  int blocks = 0;
+  /// 检测到设备时钟重置的次数
+  uint64_t resets = 0;
+};
+
+/**
+ * @brief 由 (设备时间戳, 主机接收时间) 样本在线估计设备时钟到主机
+ * CLOCK_MONOTONIC（steady_clock）的偏移与漂移
+ * @note 每个样本的 host - device 等于真实偏移加上传输延迟，按块取最小值
+ * 去掉排队抖动，再对窗口内的块做线性回归。预编译库不提供往返时间戳，
+ * 只能使用单向样本，估计出的偏移包含最小传输延迟（通常为常量）。
+ * AddSample 只能在一个线程调用；HostTimeOf 为 O(1)，通过序号校验读取
+ * 参数，不加锁，可在任意线程并发调用。
+ */
+class ClockSynchronizer {
+ public:
+  explicit ClockSynchronizer(const ClockSyncConfig &config = ClockSyncConfig())
+      : config_(config) {
+    config_.block_ns = std::max<uint64_t>(config_.block_ns, 1);
+    config_.window_blocks = std::max(config_.window_blocks, 2);
+    config_.min_blocks =
+        std::min(std::max(config_.min_blocks, 2), config_.window_blocks);
+    config_.reset_late_samples = std::max(config_.reset_late_samples, 1);
+    blocks_.resize(config_.window_blocks);
+  }
+
+  ClockSynchronizer(const ClockSynchronizer &) = delete;
+  ClockSynchronizer &operator=(const ClockSynchronizer &) = delete;
+
+  /**
+   * @brief  加入一个样本，不分配内存
+   * @param  device_ns: 设备时间戳
+   * @param  host_ns: 收到该数据时的主机单调时钟
+   */
+  void AddSample(uint64_t device_ns, uint64_t host_ns) {
+    int64_t offset = static_cast<int64_t>(host_ns - device_ns);
+    if (count_ > 0 && IsReset(device_ns, offset)) {
+      resets_.fetch_add(1, std::memory_order_relaxed);
+      count_ = 0;
+      head_ = 0;
+      late_run_ = 0;
+      // 设备时钟回退后以新的时间为准，否则后续样本会反复判定为重置
+      last_device_ns_ = device_ns;
+    }
+    samples_.fetch_add(1, std::memory_order_relaxed);
+    last_device_ns_ = std::max(last_device_ns_, device_ns);
+    uint64_t block = device_ns / config_.block_ns;
+    if (count_ == 0 || block > Newest().block) {
+      head_ = (head_ + 1) % config_.window_blocks;
+      count_ = std::min(count_ + 1, config_.window_blocks);
+      blocks_[head_] = Block{block, device_ns, offset};
+    } else if (block == Newest().block && offset < Newest().offset) {
+      blocks_[head_].device_ns = device_ns;
+      blocks_[head_].offset = offset;
+    } else {
+      return;
+    }
+    Fit();
+  }
+
+  /**
+   * @brief  设备时间戳对应的主机单调时钟，O(1)
+   * @note   尚未同步时按偏移 0 换算
+   */
+  uint64_t HostTimeOf(uint64_t device_ns) const {
+    uint64_t ref = 0;
+    int64_t offset = 0;
+    double drift = 0;
+    Load(&ref, &offset, &drift);
+    double delta = Elapsed(device_ns, ref) * drift;
+    return device_ns + static_cast<uint64_t>(offset) +
+           static_cast<uint64_t>(static_cast<int64_t>(std::llround(delta)));
+  }
+
+  bool Synced() const { return synced_.load(std::memory_order_acquire); }
+
+  ClockSyncState GetState() const {
+    ClockSyncState state;
+    uint64_t ref = 0;
+    double drift = 0;
+    Load(&ref, &state.offset_ns, &drift);
+    state.synced = Synced();
+    state.drift_ppm = drift * 1e6;
+    state.residual_us = residual_us_.load(std::memory_order_relaxed);
+    state.samples = samples_.load(std::memory_order_relaxed);
+    state.blocks = blocks_count_.load(std::memory_order_relaxed);
+    state.resets = resets_.load(std::memory_order_relaxed);
+    return state;
+  }
+
+  /// 清空样本，只能在调用 AddSample 的线程调用
+  void Reset() {
+    count_ = 0;
+    head_ = 0;
+    samples_.store(0, std::memory_order_relaxed);
+    blocks_count_.store(0, std::memory_order_relaxed);
+    last_device_ns_ = 0;
+    late_run_ = 0;
+    synced_.store(false, std::memory_order_release);
+    Publish(0, 0, 0);
+  }
+
+ private:
+  struct Block {
+    uint64_t block;
+    uint64_t device_ns;
+    int64_t offset;
+  };
+
+  const Block &Newest() const { return blocks_[head_]; }
+
+  /// 观测偏移与当前模型的差，正值表示样本比下包络晚到
+  double Deviation(uint64_t device_ns, int64_t offset) const {
+    double predicted =
+        static_cast<double>(fit_offset_) +
+        fit_drift_ * Elapsed(device_ns, fit_ref_);
+    return static_cast<double>(offset) - predicted;
+  }
+
+  /// 传输延迟不为负，偏移明显低于下包络只能是时钟跳变；偏移偏高可能是
+  /// 样本迟到，连续 reset_late_samples 个才认为重置
+  bool IsReset(uint64_t device_ns, int64_t offset) {
+    if (device_ns + config_.block_ns < last_device_ns_) {
+      return true;
+    }
+    double deviation = Deviation(device_ns, offset);
+    double threshold = static_cast<double>(config_.reset_threshold_ns);
+    if (deviation < -threshold) {
+      return true;
+    }
+    if (deviation <= threshold) {
+      late_run_ = 0;
+      return false;
+    }
+    return ++late_run_ >= config_.reset_late_samples;
+  }
+
+  void Fit() {
+    const Block &newest = Newest();
+    uint64_t ref = newest.device_ns;
+    int64_t base = newest.offset;
+    double drift = 0;
+    double offset = 0;
+    if (count_ < config_.min_blocks) {
+      // 样本不足时取窗口内最小偏移
+      int64_t min_offset = newest.offset;
+      for (int i = 0; i < count_; ++i) {
+        min_offset = std::min(min_offset, At(i).offset);
+      }
+      offset = static_cast<double>(min_offset - base);
+    } else {
+      double sx = 0, sy = 0, sxx = 0, sxy = 0;
+      for (int i = 0; i < count_; ++i) {
+        const Block &b = At(i);
+        double x = Elapsed(b.device_ns, ref);
+        double y = static_cast<double>(b.offset - base);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+      }
+      double n = static_cast<double>(count_);
+      double den = n * sxx - sx * sx;
+      if (den > 0) {
+        drift = (n * sxy - sx * sy) / den;
+      }
+      if (std::fabs(drift) * 1e6 > config_.max_drift_ppm) {
+        drift = 0;
+      }
+      offset = (sy - drift * sx) / n;
+      // 各块最小值仍含传输延迟，把回归直线平移到下包络
+      double shift = 0;
+      double sq = 0;
+      for (int i = 0; i < count_; ++i) {
+        const Block &b = At(i);
+        double x = Elapsed(b.device_ns, ref);
+        double r =
+            static_cast<double>(b.offset - base) - (offset + drift * x);
+        shift = std::min(shift, r);
+        sq += r * r;
+      }
+      offset += shift;
+      residual_us_.store(std::sqrt(sq / n) / 1000.0,
+                         std::memory_order_relaxed);
+    }
+    fit_ref_ = ref;
+    fit_offset_ = base + static_cast<int64_t>(std::llround(offset));
+    fit_drift_ = drift;
+    Publish(fit_ref_, fit_offset_, fit_drift_);
+    blocks_count_.store(count_, std::memory_order_relaxed);
+    synced_.store(true, std::memory_order_release);
+  }
+
+  static double Elapsed(uint64_t ns, uint64_t ref) {
+    return static_cast<double>(static_cast<int64_t>(ns - ref));
+  }
+
+  /// 第 i 个块，0 为最旧
+  const Block &At(int i) const {
+    int index = (head_ - count_ + 1 + i + config_.window_blocks) %
+                config_.window_blocks;
+    return blocks_[index];
+  }
+
+  void Publish(uint64_t ref, int64_t offset, double drift) {
+    uint32_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ref_.store(ref, std::memory_order_relaxed);
+    offset_.store(offset, std::memory_order_relaxed);
+    drift_.store(drift, std::memory_order_relaxed);
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  void Load(uint64_t *ref, int64_t *offset, double *drift) const {
+    while (true) {
+      uint32_t seq = seq_.load(std::memory_order_acquire);
+      if (seq & 1) {
+        continue;
+      }
+      *ref = ref_.load(std::memory_order_relaxed);
+      *offset = offset_.load(std::memory_order_relaxed);
+      *drift = drift_.load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq_.load(std::memory_order_relaxed) == seq) {
+        return;
+      }
+    }
+  }
+
+  ClockSyncConfig config_;
+  // 以下只由 AddSample 线程访问
+  std::vector<Block> blocks_;
+  int head_ = 0;
+  int count_ = 0;
+  uint64_t last_device_ns_ = 0;
+  /// 连续偏移偏高的样本数
+  int late_run_ = 0;
+  uint64_t fit_ref_ = 0;
+  int64_t fit_offset_ = 0;
+  double fit_drift_ = 0;
+  // 发布给读取线程
+  std::atomic<uint32_t> seq_{0};
+  std::atomic<uint64_t> ref_{0};
+  std::atomic<int64_t> offset_{0};
+  std::atomic<double> drift_{0};
+  std::atomic<bool> synced_{false};
+  std::atomic<double> residual_us_{0};
+  std::atomic<uint64_t> samples_{0};
+  std::atomic<int> blocks_count_{0};
+  std::atomic<uint64_t> resets_{0};
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_CLOCK_SYNC_HPP_
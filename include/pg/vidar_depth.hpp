@@ -0,0 +1,1036 @@
+/**
+ * @file vidar_depth.hpp
+ * @brief 视差图转深度图
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_DEPTH_HPP_
+#define PG_VIDAR_DEPTH_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "pg/utils/thread_pool.hpp"
+#include "pg/vidar_calibration.hpp"
+#include "vision_type/image_frame_pool.hpp"
+#include "vision_type/simd_dispatch.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 深度图的存储方式
+ */
+enum class DepthUnit {
+  /// uint16 毫米，帧格式为 kPGPixelFormatInt16（按无符号解释），
+  /// float_scale 为 0.001
+  kMillimeter = 0,
+  /// float32 米，帧格式为 kPGPixelFormatFloat32
+  kMeter = 1,
+};
+
+/**
+ * @brief 视差置信度的参数，置信度为纹理、视差梯度与时域稳定性三项之积
+ */
+struct ConfidenceConfig {
+  /// 左图梯度（水平与竖直中心差分绝对值之和的一半，灰度级）达到该值时
+  /// 纹理项为 1
+  float texture_full = 16.0f;
+  /// 视差梯度（像素）达到该值时梯度项为 0
+  float gradient_max = 2.0f;
+  /// 与上一帧视差之差（像素）达到该值时时域项为 0
+  float temporal_max_diff = 1.0f;
+  /// 上一帧该点无效或没有上一帧时的时域项
+  float temporal_unknown = 0.5f;
+  /// 置信度（0 ~ 255）低于该值的点深度输出 0，0 表示不剔除，
+  /// 只在生成置信度时生效
+  int min_confidence = 0;
+  /// 置信度帧的 channel_id，小于 0 时与视差帧相同；
+  /// 追加到 VidarData::images 时应指定一个未使用的通道
+  int channel_id = -1;
+};
+
+struct DepthConverterConfig {
+  DepthUnit unit = DepthUnit::kMillimeter;
+  /// 视差（像素）不大于该值时视为无效，深度输出 0，不能小于 0
+  float min_disparity = 0.5f;
+  /// 深度超过该值（米）时输出 0，0 表示不限制
+  float max_depth_m = 0.0f;
+  /// 标定中平移量的单位（米），0 表示自动判断：基线大于 1 视为毫米
+  double baseline_unit_m = 0.0;
+  /// 是否把 GetConfig 返回的 shift（>= 0 时）作为视差偏移
+  bool apply_shift = true;
+  /// 行分块的并行度，0 表示 std::thread::hardware_concurrency()
+  int num_threads = 0;
+  /// 置信度参数，只在调用带置信度输出的 Convert 时使用
+  ConfidenceConfig confidence;
+};
+
+namespace detail {
+
+/**
+ * 深度计算参数：disp = raw * scale + offset，
+ * raw > 0 且 disp > min_disp 时 depth = fb / disp，超过 max_depth 时输出 0
+ */
+struct DepthParams {
+  float scale = 1.0f;
+  float offset = 0.0f;
+  float min_disp = 0.5f;
+  /// 焦距与基线之积，单位与输出一致（毫米或米）
+  float fb = 0.0f;
+  float max_depth = 0.0f;
+};
+
+inline float DisparityToDepth(float raw, const DepthParams &p) {
+  float disp = raw * p.scale + p.offset;
+  // 原始值为 0 或负数表示无效视差
+  if (!(raw > 0) || !(disp > p.min_disp)) {
+    return 0.0f;
+  }
+  float depth = p.fb / disp;
+  return p.max_depth > 0 && depth > p.max_depth ? 0.0f : depth;
+}
+
+inline uint16_t DepthToU16(float depth) {
+  return static_cast<uint16_t>(std::min(depth + 0.5f, 65535.0f));
+}
+
+inline void FloatDispRowScalar(const float *in, const DepthParams &p,
+                               float *out_f32, uint16_t *out_u16, int begin,
+                               int count) {
+  for (int i = begin; i < count; ++i) {
+    float depth = DisparityToDepth(in[i], p);
+    if (out_f32 != nullptr) {
+      out_f32[i] = depth;
+    } else {
+      out_u16[i] = DepthToU16(depth);
+    }
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void FloatDispRowSse41(const float *in,
+                                              const DepthParams &p,
+                                              float *out_f32,
+                                              uint16_t *out_u16, int count) {
+  const __m128 scale = _mm_set1_ps(p.scale);
+  const __m128 offset = _mm_set1_ps(p.offset);
+  const __m128 min_disp = _mm_set1_ps(p.min_disp);
+  const __m128 fb = _mm_set1_ps(p.fb);
+  const __m128 max_depth =
+      _mm_set1_ps(p.max_depth > 0 ? p.max_depth : 3.4e38f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 u16_max = _mm_set1_ps(65535.0f);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128 depth[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128 raw = _mm_loadu_ps(in + i + 4 * k);
+      __m128 disp = _mm_add_ps(_mm_mul_ps(raw, scale), offset);
+      __m128 d = _mm_div_ps(fb, disp);
+      // NaN 比较结果为假，与标量实现一致
+      __m128 valid = _mm_and_ps(
+          _mm_and_ps(_mm_cmpgt_ps(raw, zero), _mm_cmpgt_ps(disp, min_disp)),
+          _mm_cmple_ps(d, max_depth));
+      depth[k] = _mm_and_ps(d, valid);
+    }
+    if (out_f32 != nullptr) {
+      _mm_storeu_ps(out_f32 + i, depth[0]);
+      _mm_storeu_ps(out_f32 + i + 4, depth[1]);
+    } else {
+      __m128i a = _mm_cvttps_epi32(
+          _mm_min_ps(_mm_add_ps(depth[0], half), u16_max));
+      __m128i b = _mm_cvttps_epi32(
+          _mm_min_ps(_mm_add_ps(depth[1], half), u16_max));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out_u16 + i),
+                       _mm_packus_epi32(a, b));
+    }
+  }
+  FloatDispRowScalar(in, p, out_f32, out_u16, i, count);
+}
+
+PG_TARGET_AVX2 inline void FloatDispRowAvx2(const float *in,
+                                            const DepthParams &p,
+                                            float *out_f32, uint16_t *out_u16,
+                                            int count) {
+  const __m256 scale = _mm256_set1_ps(p.scale);
+  const __m256 offset = _mm256_set1_ps(p.offset);
+  const __m256 min_disp = _mm256_set1_ps(p.min_disp);
+  const __m256 fb = _mm256_set1_ps(p.fb);
+  const __m256 max_depth =
+      _mm256_set1_ps(p.max_depth > 0 ? p.max_depth : 3.4e38f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 u16_max = _mm256_set1_ps(65535.0f);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256 depth[2];
+    for (int k = 0; k < 2; ++k) {
+      __m256 raw = _mm256_loadu_ps(in + i + 8 * k);
+      __m256 disp = _mm256_add_ps(_mm256_mul_ps(raw, scale), offset);
+      __m256 d = _mm256_div_ps(fb, disp);
+      __m256 valid = _mm256_and_ps(
+          _mm256_and_ps(_mm256_cmp_ps(raw, zero, _CMP_GT_OQ),
+                        _mm256_cmp_ps(disp, min_disp, _CMP_GT_OQ)),
+          _mm256_cmp_ps(d, max_depth, _CMP_LE_OQ));
+      depth[k] = _mm256_and_ps(d, valid);
+    }
+    if (out_f32 != nullptr) {
+      _mm256_storeu_ps(out_f32 + i, depth[0]);
+      _mm256_storeu_ps(out_f32 + i + 8, depth[1]);
+    } else {
+      __m256i a = _mm256_cvttps_epi32(
+          _mm256_min_ps(_mm256_add_ps(depth[0], half), u16_max));
+      __m256i b = _mm256_cvttps_epi32(
+          _mm256_min_ps(_mm256_add_ps(depth[1], half), u16_max));
+      // packus 按 128 位通道交错，permute 恢复顺序
+      __m256i packed =
+          _mm256_permute4x64_epi64(_mm256_packus_epi32(a, b), 0xD8);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(out_u16 + i), packed);
+    }
+  }
+  FloatDispRowScalar(in, p, out_f32, out_u16, i, count);
+}
+#endif  // PG_SIMD_X86
+
+#if defined(PG_SIMD_NEON)
+inline void FloatDispRowNeon(const float *in, const DepthParams &p,
+                             float *out_f32, uint16_t *out_u16, int count) {
+  const float32x4_t scale = vdupq_n_f32(p.scale);
+  const float32x4_t offset = vdupq_n_f32(p.offset);
+  const float32x4_t min_disp = vdupq_n_f32(p.min_disp);
+  const float32x4_t max_depth =
+      vdupq_n_f32(p.max_depth > 0 ? p.max_depth : 3.4e38f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t u16_max = vdupq_n_f32(65535.0f);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t raw = vld1q_f32(in + i);
+    float32x4_t disp = vaddq_f32(vmulq_f32(raw, scale), offset);
+    // 倒数估计加两次牛顿迭代，armv7 没有向量除法
+    float32x4_t r = vrecpeq_f32(disp);
+    r = vmulq_f32(r, vrecpsq_f32(disp, r));
+    r = vmulq_f32(r, vrecpsq_f32(disp, r));
+    float32x4_t d = vmulq_n_f32(r, p.fb);
+    uint32x4_t valid = vandq_u32(
+        vandq_u32(vcgtq_f32(raw, vdupq_n_f32(0.0f)), vcgtq_f32(disp, min_disp)),
+        vcleq_f32(d, max_depth));
+    float32x4_t depth = vreinterpretq_f32_u32(
+        vandq_u32(vreinterpretq_u32_f32(d), valid));
+    if (out_f32 != nullptr) {
+      vst1q_f32(out_f32 + i, depth);
+    } else {
+      uint32x4_t v = vcvtq_u32_f32(vminq_f32(vaddq_f32(depth, half), u16_max));
+      vst1_u16(out_u16 + i, vmovn_u32(v));
+    }
+  }
+  FloatDispRowScalar(in, p, out_f32, out_u16, i, count);
+}
+#endif  // PG_SIMD_NEON
+
+/// 一行 float32 视差转深度，out_f32 与 out_u16 二选一
+inline void FloatDispRow(const float *in, const DepthParams &p,
+                         float *out_f32, uint16_t *out_u16, int count) {
+  using phigent::vision::SimdLevel;
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      FloatDispRowAvx2(in, p, out_f32, out_u16, count);
+      return;
+    case SimdLevel::kSse41:
+      FloatDispRowSse41(in, p, out_f32, out_u16, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      FloatDispRowNeon(in, p, out_f32, out_u16, count);
+      return;
+#endif
+    default:
+      FloatDispRowScalar(in, p, out_f32, out_u16, 0, count);
+      return;
+  }
+}
+
+/// 按原始视差值索引的深度表，用于 int16/uint8 视差
+struct DepthLut {
+  PGPixelFormat format = kPGPixelFormatNone;
+  float scale = 0.0f;
+  std::vector<uint16_t> u16;
+  std::vector<float> f32;
+};
+
+template <typename Src, typename Dst>
+inline void LutRow(const Src *in, const Dst *lut, Dst *out, int count) {
+  for (int i = 0; i < count; ++i) {
+    out[i] = lut[static_cast<typename std::make_unsigned<Src>::type>(in[i])];
+  }
+}
+
+/// 支持的视差格式的元素字节数，不支持时返回 0
+inline size_t DisparityElemSize(PGPixelFormat format) {
+  switch (format) {
+    case kPGPixelFormatInt16:
+      return 2;
+    case kPGPixelFormatFloat32:
+      return 4;
+    case kPGPixelFormatUint8:
+    case kPGPixelFormatRawGRAY:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+/// 首个平面为 8 位亮度的格式
+inline bool IsGrayLike(PGPixelFormat format) {
+  switch (format) {
+    case kPGPixelFormatRawGRAY:
+    case kPGPixelFormatUint8:
+    case kPGPixelFormatRawNV12:
+    case kPGPixelFormatRawNV21:
+    case kPGPixelFormatRawI420:
+    case kPGPixelFormatRawYV12:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// 按采样间隔读取一行视差并换算为像素视差（无效值为 0）
+inline void LoadDisparityRow(const uint8_t *src, PGPixelFormat format,
+                             float scale, float offset, uint32_t x0,
+                             uint32_t step, int count, float *out) {
+  for (int i = 0; i < count; ++i) {
+    size_t u = x0 + static_cast<size_t>(step) * i;
+    float raw;
+    if (format == kPGPixelFormatInt16) {
+      raw = reinterpret_cast<const int16_t *>(src)[u];
+    } else if (format == kPGPixelFormatFloat32) {
+      raw = reinterpret_cast<const float *>(src)[u];
+    } else {
+      raw = src[u];
+    }
+    out[i] = raw > 0 ? raw * scale + offset : 0.0f;
+  }
+}
+
+/// 置信度计算参数，各项已换算为倒数
+struct ConfidenceParams {
+  float inv_texture = 1.0f;
+  float inv_gradient = 1.0f;
+  float inv_temporal = 1.0f;
+  float unknown = 0.5f;
+};
+
+/**
+ * 一行的置信度：255 * 纹理项 * 梯度项 * 时域项，每项截断到 [0, 1]。
+ * up/cur/down 为像素视差（无效为 0），视差梯度取水平与竖直中心差分的一半中
+ * 较大者，相邻点无效时梯度按视差本身计算，即边缘处置信度低。texture 为空时
+ * 不计纹理项；prev 为空时不计时域项，否则读取上一帧视差后写入当前视差。
+ * 只计算 [begin, end) 列，count 为行宽
+ */
+inline void ConfidenceRowScalar(const float *up, const float *cur,
+                                const float *down, const float *texture,
+                                float *prev, const ConfidenceParams &p,
+                                uint8_t *out, int count, int begin, int end) {
+  for (int x = begin; x < end; ++x) {
+    float d = cur[x];
+    float gx = std::fabs(cur[std::min(x + 1, count - 1)] -
+                         cur[std::max(x - 1, 0)]) *
+               0.5f;
+    float gy = std::fabs(down[x] - up[x]) * 0.5f;
+    float c = 255.0f * std::max(1.0f - std::max(gx, gy) * p.inv_gradient,
+                                0.0f);
+    if (texture != nullptr) {
+      c *= std::min(texture[x] * p.inv_texture, 1.0f);
+    }
+    if (prev != nullptr) {
+      float last = prev[x];
+      c *= last > 0 ? std::max(1.0f - std::fabs(d - last) * p.inv_temporal,
+                               0.0f)
+                    : p.unknown;
+      prev[x] = d;
+    }
+    out[x] = d > 0 ? static_cast<uint8_t>(c + 0.5f) : 0;
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void ConfidenceRowSse41(
+    const float *up, const float *cur, const float *down,
+    const float *texture, float *prev, const ConfidenceParams &p,
+    uint8_t *out, int count) {
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 inv_gradient = _mm_set1_ps(p.inv_gradient);
+  const __m128 inv_texture = _mm_set1_ps(p.inv_texture);
+  const __m128 inv_temporal = _mm_set1_ps(p.inv_temporal);
+  const __m128 unknown = _mm_set1_ps(p.unknown);
+  int x = 1;
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count, 0,
+                      std::min(1, count));
+  for (; x + 8 + 1 <= count; x += 8) {
+    __m128i c32[2];
+    for (int k = 0; k < 2; ++k) {
+      int i = x + 4 * k;
+      __m128 d = _mm_loadu_ps(cur + i);
+      __m128 gx = _mm_mul_ps(
+          _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(cur + i + 1),
+                                _mm_loadu_ps(cur + i - 1)),
+                     abs_mask),
+          half);
+      __m128 gy = _mm_mul_ps(
+          _mm_and_ps(_mm_sub_ps(_mm_loadu_ps(down + i), _mm_loadu_ps(up + i)),
+                     abs_mask),
+          half);
+      __m128 c = _mm_mul_ps(
+          _mm_set1_ps(255.0f),
+          _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(_mm_max_ps(gx, gy),
+                                                inv_gradient)),
+                     zero));
+      if (texture != nullptr) {
+        c = _mm_mul_ps(c, _mm_min_ps(_mm_mul_ps(_mm_loadu_ps(texture + i),
+                                                inv_texture),
+                                     one));
+      }
+      if (prev != nullptr) {
+        __m128 last = _mm_loadu_ps(prev + i);
+        __m128 diff = _mm_and_ps(_mm_sub_ps(d, last), abs_mask);
+        __m128 t = _mm_max_ps(_mm_sub_ps(one, _mm_mul_ps(diff, inv_temporal)),
+                              zero);
+        c = _mm_mul_ps(c, _mm_blendv_ps(unknown, t, _mm_cmpgt_ps(last, zero)));
+        _mm_storeu_ps(prev + i, d);
+      }
+      c = _mm_and_ps(_mm_add_ps(c, half), _mm_cmpgt_ps(d, zero));
+      c32[k] = _mm_cvttps_epi32(c);
+    }
+    __m128i c16 = _mm_packus_epi32(c32[0], c32[1]);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + x),
+                     _mm_packus_epi16(c16, c16));
+  }
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count,
+                      std::max(x, std::min(1, count)), count);
+}
+
+PG_TARGET_AVX2 inline void ConfidenceRowAvx2(
+    const float *up, const float *cur, const float *down,
+    const float *texture, float *prev, const ConfidenceParams &p,
+    uint8_t *out, int count) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 inv_gradient = _mm256_set1_ps(p.inv_gradient);
+  const __m256 inv_texture = _mm256_set1_ps(p.inv_texture);
+  const __m256 inv_temporal = _mm256_set1_ps(p.inv_temporal);
+  const __m256 unknown = _mm256_set1_ps(p.unknown);
+  int x = 1;
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count, 0,
+                      std::min(1, count));
+  for (; x + 16 + 1 <= count; x += 16) {
+    __m256i c32[2];
+    for (int k = 0; k < 2; ++k) {
+      int i = x + 8 * k;
+      __m256 d = _mm256_loadu_ps(cur + i);
+      __m256 gx = _mm256_mul_ps(
+          _mm256_and_ps(_mm256_sub_ps(_mm256_loadu_ps(cur + i + 1),
+                                      _mm256_loadu_ps(cur + i - 1)),
+                        abs_mask),
+          half);
+      __m256 gy = _mm256_mul_ps(
+          _mm256_and_ps(
+              _mm256_sub_ps(_mm256_loadu_ps(down + i), _mm256_loadu_ps(up + i)),
+              abs_mask),
+          half);
+      __m256 c = _mm256_mul_ps(
+          _mm256_set1_ps(255.0f),
+          _mm256_max_ps(_mm256_sub_ps(one, _mm256_mul_ps(_mm256_max_ps(gx, gy),
+                                                         inv_gradient)),
+                        zero));
+      if (texture != nullptr) {
+        c = _mm256_mul_ps(
+            c, _mm256_min_ps(
+                   _mm256_mul_ps(_mm256_loadu_ps(texture + i), inv_texture),
+                   one));
+      }
+      if (prev != nullptr) {
+        __m256 last = _mm256_loadu_ps(prev + i);
+        __m256 diff = _mm256_and_ps(_mm256_sub_ps(d, last), abs_mask);
+        __m256 t = _mm256_max_ps(
+            _mm256_sub_ps(one, _mm256_mul_ps(diff, inv_temporal)), zero);
+        c = _mm256_mul_ps(
+            c, _mm256_blendv_ps(unknown, t,
+                                _mm256_cmp_ps(last, zero, _CMP_GT_OQ)));
+        _mm256_storeu_ps(prev + i, d);
+      }
+      c = _mm256_and_ps(_mm256_add_ps(c, half),
+                        _mm256_cmp_ps(d, zero, _CMP_GT_OQ));
+      c32[k] = _mm256_cvttps_epi32(c);
+    }
+    // packus 按 128 位通道交错，permute 恢复顺序
+    __m256i c16 =
+        _mm256_permute4x64_epi64(_mm256_packus_epi32(c32[0], c32[1]), 0xD8);
+    __m128i c8 = _mm_packus_epi16(_mm256_castsi256_si128(c16),
+                                  _mm256_extracti128_si256(c16, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), c8);
+  }
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count,
+                      std::max(x, std::min(1, count)), count);
+}
+#endif  // PG_SIMD_X86
+
+#if defined(PG_SIMD_NEON)
+inline void ConfidenceRowNeon(const float *up, const float *cur,
+                              const float *down, const float *texture,
+                              float *prev, const ConfidenceParams &p,
+                              uint8_t *out, int count) {
+  const float32x4_t zero = vdupq_n_f32(0.0f);
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  const float32x4_t half = vdupq_n_f32(0.5f);
+  const float32x4_t unknown = vdupq_n_f32(p.unknown);
+  int x = 1;
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count, 0,
+                      std::min(1, count));
+  for (; x + 8 + 1 <= count; x += 8) {
+    uint32x4_t c32[2];
+    for (int k = 0; k < 2; ++k) {
+      int i = x + 4 * k;
+      float32x4_t d = vld1q_f32(cur + i);
+      float32x4_t gx = vmulq_f32(
+          vabdq_f32(vld1q_f32(cur + i + 1), vld1q_f32(cur + i - 1)), half);
+      float32x4_t gy =
+          vmulq_f32(vabdq_f32(vld1q_f32(down + i), vld1q_f32(up + i)), half);
+      float32x4_t c = vmulq_n_f32(
+          vmaxq_f32(vsubq_f32(one, vmulq_n_f32(vmaxq_f32(gx, gy),
+                                               p.inv_gradient)),
+                    zero),
+          255.0f);
+      if (texture != nullptr) {
+        c = vmulq_f32(c, vminq_f32(vmulq_n_f32(vld1q_f32(texture + i),
+                                               p.inv_texture),
+                                   one));
+      }
+      if (prev != nullptr) {
+        float32x4_t last = vld1q_f32(prev + i);
+        float32x4_t t = vmaxq_f32(
+            vsubq_f32(one, vmulq_n_f32(vabdq_f32(d, last), p.inv_temporal)),
+            zero);
+        c = vmulq_f32(c, vbslq_f32(vcgtq_f32(last, zero), t, unknown));
+        vst1q_f32(prev + i, d);
+      }
+      c32[k] = vandq_u32(vcvtq_u32_f32(vaddq_f32(c, half)),
+                         vcgtq_f32(d, zero));
+    }
+    uint16x8_t c16 = vcombine_u16(vqmovn_u32(c32[0]), vqmovn_u32(c32[1]));
+    vst1_u8(out + x, vqmovn_u16(c16));
+  }
+  ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count,
+                      std::max(x, std::min(1, count)), count);
+}
+#endif  // PG_SIMD_NEON
+
+inline void ConfidenceRow(const float *up, const float *cur,
+                          const float *down, const float *texture,
+                          float *prev, const ConfidenceParams &p,
+                          uint8_t *out, int count) {
+  using phigent::vision::SimdLevel;
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      ConfidenceRowAvx2(up, cur, down, texture, prev, p, out, count);
+      return;
+    case SimdLevel::kSse41:
+      ConfidenceRowSse41(up, cur, down, texture, prev, p, out, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      ConfidenceRowNeon(up, cur, down, texture, prev, p, out, count);
+      return;
+#endif
+    default:
+      ConfidenceRowScalar(up, cur, down, texture, prev, p, out, count, 0,
+                          count);
+      return;
+  }
+}
+
+/**
+ * 左图在视差第 y 行对应位置的纹理：水平与竖直中心差分绝对值之和的一半，
+ * 左图尺寸不同时按比例采样
+ */
+inline void TextureRow(const uint8_t *gray, size_t step, uint32_t width,
+                       uint32_t height, float sx, uint32_t v, int count,
+                       float *out) {
+  const uint8_t *row = gray + step * v;
+  const uint8_t *up = gray + step * (v > 0 ? v - 1 : 0);
+  const uint8_t *down = gray + step * std::min(v + 1, height - 1);
+  for (int x = 0; x < count; ++x) {
+    uint32_t u = std::min(static_cast<uint32_t>(x * sx), width - 1);
+    uint32_t l = u > 0 ? u - 1 : 0;
+    uint32_t r = std::min(u + 1, width - 1);
+    out[x] = (std::abs(row[r] - row[l]) + std::abs(down[u] - up[u])) * 0.5f;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 视差图转深度图：depth = f * B / (raw * float_scale + offset)
+ * @note int16/uint8 视差使用按原始值索引的倒数查找表（首次遇到新的
+ * float_scale 时生成），float32 视差使用 SIMD 直接计算；整帧按行分块
+ * 在内部线程池上并行。需要置信度时在同一分块内紧接深度行计算，另按行
+ * 换算出像素视差供置信度使用。Init 之后 Convert 线程安全
+ */
+class DepthConverter {
+ public:
+  DepthConverter() = default;
+  DepthConverter(const DepthConverter &) = delete;
+  DepthConverter &operator=(const DepthConverter &) = delete;
+
+  /**
+   * @brief  使用 ParseCameraConfig 解析出的标定初始化
+   * @param  calib: 标定参数
+   * @param  config: 转换配置
+   * @retval 0 成功，-1 标定缺少焦距或基线
+   */
+  int Init(const StereoCalibration &calib,
+           const DepthConverterConfig &config = DepthConverterConfig()) {
+    if (!calib.Valid()) {
+      return -1;
+    }
+    double baseline = calib.Baseline();
+    double unit = config.baseline_unit_m;
+    if (unit <= 0) {
+      unit = baseline > 1.0 ? 0.001 : 1.0;
+    }
+    double offset = calib.PrincipalPointOffset();
+    if (config.apply_shift && calib.shift >= 0) {
+      offset += calib.shift;
+    }
+    return Init(calib.Focal(), baseline * unit, offset, config);
+  }
+
+  /**
+   * @brief  直接指定参数初始化
+   * @param  focal_px: 校正后焦距（像素）
+   * @param  baseline_m: 基线（米）
+   * @param  disparity_offset: 加到视差上的偏移（像素）
+   * @param  config: 转换配置
+   * @retval 0 成功，-1 参数无效
+   */
+  int Init(double focal_px, double baseline_m, double disparity_offset,
+           const DepthConverterConfig &config = DepthConverterConfig()) {
+    const ConfidenceConfig &confidence = config.confidence;
+    if (focal_px <= 0 || baseline_m <= 0 || !(config.min_disparity >= 0) ||
+        !(confidence.texture_full >= 0) || !(confidence.gradient_max > 0) ||
+        !(confidence.temporal_max_diff >= 0) ||
+        !(confidence.temporal_unknown >= 0) ||
+        confidence.temporal_unknown > 1 || confidence.min_confidence < 0 ||
+        confidence.min_confidence > 255) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    bool mm = config.unit == DepthUnit::kMillimeter;
+    params_.offset = static_cast<float>(disparity_offset);
+    params_.min_disp = config.min_disparity;
+    params_.fb = static_cast<float>(focal_px * baseline_m * (mm ? 1000 : 1));
+    params_.max_depth = config.max_depth_m * (mm ? 1000 : 1);
+    lut_.reset();
+    temporal_.clear();
+    int threads = utils::ThreadPool::ResolveNumThreads(config.num_threads);
+    if (!pool_ || pool_->NumThreads() != threads) {
+      pool_.reset(new utils::ThreadPool(config.num_threads));
+    }
+    return 0;
+  }
+
+  /// 是否已初始化
+  bool Ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return params_.fb > 0;
+  }
+
+  /**
+   * @brief  清除置信度时域项保存的上一帧视差
+   * @param  channel_id: 小于 0 表示全部通道
+   */
+  void ResetTemporal(int channel_id = -1) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel_id < 0) {
+      temporal_.clear();
+    } else {
+      temporal_.erase(static_cast<uint32_t>(channel_id));
+    }
+  }
+
+  /**
+   * @brief  视差帧转深度帧，输出帧来自缓存池
+   * @param  disparity: 视差帧，支持 kPGPixelFormatInt16/Uint8/RawGRAY/
+   * Float32，float_scale 为原始值到像素视差的系数
+   * @param  pool: 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+   * @retval 深度帧，继承 channel_id/time_stamp/frame_id/type；失败返回
+   * nullptr
+   */
+  phigent::vision::ImageFramePtr Convert(
+      phigent::vision::ImageFrame &disparity,
+      phigent::vision::ImageFramePool *pool = nullptr) {
+    if (pool == nullptr) {
+      pool = &phigent::vision::DefaultImageFramePool();
+    }
+    PGPixelFormat format;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      format = config_.unit == DepthUnit::kMillimeter ? kPGPixelFormatInt16
+                                                      : kPGPixelFormatFloat32;
+    }
+    auto depth = pool->Acquire(format, disparity.Width(), disparity.Height());
+    if (!depth || Convert(disparity, depth.get()) != 0) {
+      return nullptr;
+    }
+    return depth;
+  }
+
+  /**
+   * @brief  视差帧转深度帧并生成置信度帧，输出帧来自缓存池
+   * @param  disparity: 视差帧
+   * @param  *left: 可为空，校正后的左图（亮度平面），用于纹理项
+   * @param  *confidence: [out] kPGPixelFormatUint8 置信度帧，与视差同尺寸
+   * @param  pool: 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+   * @retval 深度帧；失败返回 nullptr，*confidence 置空
+   */
+  phigent::vision::ImageFramePtr Convert(
+      phigent::vision::ImageFrame &disparity, phigent::vision::ImageFrame *left,
+      phigent::vision::ImageFramePtr *confidence,
+      phigent::vision::ImageFramePool *pool = nullptr) {
+    if (pool == nullptr) {
+      pool = &phigent::vision::DefaultImageFramePool();
+    }
+    PGPixelFormat format;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      format = config_.unit == DepthUnit::kMillimeter ? kPGPixelFormatInt16
+                                                      : kPGPixelFormatFloat32;
+    }
+    auto depth = pool->Acquire(format, disparity.Width(), disparity.Height());
+    auto map = pool->Acquire(kPGPixelFormatUint8, disparity.Width(),
+                             disparity.Height());
+    if (!depth || !map ||
+        Convert(disparity, left, depth.get(), map.get()) != 0) {
+      confidence->reset();
+      return nullptr;
+    }
+    *confidence = map;
+    return depth;
+  }
+
+  /**
+   * @brief  视差帧转深度帧，写入调用方提供的帧
+   * @param  disparity: 视差帧
+   * @param  *depth: [out] 与视差同尺寸，格式与 DepthConverterConfig::unit
+   * 一致的连续帧
+   * @retval 0 成功，-1 未初始化，-2 视差格式不支持，-3 输出帧不匹配
+   */
+  int Convert(phigent::vision::ImageFrame &disparity,
+              phigent::vision::ImageFrame *depth) {
+    return Convert(disparity, nullptr, depth, nullptr);
+  }
+
+  /**
+   * @brief  视差帧转深度帧并生成置信度，写入调用方提供的帧
+   * @note   置信度 0 ~ 255，为纹理、视差梯度、时域稳定性三项之积（见
+   * ConfidenceConfig）。深度输出 0 的点（视差无效、不大于 min_disparity、
+   * 深度超过 max_depth_m 或置信度低于 min_confidence）置信度也为 0。
+   * 时域项按 channel_id 保存上一帧视差，同一通道的帧应按顺序调用；
+   * 置信度帧的 channel_id 见
+   * ConfidenceConfig::channel_id，可直接追加到 VidarData::images
+   * @param  disparity: 视差帧
+   * @param  *left: 可为空，校正后的左图，kPGPixelFormatRawGRAY/Uint8/NV12/
+   * NV21/I420/YV12，尺寸与视差不同时按比例采样；为空时不计纹理项
+   * @param  *depth: [out] 与视差同尺寸，格式与 DepthConverterConfig::unit
+   * 一致的连续帧
+   * @param  *confidence: [out] 可为空，与视差同尺寸的 kPGPixelFormatUint8
+   * 帧；为空时只转换深度
+   * @retval 0 成功，-1 未初始化，-2 视差或左图格式不支持，-3 输出帧不匹配
+   */
+  int Convert(phigent::vision::ImageFrame &disparity,
+              phigent::vision::ImageFrame *left,
+              phigent::vision::ImageFrame *depth,
+              phigent::vision::ImageFrame *confidence) {
+    detail::DepthParams params;
+    DepthUnit unit;
+    ConfidenceConfig confidence_config;
+    std::shared_ptr<utils::ThreadPool> pool;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      params = params_;
+      unit = config_.unit;
+      confidence_config = config_.confidence;
+      pool = pool_;
+    }
+    if (params.fb <= 0) {
+      return -1;
+    }
+    PGPixelFormat src_format = disparity.pixel_format;
+    size_t src_elem = detail::DisparityElemSize(src_format);
+    if (src_elem == 0 || disparity.Data() == nullptr) {
+      return -2;
+    }
+    bool with_texture = confidence != nullptr && left != nullptr &&
+                        confidence_config.texture_full > 0;
+    if (with_texture &&
+        (!detail::IsGrayLike(left->pixel_format) || left->Data() == nullptr ||
+         left->Width() == 0 || left->Height() == 0)) {
+      return -2;
+    }
+    bool mm = unit == DepthUnit::kMillimeter;
+    PGPixelFormat dst_format = mm ? kPGPixelFormatInt16 : kPGPixelFormatFloat32;
+    int width = static_cast<int>(disparity.Width());
+    int height = static_cast<int>(disparity.Height());
+    if (depth == nullptr || depth->Data() == nullptr ||
+        depth->pixel_format != dst_format ||
+        depth->Width() != disparity.Width() ||
+        depth->Height() != disparity.Height()) {
+      return -3;
+    }
+    if (confidence != nullptr &&
+        (confidence->Data() == nullptr ||
+         confidence->pixel_format != kPGPixelFormatUint8 ||
+         confidence->Width() != disparity.Width() ||
+         confidence->Height() != disparity.Height())) {
+      return -3;
+    }
+    params.scale = disparity.float_scale;
+    std::shared_ptr<const detail::DepthLut> lut;
+    if (src_format != kPGPixelFormatFloat32) {
+      lut = GetLut(src_format, params);
+    }
+    size_t src_step = phigent::vision::FrameRowStep(
+        disparity.Stride(), disparity.Width(), src_elem);
+    size_t dst_step = phigent::vision::FrameRowStep(
+        depth->Stride(), depth->Width(), mm ? 2 : 4);
+    const uint8_t *src = disparity.Data();
+    uint8_t *dst = depth->Data();
+
+    detail::ConfidenceParams conf_params;
+    uint8_t *conf = nullptr;
+    size_t conf_step = 0;
+    const uint8_t *gray = nullptr;
+    size_t gray_step = 0;
+    float sx = 0;
+    float sy = 0;
+    std::shared_ptr<TemporalState> temporal;
+    std::unique_lock<std::mutex> temporal_lock;
+    if (confidence != nullptr) {
+      conf = confidence->Data();
+      conf_step = phigent::vision::FrameRowStep(confidence->Stride(),
+                                                confidence->Width(), 1);
+      conf_params.inv_gradient = 1.0f / confidence_config.gradient_max;
+      conf_params.unknown = confidence_config.temporal_unknown;
+      if (with_texture) {
+        conf_params.inv_texture = 1.0f / confidence_config.texture_full;
+        gray = left->Data();
+        gray_step =
+            phigent::vision::FrameRowStep(left->Stride(), left->Width(), 1);
+        sx = static_cast<float>(left->Width()) / disparity.Width();
+        sy = static_cast<float>(left->Height()) / disparity.Height();
+      }
+      if (confidence_config.temporal_max_diff > 0) {
+        conf_params.inv_temporal = 1.0f / confidence_config.temporal_max_diff;
+        temporal = GetTemporal(disparity.channel_id);
+        temporal_lock = std::unique_lock<std::mutex>(temporal->mutex);
+        if (temporal->width != width || temporal->height != height) {
+          temporal->width = width;
+          temporal->height = height;
+          temporal->value.assign(static_cast<size_t>(width) * height, 0.0f);
+        }
+      }
+    }
+    int min_confidence = confidence_config.min_confidence;
+
+    auto rows = [&](int begin, int end) {
+      // 置信度需要上下相邻行的像素视差，按分块维护三行的环形缓冲
+      thread_local std::vector<float> disp_buffer;
+      thread_local std::vector<float> texture_buffer;
+      float *ring[3] = {nullptr, nullptr, nullptr};
+      float *texture = nullptr;
+      if (conf != nullptr) {
+        disp_buffer.resize(static_cast<size_t>(width) * 3);
+        for (int i = 0; i < 3; ++i) {
+          ring[i] = disp_buffer.data() + static_cast<size_t>(width) * i;
+        }
+        if (gray != nullptr) {
+          texture_buffer.resize(width);
+          texture = texture_buffer.data();
+        }
+        detail::LoadDisparityRow(src + src_step * std::max(begin - 1, 0),
+                                 src_format, params.scale, params.offset, 0, 1,
+                                 width, ring[0]);
+        detail::LoadDisparityRow(src + src_step * begin, src_format,
+                                 params.scale, params.offset, 0, 1, width,
+                                 ring[1]);
+      }
+      for (int y = begin; y < end; ++y) {
+        const uint8_t *in = src + src_step * y;
+        uint8_t *out = dst + dst_step * y;
+        float *out_f32 = mm ? nullptr : reinterpret_cast<float *>(out);
+        uint16_t *out_u16 = mm ? reinterpret_cast<uint16_t *>(out) : nullptr;
+        if (src_format == kPGPixelFormatFloat32) {
+          detail::FloatDispRow(reinterpret_cast<const float *>(in), params,
+                               out_f32, out_u16, width);
+        } else if (src_format == kPGPixelFormatInt16) {
+          auto *in16 = reinterpret_cast<const int16_t *>(in);
+          if (mm) {
+            detail::LutRow(in16, lut->u16.data(), out_u16, width);
+          } else {
+            detail::LutRow(in16, lut->f32.data(), out_f32, width);
+          }
+        } else {
+          if (mm) {
+            detail::LutRow(in, lut->u16.data(), out_u16, width);
+          } else {
+            detail::LutRow(in, lut->f32.data(), out_f32, width);
+          }
+        }
+        if (conf == nullptr) {
+          continue;
+        }
+        detail::LoadDisparityRow(src + src_step * std::min(y + 1, height - 1),
+                                 src_format, params.scale, params.offset, 0, 1,
+                                 width, ring[2]);
+        if (texture != nullptr) {
+          uint32_t v = std::min(static_cast<uint32_t>(y * sy),
+                                left->Height() - 1);
+          detail::TextureRow(gray, gray_step, left->Width(), left->Height(), sx,
+                             v, width, texture);
+        }
+        float *prev = temporal ? temporal->value.data() +
+                                     static_cast<size_t>(width) * y
+                               : nullptr;
+        uint8_t *conf_row = conf + conf_step * y;
+        detail::ConfidenceRow(ring[0], ring[1], ring[2], texture, prev,
+                              conf_params, conf_row, width);
+        // 低置信度的点剔除深度，深度无效的点置信度也置 0
+        if (mm) {
+          for (int x = 0; x < width; ++x) {
+            if (conf_row[x] < min_confidence) {
+              out_u16[x] = 0;
+            }
+            if (out_u16[x] == 0) {
+              conf_row[x] = 0;
+            }
+          }
+        } else {
+          for (int x = 0; x < width; ++x) {
+            if (conf_row[x] < min_confidence) {
+              out_f32[x] = 0;
+            }
+            if (!(out_f32[x] > 0)) {
+              conf_row[x] = 0;
+            }
+          }
+        }
+        std::rotate(ring, ring + 1, ring + 3);
+      }
+    };
+    pool->ParallelFor(0, height, kRowGrain, rows);
+    depth->channel_id = disparity.channel_id;
+    depth->time_stamp = disparity.time_stamp;
+    depth->frame_id = disparity.frame_id;
+    depth->type = disparity.type;
+    depth->float_scale = mm ? 0.001f : 1.0f;
+    if (confidence != nullptr) {
+      confidence->channel_id =
+          confidence_config.channel_id < 0
+              ? disparity.channel_id
+              : static_cast<uint32_t>(confidence_config.channel_id);
+      confidence->time_stamp = disparity.time_stamp;
+      confidence->frame_id = disparity.frame_id;
+      confidence->type = disparity.type;
+      confidence->float_scale = 1.0f / 255;
+    }
+    return 0;
+  }
+
+ private:
+  /// 每个分块最少行数
+  static constexpr int kRowGrain = 16;
+
+  /// 按通道保存的上一帧像素视差
+  struct TemporalState {
+    std::mutex mutex;
+    int width = 0;
+    int height = 0;
+    std::vector<float> value;
+  };
+
+  std::shared_ptr<TemporalState> GetTemporal(uint32_t channel_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<TemporalState> &state = temporal_[channel_id];
+    if (!state) {
+      state = std::make_shared<TemporalState>();
+    }
+    return state;
+  }
+
+  std::shared_ptr<const detail::DepthLut> GetLut(
+      PGPixelFormat format, const detail::DepthParams &params) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (lut_ && lut_->format == format && lut_->scale == params.scale) {
+      return lut_;
+    }
+    auto lut = std::make_shared<detail::DepthLut>();
+    lut->format = format;
+    lut->scale = params.scale;
+    bool mm = config_.unit == DepthUnit::kMillimeter;
+    size_t size = format == kPGPixelFormatInt16 ? 65536 : 256;
+    if (mm) {
+      lut->u16.resize(size);
+    } else {
+      lut->f32.resize(size);
+    }
+    for (size_t i = 0; i < size; ++i) {
+      // int16 视差按有符号解释，负值视为无效
+      float raw = format == kPGPixelFormatInt16
+                      ? static_cast<float>(static_cast<int16_t>(i))
+                      : static_cast<float>(i);
+      float depth = detail::DisparityToDepth(raw, params);
+      if (mm) {
+        lut->u16[i] = detail::DepthToU16(depth);
+      } else {
+        lut->f32[i] = depth;
+      }
+    }
+    lut_ = lut;
+    return lut_;
+  }
+
+  mutable std::mutex mutex_;
+  DepthConverterConfig config_;
+  detail::DepthParams params_;
+  std::shared_ptr<const detail::DepthLut> lut_;
+  std::shared_ptr<utils::ThreadPool> pool_;
+  std::map<uint32_t, std::shared_ptr<TemporalState>> temporal_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_DEPTH_HPP_
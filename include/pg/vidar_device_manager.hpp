@@ -0,0 +1,591 @@
+/**
+ * @file vidar_device_manager.hpp
+ * @brief 多台视觉雷达的枚举、并行打开与接收
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_DEVICE_MANAGER_HPP_
+#define PG_VIDAR_DEVICE_MANAGER_HPP_
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pg/utils/dispatch_queue.hpp"
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/thread_util.hpp"
+#include "pg/vidar_backend.hpp"
+#include "pg/vidar_calibration.hpp"
+#include "pg/vidar_calibration_cache.hpp"
+#include "pg/vidar_clock_sync.hpp"
+#include "pg/vidar_dispatcher.hpp"
+#include "pg/vidar_imu.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief sysfs 中的一个 USB 设备
+ */
+struct UsbDeviceInfo {
+  /// sysfs 设备名，即总线-端口路径，如 "2-1.3"
+  std::string name;
+  int vendor_id = 0;
+  int product_id = 0;
+  int bus = 0;
+  int address = 0;
+  /// 协商速率，Mbps
+  int speed_mbps = 0;
+  /// USB 描述符中的序列号，没有时为空
+  std::string serial;
+  std::string product;
+};
+
+namespace detail {
+
+/// 读取 sysfs 属性文件的第一行
+inline std::string ReadSysfsAttr(const std::string &path) {
+  FILE *fd = fopen(path.c_str(), "r");
+  if (fd == nullptr) {
+    return "";
+  }
+  char buf[256] = {0};
+  if (fgets(buf, sizeof(buf), fd) == nullptr) {
+    buf[0] = '\0';
+  }
+  fclose(fd);
+  std::string value(buf);
+  while (!value.empty() && (value.back() == '\n' || value.back() == ' ')) {
+    value.pop_back();
+  }
+  return value;
+}
+
+}  // namespace detail
+
+/**
+ * @brief  从 sysfs 枚举已连接的 USB 设备，按总线号、端口路径排序
+ * @param  vendor_id: 厂商 id，<0 表示不过滤
+ * @param  product_id: 产品 id，<0 表示不过滤
+ * @param  *devices: [out] 设备列表
+ * @param  sysfs_root: USB 设备目录
+ * @retval 0 成功，-1 无法读取 sysfs
+ */
+inline int EnumerateUsbDevices(
+    int vendor_id, int product_id, std::vector<UsbDeviceInfo> *devices,
+    const std::string &sysfs_root = "/sys/bus/usb/devices") {
+  devices->clear();
+  DIR *dir = opendir(sysfs_root.c_str());
+  if (dir == nullptr) {
+    return -1;
+  }
+  while (struct dirent *entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    // 跳过 "."、接口节点 "2-1:1.0" 与根集线器 "usb2"
+    if (name.empty() || name[0] == '.' ||
+        name.find(':') != std::string::npos || name.compare(0, 3, "usb") == 0) {
+      continue;
+    }
+    std::string base = sysfs_root + "/" + name + "/";
+    std::string vid = detail::ReadSysfsAttr(base + "idVendor");
+    std::string pid = detail::ReadSysfsAttr(base + "idProduct");
+    if (vid.empty() || pid.empty()) {
+      continue;
+    }
+    UsbDeviceInfo info;
+    info.name = name;
+    info.vendor_id = static_cast<int>(strtol(vid.c_str(), nullptr, 16));
+    info.product_id = static_cast<int>(strtol(pid.c_str(), nullptr, 16));
+    if ((vendor_id >= 0 && info.vendor_id != vendor_id) ||
+        (product_id >= 0 && info.product_id != product_id)) {
+      continue;
+    }
+    info.bus = atoi(detail::ReadSysfsAttr(base + "busnum").c_str());
+    info.address = atoi(detail::ReadSysfsAttr(base + "devnum").c_str());
+    info.speed_mbps = atoi(detail::ReadSysfsAttr(base + "speed").c_str());
+    info.serial = detail::ReadSysfsAttr(base + "serial");
+    info.product = detail::ReadSysfsAttr(base + "product");
+    devices->push_back(info);
+  }
+  closedir(dir);
+  std::sort(devices->begin(), devices->end(),
+            [](const UsbDeviceInfo &a, const UsbDeviceInfo &b) {
+              return a.bus != b.bus ? a.bus < b.bus : a.name < b.name;
+            });
+  return 0;
+}
+
+/**
+ * @brief  读取 Init 配置中 IComConfig.usb_host 的厂商与产品 id
+ * @retval 0 成功，-1 json 无效或没有 usb_host
+ */
+inline int ParseUsbHostIds(const std::string &conf_json, int *vendor_id,
+                           int *product_id) {
+  cv::FileStorage fs;
+  if (utils::json::Open(conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode usb_host = fs["IComConfig"]["usb_host"];
+  if (usb_host.empty()) {
+    return -1;
+  }
+  *vendor_id = utils::json::GetInt(usb_host["dev_vendor_id"], -1);
+  *product_id = utils::json::GetInt(usb_host["dev_product_id"], -1);
+  return 0;
+}
+
+/**
+ * @brief 单台设备的打开参数
+ */
+struct VidarDeviceConfig {
+  /// CreateVidarInterface 的类型名
+  std::string type = "default";
+  /// 自定义创建函数，非空时代替 CreateVidarInterface，返回的对象由管理器释放
+  std::function<VidarInterface *()> create;
+  /// Init 配置 json
+  std::string conf_json;
+  /// GetConfig 请求 json，用于读取序列号与标定，为空时不读取
+  std::string flow_json;
+  /// 预期的模组序列号，作为标定缓存的键，为空时只在读取标定后写入缓存
+  std::string serial;
+  /// 接收线程绑定的 CPU，为空时不绑定
+  std::vector<int> cpus;
+  /// RecvData 返回的 imu 记录的编码方式
+  ImuFormat imu_format = ImuFormat::kText;
+};
+
+/**
+ * @brief 数据交付方式
+ */
+enum class DeviceDelivery {
+  /// 每台设备一个队列，通过 Recv 读取
+  kPerDevice = 0,
+  /// 所有设备按主机时间排序合并，通过 RecvMerged 读取
+  kMerged,
+};
+
+/**
+ * @brief 多设备管理参数
+ */
+struct DeviceManagerConfig {
+  DeviceDelivery delivery = DeviceDelivery::kPerDevice;
+  /// kPerDevice 时为每台设备的队列；kMerged 时容量为 depth * 设备数，
+  /// 满时丢弃最早的数据，policy 不生效
+  QueueConfig queue{32, utils::QueuePolicy::kDropOldest};
+  /// kMerged 时的乱序等待时间，数据在主机时间之后至少等待该时长再交付
+  int reorder_ms = 20;
+  /// 接收线程每次 RecvData 的等待时间
+  int recv_timeout_ms = 100;
+  /// 是否交付 IMU 数据
+  bool deliver_imu = true;
+  /// 是否并发 Init，SDK 不支持多实例并发初始化时置为 false
+  bool parallel_open = true;
+  /// GetConfig 失败时的重试次数
+  int get_config_retries = 10;
+  /// 标定缓存目录，为空时不使用缓存，见 CalibrationCache
+  std::string calib_cache_dir;
+};
+
+/**
+ * @brief 交付给调用者的一条数据，图像帧或 IMU
+ */
+struct DeviceItem {
+  /// 设备下标，与 Open 传入的顺序一致
+  int device = -1;
+  /// 由该设备的 ClockSynchronizer 换算的主机单调时钟，ns
+  uint64_t host_ns = 0;
+  /// 接收线程收到该数据时的主机单调时钟，ns
+  uint64_t arrival_ns = 0;
+  /// 图像帧，IMU 数据时为空
+  phigent::vision::ImageFramePtr frame;
+  /// frame 为空时有效
+  ImuSample imu;
+};
+
+/**
+ * @brief 单台设备的状态
+ */
+struct DeviceStatus {
+  /// Init 的返回值，<0 时该设备不参与接收
+  int init_status = -1;
+  /// GetConfig 与解析的返回值，未请求时为 1
+  int config_status = 1;
+  /// Init 与 GetConfig 耗时，毫秒
+  double open_ms = 0;
+  /// GetConfig 返回的序列号、产品号与标定
+  StereoCalibration camera;
+  /// 标定是否来自缓存
+  bool calib_cached = false;
+  uint64_t received_frames = 0;
+  uint64_t received_imu = 0;
+  /// 队列满丢弃的数量
+  uint64_t dropped = 0;
+  uint64_t recv_errors = 0;
+  ClockSyncState clock;
+};
+
+/**
+ * @brief 管理多台视觉雷达：并发打开，每台设备一个接收线程，按设备或
+ * 按时间合并交付
+ * @note 每台设备的时间戳先由各自的 ClockSynchronizer 换算为主机单调时钟，
+ * 合并流按换算后的时间排序，不同设备的设备时钟无需一致。kPerDevice 的
+ * 队列无锁；kMerged 为一个加锁的最小堆，入堆与出堆为 O(log n)。
+ * Open/Start/Stop/Close 不是线程安全的，应在同一线程调用；Recv 与
+ * RecvMerged 可在任意线程调用。
+ */
+class VidarDeviceManager {
+ public:
+  VidarDeviceManager() = default;
+  ~VidarDeviceManager() { Close(); }
+
+  VidarDeviceManager(const VidarDeviceManager &) = delete;
+  VidarDeviceManager &operator=(const VidarDeviceManager &) = delete;
+
+  /**
+   * @brief  创建并初始化所有设备，读取序列号与标定
+   * @param  &devices: 每台设备的配置
+   * @param  &config: 管理参数
+   * @retval 0 全部成功，-1 部分设备失败（见 GetStatus），-2 参数无效或已打开
+   */
+  int Open(const std::vector<VidarDeviceConfig> &devices,
+           const DeviceManagerConfig &config = DeviceManagerConfig()) {
+    if (devices.empty() || !devices_.empty() || config.queue.depth == 0) {
+      return -2;
+    }
+    config_ = config;
+    for (size_t i = 0; i < devices.size(); ++i) {
+      std::unique_ptr<Device> device(new Device());
+      device->config = devices[i];
+      if (config.delivery == DeviceDelivery::kPerDevice) {
+        device->queue.reset(new utils::DispatchQueue<DeviceItem>(
+            config.queue.depth, config.queue.policy));
+      }
+      devices_.push_back(std::move(device));
+    }
+    merged_capacity_ = config.queue.depth * devices.size();
+    merged_.reserve(merged_capacity_);
+    merged_closed_ = false;
+    if (config.parallel_open) {
+      std::vector<std::thread> threads;
+      for (auto &device : devices_) {
+        threads.emplace_back([this, &device] { OpenDevice(device.get()); });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+    } else {
+      for (auto &device : devices_) {
+        OpenDevice(device.get());
+      }
+    }
+    for (auto &device : devices_) {
+      if (device->status.init_status < 0) {
+        return -1;
+      }
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  为每台打开成功的设备启动接收线程
+   * @note   Stop 之后需要 Close 并重新 Open 才能再次启动
+   * @retval 0 成功，-1 未打开、已启动或已停止
+   */
+  int Start() {
+    if (devices_.empty() || running_ || stopped_) {
+      return -1;
+    }
+    running_ = true;
+    for (size_t i = 0; i < devices_.size(); ++i) {
+      Device *device = devices_[i].get();
+      if (device->status.init_status < 0) {
+        continue;
+      }
+      device->thread =
+          std::thread([this, device, i] { RecvLoop(device, i); });
+    }
+    return 0;
+  }
+
+  /// 停止接收线程，已排队的数据仍可读取
+  void Stop() {
+    if (devices_.empty()) {
+      return;
+    }
+    running_ = false;
+    stopped_ = true;
+    // 先关闭队列，唤醒 QueuePolicy::kBlock 下阻塞在 Push 的接收线程
+    for (auto &device : devices_) {
+      if (device->queue) {
+        device->queue->Close();
+      }
+    }
+    for (auto &device : devices_) {
+      if (device->thread.joinable()) {
+        device->thread.join();
+      }
+    }
+    std::lock_guard<std::mutex> lock(merged_mutex_);
+    merged_closed_ = true;
+    merged_cond_.notify_all();
+  }
+
+  /// 停止并释放所有设备
+  void Close() {
+    Stop();
+    for (auto &device : devices_) {
+      if (device->vidar && device->status.init_status >= 0) {
+        device->vidar->Deinit();
+      }
+    }
+    devices_.clear();
+    stopped_ = false;
+    std::lock_guard<std::mutex> lock(merged_mutex_);
+    merged_.clear();
+  }
+
+  size_t Size() const { return devices_.size(); }
+
+  /// 第 i 台设备的数据接口，Start 之后不要再调用其 RecvData
+  VidarInterface *Interface(size_t i) {
+    return i < devices_.size() ? devices_[i]->vidar.get() : nullptr;
+  }
+
+  /**
+   * @brief  获取第 i 台设备的状态
+   * @retval 0 成功，-1 下标无效
+   */
+  int GetStatus(size_t i, DeviceStatus *status) const {
+    if (i >= devices_.size() || status == nullptr) {
+      return -1;
+    }
+    const Device &device = *devices_[i];
+    *status = device.status;
+    status->received_frames = device.received_frames.load();
+    status->received_imu = device.received_imu.load();
+    status->dropped = device.dropped.load();
+    status->recv_errors = device.recv_errors.load();
+    status->clock = device.clock.GetState();
+    return 0;
+  }
+
+  /**
+   * @brief  按 GetConfig 返回的序列号查找设备
+   * @retval 设备下标，不存在时返回 -1
+   */
+  int FindSerial(const std::string &serial) const {
+    for (size_t i = 0; i < devices_.size(); ++i) {
+      if (devices_[i]->status.camera.serial_number == serial) {
+        return static_cast<int>(i);
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief  读取第 device 台设备的下一条数据，kPerDevice 时使用
+   * @retval 0 成功，-1 超时或已停止，-2 下标无效或交付方式不符
+   */
+  int Recv(size_t device, DeviceItem *item, int timeout_ms) {
+    if (device >= devices_.size() || !devices_[device]->queue ||
+        item == nullptr) {
+      return -2;
+    }
+    return devices_[device]->queue->PopFor(item, timeout_ms) ? 0 : -1;
+  }
+
+  /**
+   * @brief  按主机时间顺序读取所有设备的下一条数据，kMerged 时使用
+   * @note   数据在 host_ns + reorder_ms 之后交付；晚于该窗口到达的数据
+   * （如随图像批量上传的 IMU）仍会交付，但可能早于已交付数据的时间
+   * @retval 0 成功，-1 超时或已停止，-2 交付方式不符
+   */
+  int RecvMerged(DeviceItem *item, int timeout_ms) {
+    if (config_.delivery != DeviceDelivery::kMerged || item == nullptr) {
+      return -2;
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::max(timeout_ms, 0));
+    uint64_t reorder_ns = static_cast<uint64_t>(config_.reorder_ms) * 1000000;
+    std::unique_lock<std::mutex> lock(merged_mutex_);
+    while (true) {
+      auto wake = deadline;
+      if (!merged_.empty()) {
+        uint64_t ready_ns = merged_.front().host_ns + reorder_ns;
+        uint64_t now = NowNs();
+        if (merged_closed_ || ready_ns <= now) {
+          std::pop_heap(merged_.begin(), merged_.end(), LaterItem);
+          *item = std::move(merged_.back());
+          merged_.pop_back();
+          return 0;
+        }
+        wake = std::min(wake, std::chrono::steady_clock::now() +
+                                  std::chrono::nanoseconds(ready_ns - now));
+      } else if (merged_closed_) {
+        return -1;
+      }
+      if (std::chrono::steady_clock::now() >= deadline) {
+        return -1;
+      }
+      merged_cond_.wait_until(lock, wake);
+    }
+  }
+
+ private:
+  struct Device {
+    VidarDeviceConfig config;
+    std::unique_ptr<VidarInterface> vidar;
+    DeviceStatus status;
+    ClockSynchronizer clock;
+    std::unique_ptr<utils::DispatchQueue<DeviceItem>> queue;
+    std::thread thread;
+    std::atomic<uint64_t> received_frames{0};
+    std::atomic<uint64_t> received_imu{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<uint64_t> recv_errors{0};
+  };
+
+  static uint64_t NowNs() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /// 最小堆的比较函数
+  static bool LaterItem(const DeviceItem &a, const DeviceItem &b) {
+    return a.host_ns > b.host_ns;
+  }
+
+  void OpenDevice(Device *device) {
+    auto start = std::chrono::steady_clock::now();
+    device->vidar.reset(device->config.create
+                            ? device->config.create()
+                            : CreateVidarInterface(device->config.type));
+    if (!device->vidar) {
+      device->status.init_status = -1;
+      return;
+    }
+    device->status.init_status = device->vidar->Init(device->config.conf_json);
+    if (device->status.init_status >= 0 && !device->config.flow_json.empty()) {
+      std::unique_ptr<CalibrationCache> cache;
+      if (!config_.calib_cache_dir.empty()) {
+        cache.reset(new CalibrationCache(config_.calib_cache_dir));
+      }
+      device->status.config_status = LoadCameraCalibration(
+          device->vidar.get(), device->config.flow_json,
+          config_.get_config_retries, cache.get(), device->config.serial, "",
+          &device->status.camera, &device->status.calib_cached);
+    }
+    device->status.open_ms =
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+  }
+
+  void Deliver(Device *device, DeviceItem *item) {
+    if (device->queue) {
+      if (!device->queue->Push(*item)) {
+        device->dropped.fetch_add(1, std::memory_order_relaxed);
+      }
+      return;
+    }
+    std::lock_guard<std::mutex> lock(merged_mutex_);
+    if (merged_.size() >= merged_capacity_) {
+      // 丢弃最早的数据
+      std::pop_heap(merged_.begin(), merged_.end(), LaterItem);
+      int dropped = merged_.back().device;
+      merged_.pop_back();
+      devices_[dropped]->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    merged_.push_back(std::move(*item));
+    std::push_heap(merged_.begin(), merged_.end(), LaterItem);
+    merged_cond_.notify_one();
+  }
+
+  void RecvLoop(Device *device, size_t index) {
+    utils::SetCurrentThreadName("pg_vidar_rx" + std::to_string(index));
+    utils::SetCurrentThreadAffinity(device->config.cpus);
+    VidarData data;
+    DeviceItem item;
+    while (running_) {
+      auto start = std::chrono::steady_clock::now();
+      int ret = device->vidar->RecvData(&data, config_.recv_timeout_ms);
+      if (ret < 0) {
+        device->recv_errors.fetch_add(1, std::memory_order_relaxed);
+        // 回放结束等立即返回的错误不空转，每个 recv_timeout_ms 最多重试一次
+        auto wait = start + std::chrono::milliseconds(config_.recv_timeout_ms);
+        if (running_ && std::chrono::steady_clock::now() < wait) {
+          std::this_thread::sleep_until(wait);
+        }
+        continue;
+      }
+      uint64_t now = NowNs();
+      for (auto &img : data.images) {
+        if (!img) {
+          continue;
+        }
+        if (img->time_stamp != 0) {
+          device->clock.AddSample(img->time_stamp, now);
+        }
+        item.device = static_cast<int>(index);
+        item.host_ns = device->clock.Synced()
+                           ? device->clock.HostTimeOf(img->time_stamp)
+                           : now;
+        item.arrival_ns = now;
+        item.frame = img;
+        device->received_frames.fetch_add(1, std::memory_order_relaxed);
+        Deliver(device, &item);
+      }
+      if (!config_.deliver_imu) {
+        continue;
+      }
+      item.frame.reset();
+      for (auto &imu : data.imu) {
+        if (ParseImuSample(imu.data(), imu.size(), device->config.imu_format,
+                           &item.imu) != 0) {
+          continue;
+        }
+        item.device = static_cast<int>(index);
+        item.host_ns = device->clock.Synced()
+                           ? device->clock.HostTimeOf(item.imu.time_stamp)
+                           : now;
+        item.arrival_ns = now;
+        device->received_imu.fetch_add(1, std::memory_order_relaxed);
+        Deliver(device, &item);
+      }
+    }
+  }
+
+  DeviceManagerConfig config_;
+  std::vector<std::unique_ptr<Device>> devices_;
+  std::atomic<bool> running_{false};
+  bool stopped_ = false;
+  std::mutex merged_mutex_;
+  std::condition_variable merged_cond_;
+  std::vector<DeviceItem> merged_;
+  size_t merged_capacity_ = 0;
+  bool merged_closed_ = false;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_DEVICE_MANAGER_HPP_
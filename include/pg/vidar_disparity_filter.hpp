@@ -0,0 +1,752 @@
+/**
+ * @file vidar_disparity_filter.hpp
+ * @brief 视差后处理：去斑点、空洞填充、中值滤波与时域滤波合并为一遍
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_DISPARITY_FILTER_HPP_
+#define PG_VIDAR_DISPARITY_FILTER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pg/utils/thread_pool.hpp"
+#include "pg/vidar_depth.hpp"
+#include "vision_type/image_frame_pool.hpp"
+#include "vision_type/simd_dispatch.hpp"
+
+namespace pg {
+namespace vidar {
+
+struct DisparityFilterConfig {
+  /// 连通域不超过该像素数时视为斑点并置为无效，0 表示不去斑点
+  int speckle_size = 100;
+  /// 同一连通域内相邻像素的最大视差差（像素），也用于判断空洞两侧是否连续
+  float speckle_max_diff = 1.0f;
+  /// 水平方向不超过该长度的空洞由两侧插值填充，0 表示不填充
+  int hole_size = 4;
+  /// 3x3 中值滤波，无效邻点以中心值代替，不参与排序
+  bool median = true;
+  /// 时域指数滤波的新值权重，不小于 1 表示不做时域滤波
+  float temporal_alpha = 0.4f;
+  /// 与上一帧结果相差超过该值（像素）时不平滑，直接采用新值
+  float temporal_max_diff = 2.0f;
+  /// 行带的并行度，0 表示 std::thread::hardware_concurrency()
+  int num_threads = 0;
+};
+
+namespace detail {
+
+/// 一行内视差连续的一段有效像素，[x0, x1)
+struct DisparityRun {
+  int x0;
+  int x1;
+  int id;
+};
+
+/// 连通域的并查集，按路径减半查找
+inline int FindRoot(std::vector<int> *parent, int id) {
+  std::vector<int> &p = *parent;
+  while (p[id] != id) {
+    p[id] = p[p[id]];
+    id = p[id];
+  }
+  return id;
+}
+
+inline void UnionRoots(std::vector<int> *parent, std::vector<int> *size,
+                       int a, int b) {
+  a = FindRoot(parent, a);
+  b = FindRoot(parent, b);
+  if (a == b) {
+    return;
+  }
+  if ((*size)[a] > (*size)[b]) {
+    std::swap(a, b);
+  }
+  (*parent)[a] = b;
+  (*size)[b] += (*size)[a];
+}
+
+/**
+ * 把一行拆分为视差连续的段，ids 为每个像素所属段的编号（无效为 -1），
+ * 新段的编号从 parent->size() 开始
+ */
+inline void LabelRow(const int16_t *row, int width, int max_diff,
+                     std::vector<DisparityRun> *runs, std::vector<int> *parent,
+                     std::vector<int> *size, int *ids) {
+  int x = 0;
+  while (x < width) {
+    if (row[x] <= 0) {
+      ids[x++] = -1;
+      continue;
+    }
+    int id = static_cast<int>(parent->size());
+    int x0 = x;
+    ids[x++] = id;
+    while (x < width && row[x] > 0 &&
+           std::abs(row[x] - row[x - 1]) <= max_diff) {
+      ids[x++] = id;
+    }
+    runs->push_back(DisparityRun{x0, x, id});
+    parent->push_back(id);
+    size->push_back(x - x0);
+  }
+}
+
+/// 合并上下相邻且视差连续的像素所在的段
+inline void UnionRows(const int16_t *up, const int *up_ids,
+                      const int16_t *row, const int *ids, int width,
+                      int max_diff, std::vector<int> *parent,
+                      std::vector<int> *size) {
+  int last_a = -1;
+  int last_b = -1;
+  for (int x = 0; x < width; ++x) {
+    int a = ids[x];
+    int b = up_ids[x];
+    if (a < 0 || b < 0 || std::abs(row[x] - up[x]) > max_diff ||
+        (a == last_a && b == last_b)) {
+      continue;
+    }
+    UnionRoots(parent, size, a, b);
+    last_a = a;
+    last_b = b;
+  }
+}
+
+/// 由一行的段还原每个像素的编号，编号加上 offset
+inline void FillRunIds(const DisparityRun *runs, size_t count, int offset,
+                       int width, int *ids) {
+  std::fill_n(ids, width, -1);
+  for (size_t i = 0; i < count; ++i) {
+    std::fill(ids + runs[i].x0, ids + runs[i].x1, runs[i].id + offset);
+  }
+}
+
+/**
+ * 填充一行中两侧均有效、长度不超过 max_hole 的空洞：两侧视差相差不超过
+ * max_diff 时线性插值，否则视为遮挡边界，用较小的（较远的）一侧填充
+ */
+inline void FillHolesRow(int16_t *row, int width, int max_hole,
+                         int max_diff) {
+  int x = 0;
+  while (x < width && row[x] <= 0) {
+    ++x;
+  }
+  while (x < width) {
+    while (x < width && row[x] > 0) {
+      ++x;
+    }
+    int begin = x;
+    while (x < width && row[x] <= 0) {
+      ++x;
+    }
+    int len = x - begin;
+    if (x >= width || len > max_hole) {
+      continue;
+    }
+    int a = row[begin - 1];
+    int b = row[x];
+    if (std::abs(a - b) <= max_diff) {
+      for (int i = 0; i < len; ++i) {
+        row[begin + i] = static_cast<int16_t>(
+            a + std::lround(static_cast<float>(b - a) * (i + 1) / (len + 1)));
+      }
+    } else {
+      std::fill_n(row + begin, len, static_cast<int16_t>(std::min(a, b)));
+    }
+  }
+}
+
+/*
+ * 3x3 中值：无效邻点替换为中心值后，用 19 次比较交换的排序网络取第 5 个，
+ * 中心无效时输出无效。各实现使用相同的网络，结果逐位一致
+ */
+constexpr int kMedian9Network[19][2] = {
+    {1, 2}, {4, 5}, {7, 8}, {0, 1}, {3, 4}, {6, 7}, {1, 2},
+    {4, 5}, {7, 8}, {0, 3}, {5, 8}, {4, 7}, {3, 6}, {1, 4},
+    {2, 5}, {4, 7}, {4, 2}, {6, 4}, {4, 2}};
+
+inline void MedianRowScalar(const int16_t *const *rows, int width, int begin,
+                            int end, int16_t *out) {
+  for (int x = begin; x < end; ++x) {
+    int16_t center = rows[1][x];
+    if (center <= 0) {
+      out[x] = 0;
+      continue;
+    }
+    int16_t p[9];
+    for (int dy = 0; dy < 3; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        int16_t v = rows[dy][std::min(std::max(x + dx, 0), width - 1)];
+        p[dy * 3 + dx + 1] = v > 0 ? v : center;
+      }
+    }
+    for (const auto &pair : kMedian9Network) {
+      int16_t lo = std::min(p[pair[0]], p[pair[1]]);
+      p[pair[1]] = std::max(p[pair[0]], p[pair[1]]);
+      p[pair[0]] = lo;
+    }
+    out[x] = p[4];
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void MedianRowSse41(const int16_t *const *rows,
+                                           int width, int16_t *out) {
+  const __m128i zero = _mm_setzero_si128();
+  int x = 1;
+  MedianRowScalar(rows, width, 0, std::min(1, width), out);
+  for (; x + 9 <= width; x += 8) {
+    __m128i center =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows[1] + x));
+    __m128i p[9];
+    for (int dy = 0; dy < 3; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        __m128i v = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(rows[dy] + x + dx));
+        p[dy * 3 + dx + 1] =
+            _mm_blendv_epi8(center, v, _mm_cmpgt_epi16(v, zero));
+      }
+    }
+    for (const auto &pair : kMedian9Network) {
+      __m128i lo = _mm_min_epi16(p[pair[0]], p[pair[1]]);
+      p[pair[1]] = _mm_max_epi16(p[pair[0]], p[pair[1]]);
+      p[pair[0]] = lo;
+    }
+    __m128i m = _mm_and_si128(p[4], _mm_cmpgt_epi16(center, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), m);
+  }
+  MedianRowScalar(rows, width, std::max(x, std::min(1, width)), width, out);
+}
+
+PG_TARGET_AVX2 inline void MedianRowAvx2(const int16_t *const *rows,
+                                         int width, int16_t *out) {
+  const __m256i zero = _mm256_setzero_si256();
+  int x = 1;
+  MedianRowScalar(rows, width, 0, std::min(1, width), out);
+  for (; x + 17 <= width; x += 16) {
+    __m256i center =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows[1] + x));
+    __m256i p[9];
+    for (int dy = 0; dy < 3; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        __m256i v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(rows[dy] + x + dx));
+        p[dy * 3 + dx + 1] =
+            _mm256_blendv_epi8(center, v, _mm256_cmpgt_epi16(v, zero));
+      }
+    }
+    for (const auto &pair : kMedian9Network) {
+      __m256i lo = _mm256_min_epi16(p[pair[0]], p[pair[1]]);
+      p[pair[1]] = _mm256_max_epi16(p[pair[0]], p[pair[1]]);
+      p[pair[0]] = lo;
+    }
+    __m256i m = _mm256_and_si256(p[4], _mm256_cmpgt_epi16(center, zero));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + x), m);
+  }
+  MedianRowScalar(rows, width, std::max(x, std::min(1, width)), width, out);
+}
+#endif
+
+#if defined(PG_SIMD_NEON)
+inline void MedianRowNeon(const int16_t *const *rows, int width,
+                          int16_t *out) {
+  const int16x8_t zero = vdupq_n_s16(0);
+  int x = 1;
+  MedianRowScalar(rows, width, 0, std::min(1, width), out);
+  for (; x + 9 <= width; x += 8) {
+    int16x8_t center = vld1q_s16(rows[1] + x);
+    int16x8_t p[9];
+    for (int dy = 0; dy < 3; ++dy) {
+      for (int dx = -1; dx <= 1; ++dx) {
+        int16x8_t v = vld1q_s16(rows[dy] + x + dx);
+        p[dy * 3 + dx + 1] = vbslq_s16(vcgtq_s16(v, zero), v, center);
+      }
+    }
+    for (const auto &pair : kMedian9Network) {
+      int16x8_t lo = vminq_s16(p[pair[0]], p[pair[1]]);
+      p[pair[1]] = vmaxq_s16(p[pair[0]], p[pair[1]]);
+      p[pair[0]] = lo;
+    }
+    int16x8_t m = vbslq_s16(vcgtq_s16(center, zero), p[4], zero);
+    vst1q_s16(out + x, m);
+  }
+  MedianRowScalar(rows, width, std::max(x, std::min(1, width)), width, out);
+}
+#endif
+
+/// rows 为上一行、当前行与下一行
+inline void MedianRow(const int16_t *const *rows, int width, int16_t *out) {
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+      MedianRowAvx2(rows, width, out);
+      return;
+    case phigent::vision::SimdLevel::kSse41:
+      MedianRowSse41(rows, width, out);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case phigent::vision::SimdLevel::kNeon:
+      MedianRowNeon(rows, width, out);
+      return;
+#endif
+    default:
+      MedianRowScalar(rows, width, 0, width, out);
+      return;
+  }
+}
+
+/**
+ * 时域指数滤波：state 为上一帧的结果（0 表示无效）。新值无效时输出无效
+ * 并清除状态；状态无效或相差超过 max_diff 时直接采用新值，
+ * 否则 state += alpha * (d - state)
+ */
+inline void TemporalRow(const int16_t *in, float alpha, float max_diff,
+                        float *state, int16_t *out, int width) {
+  for (int x = 0; x < width; ++x) {
+    float d = in[x];
+    float s = state[x];
+    if (d <= 0) {
+      s = 0;
+    } else if (s <= 0 || std::fabs(d - s) > max_diff) {
+      s = d;
+    } else {
+      s += alpha * (d - s);
+    }
+    state[x] = s;
+    out[x] = static_cast<int16_t>(s + 0.5f);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Int16 视差的流式后处理：去斑点、空洞填充、3x3 中值与时域滤波
+ * @note 去斑点需要整帧的连通域，先按行带并行地把每行拆为视差连续的段并在
+ * 行带内合并，再在行带边界合并；之后每个行带只读一遍视差，逐行完成去斑点、
+ * 空洞填充、中值与时域滤波并写出，中间结果只保留 3 行，不再整帧读写。
+ * 等价于依次做 cv::filterSpeckles（newVal 为 0）、水平空洞填充、
+ * 3x3 中值与时域滤波。视差 <= 0 视为无效。时域滤波的状态按 channel_id
+ * 保存，分辨率或 float_scale 变化时重新开始。
+ * Init 之后 Apply 线程安全；同一通道的帧依次处理（内部按通道加锁）。
+ */
+class DisparityFilterChain {
+ public:
+  DisparityFilterChain() = default;
+  DisparityFilterChain(const DisparityFilterChain &) = delete;
+  DisparityFilterChain &operator=(const DisparityFilterChain &) = delete;
+
+  /**
+   * @brief  初始化，同时清除时域滤波的状态
+   * @param  config: 滤波配置
+   * @retval 0 成功，-1 参数无效
+   */
+  int Init(const DisparityFilterConfig &config = DisparityFilterConfig()) {
+    if (config.speckle_size < 0 || config.speckle_max_diff < 0 ||
+        config.hole_size < 0 || !(config.temporal_alpha > 0) ||
+        config.temporal_max_diff < 0) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    ready_ = true;
+    temporal_.clear();
+    int threads = utils::ThreadPool::ResolveNumThreads(config.num_threads);
+    if (!pool_ || pool_->NumThreads() != threads) {
+      pool_.reset(new utils::ThreadPool(config.num_threads));
+    }
+    return 0;
+  }
+
+  /// 是否已初始化
+  bool Ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_;
+  }
+
+  /**
+   * @brief  清除时域滤波的状态
+   * @param  channel_id: 小于 0 表示全部通道
+   */
+  void ResetTemporal(int channel_id = -1) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (channel_id < 0) {
+      temporal_.clear();
+    } else {
+      temporal_.erase(static_cast<uint32_t>(channel_id));
+    }
+  }
+
+  /**
+   * @brief  滤波一帧，输出帧来自缓存池
+   * @param  disparity: kPGPixelFormatInt16 视差帧
+   * @param  pool: 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+   * @retval 滤波后的视差帧，继承 channel_id/time_stamp/frame_id/type 与
+   * float_scale；失败返回 nullptr
+   */
+  phigent::vision::ImageFramePtr Apply(
+      phigent::vision::ImageFrame &disparity,
+      phigent::vision::ImageFramePool *pool = nullptr) {
+    if (pool == nullptr) {
+      pool = &phigent::vision::DefaultImageFramePool();
+    }
+    auto out = pool->Acquire(kPGPixelFormatInt16, disparity.Width(),
+                             disparity.Height());
+    if (!out || Apply(disparity, out.get()) != 0) {
+      return nullptr;
+    }
+    return out;
+  }
+
+  /**
+   * @brief  滤波一帧，写入调用方提供的帧
+   * @param  disparity: kPGPixelFormatInt16 视差帧
+   * @param  *out: [out] 同尺寸的 kPGPixelFormatInt16 帧，不能与输入共用内存
+   * @retval 0 成功，-1 未初始化，-2 视差格式不支持，-3 输出帧不匹配
+   */
+  int Apply(phigent::vision::ImageFrame &disparity,
+            phigent::vision::ImageFrame *out) {
+    DisparityFilterConfig config;
+    std::shared_ptr<utils::ThreadPool> pool;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      config = config_;
+      pool = pool_;
+      if (!ready_) {
+        return -1;
+      }
+    }
+    if (disparity.pixel_format != kPGPixelFormatInt16 ||
+        disparity.Data() == nullptr || disparity.Width() == 0 ||
+        disparity.Height() == 0) {
+      return -2;
+    }
+    if (out == nullptr || out->Data() == nullptr ||
+        out->pixel_format != kPGPixelFormatInt16 ||
+        out->Width() != disparity.Width() ||
+        out->Height() != disparity.Height() ||
+        out->Data() == disparity.Data()) {
+      return -3;
+    }
+    Frame frame;
+    frame.width = static_cast<int>(disparity.Width());
+    frame.height = static_cast<int>(disparity.Height());
+    frame.src = disparity.Data();
+    frame.src_step =
+        phigent::vision::FrameRowStep(disparity.Stride(), disparity.Width(), 2);
+    frame.dst = out->Data();
+    frame.dst_step =
+        phigent::vision::FrameRowStep(out->Stride(), out->Width(), 2);
+    // 像素阈值换算为原始值
+    float scale = disparity.float_scale > 0 ? disparity.float_scale : 1.0f;
+    frame.max_diff = static_cast<int>(config.speckle_max_diff / scale);
+    frame.temporal_max_diff = config.temporal_max_diff / scale;
+
+    std::shared_ptr<TemporalState> temporal;
+    std::unique_lock<std::mutex> temporal_lock;
+    if (config.temporal_alpha < 1.0f) {
+      temporal = GetTemporal(disparity.channel_id);
+      temporal_lock = std::unique_lock<std::mutex>(temporal->mutex);
+      size_t points = static_cast<size_t>(frame.width) * frame.height;
+      if (temporal->width != frame.width || temporal->height != frame.height ||
+          temporal->scale != scale) {
+        temporal->width = frame.width;
+        temporal->height = frame.height;
+        temporal->scale = scale;
+        temporal->value.assign(points, 0.0f);
+      }
+      frame.temporal = temporal->value.data();
+    }
+
+    std::unique_ptr<Scratch> scratch = AcquireScratch();
+    int bands = std::max(
+        1, std::min(pool->NumThreads(), frame.height / kRowGrain));
+    scratch->Reset(bands, frame.height);
+    if (config.speckle_size > 0) {
+      auto label = [&](int begin, int end) {
+        for (int b = begin; b < end; ++b) {
+          LabelBand(frame, scratch.get(), b);
+        }
+      };
+      pool->ParallelFor(0, bands, 1, label);
+      MergeBands(frame, config.speckle_size, scratch.get());
+    }
+    auto filter = [&](int begin, int end) {
+      for (int b = begin; b < end; ++b) {
+        FilterBand(config, frame, *scratch, b);
+      }
+    };
+    pool->ParallelFor(0, bands, 1, filter);
+    ReleaseScratch(std::move(scratch));
+    out->channel_id = disparity.channel_id;
+    out->time_stamp = disparity.time_stamp;
+    out->frame_id = disparity.frame_id;
+    out->type = disparity.type;
+    out->float_scale = disparity.float_scale;
+    return 0;
+  }
+
+ private:
+  /// 每个行带最少行数
+  static constexpr int kRowGrain = 16;
+  /// 缓存的临时缓冲数量上限
+  static constexpr size_t kMaxScratch = 4;
+
+  struct Frame {
+    int width = 0;
+    int height = 0;
+    const uint8_t *src = nullptr;
+    size_t src_step = 0;
+    uint8_t *dst = nullptr;
+    size_t dst_step = 0;
+    int max_diff = 0;
+    float temporal_max_diff = 0;
+    float *temporal = nullptr;
+
+    const int16_t *Row(int y) const {
+      return reinterpret_cast<const int16_t *>(src + src_step * y);
+    }
+  };
+
+  /// 一个行带的段与并查集，编号在行带内从 0 开始
+  struct Band {
+    int begin = 0;
+    int end = 0;
+    /// 行带内第 y - begin 行的段为 runs[row_begin[i], row_begin[i + 1])
+    std::vector<detail::DisparityRun> runs;
+    std::vector<uint32_t> row_begin;
+    std::vector<int> parent;
+    std::vector<int> size;
+    /// 全局编号的起点
+    int offset = 0;
+    std::vector<int> ids[2];
+    /// 中值滤波的 3 行输入与输出
+    std::vector<int16_t> rows[3];
+    std::vector<int16_t> median;
+  };
+
+  /// 一次 Apply 的临时缓冲，复用以避免每帧分配
+  struct Scratch {
+    std::vector<Band> bands;
+    /// 全局并查集与每个段是否为斑点
+    std::vector<int> parent;
+    std::vector<int> size;
+    std::vector<uint8_t> speckle;
+    std::vector<int> ids[2];
+
+    void Reset(int count, int height) {
+      bands.resize(count);
+      for (int b = 0; b < count; ++b) {
+        bands[b].begin =
+            static_cast<int>(static_cast<int64_t>(height) * b / count);
+        bands[b].end =
+            static_cast<int>(static_cast<int64_t>(height) * (b + 1) / count);
+        bands[b].runs.clear();
+        bands[b].row_begin.clear();
+        bands[b].parent.clear();
+        bands[b].size.clear();
+      }
+      speckle.clear();
+    }
+
+    /// 第 y 行的段
+    const detail::DisparityRun *RowRuns(int y, size_t *count,
+                                        int *offset) const {
+      for (const Band &band : bands) {
+        if (y >= band.begin && y < band.end) {
+          uint32_t first = band.row_begin[y - band.begin];
+          *count = band.row_begin[y - band.begin + 1] - first;
+          *offset = band.offset;
+          return band.runs.data() + first;
+        }
+      }
+      *count = 0;
+      return nullptr;
+    }
+  };
+
+  /// 按通道保存的时域滤波状态
+  struct TemporalState {
+    std::mutex mutex;
+    int width = 0;
+    int height = 0;
+    float scale = 0;
+    std::vector<float> value;
+  };
+
+  static void LabelBand(const Frame &frame, Scratch *scratch, int b) {
+    Band &band = scratch->bands[b];
+    for (auto &ids : band.ids) {
+      ids.resize(frame.width);
+    }
+    band.row_begin.push_back(0);
+    for (int y = band.begin; y < band.end; ++y) {
+      int *ids = band.ids[y & 1].data();
+      detail::LabelRow(frame.Row(y), frame.width, frame.max_diff, &band.runs,
+                       &band.parent, &band.size, ids);
+      if (y > band.begin) {
+        detail::UnionRows(frame.Row(y - 1), band.ids[(y & 1) ^ 1].data(),
+                          frame.Row(y), ids, frame.width, frame.max_diff,
+                          &band.parent, &band.size);
+      }
+      band.row_begin.push_back(static_cast<uint32_t>(band.runs.size()));
+    }
+  }
+
+  /// 合并各行带的并查集与行带边界，标记不超过 speckle_size 的连通域
+  static void MergeBands(const Frame &frame, int speckle_size,
+                         Scratch *scratch) {
+    std::vector<int> &parent = scratch->parent;
+    std::vector<int> &size = scratch->size;
+    parent.clear();
+    size.clear();
+    for (Band &band : scratch->bands) {
+      band.offset = static_cast<int>(parent.size());
+      for (int p : band.parent) {
+        parent.push_back(p + band.offset);
+      }
+      size.insert(size.end(), band.size.begin(), band.size.end());
+    }
+    for (auto &ids : scratch->ids) {
+      ids.resize(frame.width);
+    }
+    for (size_t b = 1; b < scratch->bands.size(); ++b) {
+      int y = scratch->bands[b].begin;
+      size_t count = 0;
+      int offset = 0;
+      const detail::DisparityRun *runs = scratch->RowRuns(y - 1, &count,
+                                                          &offset);
+      detail::FillRunIds(runs, count, offset, frame.width,
+                         scratch->ids[0].data());
+      runs = scratch->RowRuns(y, &count, &offset);
+      detail::FillRunIds(runs, count, offset, frame.width,
+                         scratch->ids[1].data());
+      detail::UnionRows(frame.Row(y - 1), scratch->ids[0].data(),
+                        frame.Row(y), scratch->ids[1].data(), frame.width,
+                        frame.max_diff, &parent, &size);
+    }
+    scratch->speckle.resize(parent.size());
+    for (size_t i = 0; i < parent.size(); ++i) {
+      int root = detail::FindRoot(&parent, static_cast<int>(i));
+      scratch->speckle[i] = size[root] <= speckle_size ? 1 : 0;
+    }
+  }
+
+  /// 第 y 行去斑点与空洞填充的结果
+  static void CleanRow(const DisparityFilterConfig &config,
+                       const Frame &frame, const Scratch &scratch, int y,
+                       int16_t *out) {
+    memcpy(out, frame.Row(y), frame.width * sizeof(int16_t));
+    if (config.speckle_size > 0) {
+      size_t count = 0;
+      int offset = 0;
+      const detail::DisparityRun *runs = scratch.RowRuns(y, &count, &offset);
+      for (size_t i = 0; i < count; ++i) {
+        if (scratch.speckle[runs[i].id + offset]) {
+          std::fill(out + runs[i].x0, out + runs[i].x1, 0);
+        }
+      }
+    }
+    if (config.hole_size > 0) {
+      detail::FillHolesRow(out, frame.width, config.hole_size,
+                           frame.max_diff);
+    }
+  }
+
+  static void FilterBand(const DisparityFilterConfig &config,
+                         const Frame &frame, Scratch &scratch, int b) {
+    Band &band = scratch.bands[b];
+    int width = frame.width;
+    for (auto &row : band.rows) {
+      row.resize(width);
+    }
+    band.median.resize(width);
+    // 第 y 行去斑点与填充后的结果在 rows[y % 3]
+    auto row = [&](int y) { return band.rows[y % 3].data(); };
+    auto finish = [&](int y, const int16_t *result) {
+      int16_t *dst =
+          reinterpret_cast<int16_t *>(frame.dst + frame.dst_step * y);
+      if (frame.temporal != nullptr) {
+        detail::TemporalRow(result, config.temporal_alpha,
+                            frame.temporal_max_diff,
+                            frame.temporal + static_cast<size_t>(y) * width,
+                            dst, width);
+      } else {
+        memcpy(dst, result, width * sizeof(int16_t));
+      }
+    };
+    if (!config.median) {
+      for (int y = band.begin; y < band.end; ++y) {
+        CleanRow(config, frame, scratch, y, row(y));
+        finish(y, row(y));
+      }
+      return;
+    }
+    for (int y = std::max(band.begin - 1, 0); y <= band.begin; ++y) {
+      CleanRow(config, frame, scratch, y, row(y));
+    }
+    for (int y = band.begin; y < band.end; ++y) {
+      bool last = y + 1 >= frame.height;
+      if (!last) {
+        CleanRow(config, frame, scratch, y + 1, row(y + 1));
+      }
+      // 越界的行按边界复制
+      const int16_t *rows[3] = {y > 0 ? row(y - 1) : row(y), row(y),
+                                last ? row(y) : row(y + 1)};
+      detail::MedianRow(rows, width, band.median.data());
+      finish(y, band.median.data());
+    }
+  }
+
+  std::shared_ptr<TemporalState> GetTemporal(uint32_t channel_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<TemporalState> &state = temporal_[channel_id];
+    if (!state) {
+      state = std::make_shared<TemporalState>();
+    }
+    return state;
+  }
+
+  std::unique_ptr<Scratch> AcquireScratch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scratch_.empty()) {
+      return std::unique_ptr<Scratch>(new Scratch());
+    }
+    std::unique_ptr<Scratch> scratch = std::move(scratch_.back());
+    scratch_.pop_back();
+    return scratch;
+  }
+
+  void ReleaseScratch(std::unique_ptr<Scratch> scratch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scratch_.size() < kMaxScratch) {
+      scratch_.push_back(std::move(scratch));
+    }
+  }
+
+  mutable std::mutex mutex_;
+  DisparityFilterConfig config_;
+  bool ready_ = false;
+  std::shared_ptr<utils::ThreadPool> pool_;
+  std::map<uint32_t, std::shared_ptr<TemporalState>> temporal_;
+  std::vector<std::unique_ptr<Scratch>> scratch_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_DISPARITY_FILTER_HPP_
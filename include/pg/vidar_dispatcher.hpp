@@ -0,0 +1,993 @@
+/**
+ * @file vidar_dispatcher.hpp
+ * @brief 基于回调的视觉雷达数据分发
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_DISPATCHER_HPP_
+#define PG_VIDAR_DISPATCHER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pg/utils/dispatch_queue.hpp"
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/thread_util.hpp"
+#include "pg/vidar_clock_sync.hpp"
+#include "pg/vidar_imu.hpp"
+#include "pg/vidar_interface.hpp"
+#include "pg/vidar_latency.hpp"
+#include "pg/vidar_stream_config.hpp"
+
+namespace pg {
+namespace vidar {
+
+/// 订阅所有通道
+constexpr int kAllChannels = -1;
+/// 按通道统计接收与丢弃数量的通道号上限
+constexpr uint32_t kMaxStatsChannels = 16;
+
+using FrameCallback =
+    std::function<void(const phigent::vision::ImageFramePtr &frame)>;
+using ImuCallback = std::function<void(const ImuSample &imu)>;
+using ImuRawCallback = std::function<void(const ImuRecord &imu)>;
+
+/**
+ * @brief 单个订阅者的统计信息
+ */
+struct SubscriberStats {
+  /// 已交给回调处理的数量
+  uint64_t delivered = 0;
+  /// 因队列满而丢弃的数量
+  uint64_t dropped = 0;
+  /// 当前排队数量
+  size_t queued = 0;
+};
+
+/**
+ * @brief 订阅者队列配置
+ */
+struct QueueConfig {
+  QueueConfig() = default;
+  QueueConfig(size_t queue_depth, utils::QueuePolicy queue_policy)
+      : depth(queue_depth), policy(queue_policy) {}
+
+  /// 队列长度，向上取整为 2 的幂，kLatestOnly 时忽略
+  size_t depth = 4;
+  utils::QueuePolicy policy = utils::QueuePolicy::kDropOldest;
+};
+
+/**
+ * @brief 单个通道的图像帧统计，丢弃数为该通道所有订阅者之和
+ */
+struct ChannelStats {
+  uint32_t channel_id = 0;
+  /// RecvData 收到的帧数
+  uint64_t received = 0;
+  /// 订阅者队列因策略丢弃的帧数
+  uint64_t dropped = 0;
+  /// 被 UpdateStreamConfig 的通道或帧率筛掉、未投递的帧数
+  uint64_t filtered = 0;
+};
+
+/**
+ * @brief 分发器各线程的 CPU 绑定与调度配置
+ */
+struct DispatcherThreadConfig {
+  /// 接收线程
+  utils::ThreadConfig recv;
+  /// 订阅者回调线程
+  utils::ThreadConfig subscriber;
+  /// 预编译库内部的 USB 传输与组帧线程，见 AdoptSdkThreads
+  utils::ThreadConfig sdk;
+};
+
+namespace detail {
+
+/// 只统计图像帧的回调耗时
+template <typename T>
+inline void RecordCallback(LatencyTracker *, const T &, uint64_t, uint64_t) {}
+
+inline void RecordCallback(LatencyTracker *latency,
+                           const phigent::vision::ImageFramePtr &frame,
+                           uint64_t start_ns, uint64_t end_ns) {
+  latency->OnCallback(*frame, start_ns, end_ns);
+}
+
+template <typename T>
+class SubscriberWorker {
+ public:
+  using Callback = std::function<void(const T &)>;
+
+  /**
+   * @param  *latency: 非空时统计回调耗时，生命周期由分发器管理
+   * @param  thread: 回调线程的 CPU 绑定与调度配置，线程名为 pg_sub<id>
+   */
+  SubscriberWorker(int id, int channel_id, Callback callback,
+                   const QueueConfig &queue, LatencyTracker *latency = nullptr,
+                   const utils::ThreadConfig &thread = utils::ThreadConfig())
+      : id_(id),
+        channel_id_(channel_id),
+        callback_(std::move(callback)),
+        latency_(latency),
+        thread_config_(thread),
+        queue_(queue.depth, queue.policy) {
+    thread_ = std::thread([this] { Run(); });
+  }
+  ~SubscriberWorker() { Stop(); }
+
+  /// 按队列策略入队，返回 false 表示丢弃了一个元素
+  bool Push(const T &item) {
+    if (!queue_.Push(item)) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    return true;
+  }
+
+  void Stop() {
+    queue_.Close();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+  }
+
+  SubscriberStats Stats() const {
+    SubscriberStats stats;
+    stats.delivered = delivered_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.queued = queue_.Size();
+    return stats;
+  }
+
+  int Id() const { return id_; }
+  int ChannelId() const { return channel_id_; }
+  /// 回调线程的内核线程号，线程尚未运行时为 0
+  int ThreadId() const { return tid_.load(std::memory_order_acquire); }
+  /// ApplyThreadConfig 的返回值
+  int ThreadStatus() const {
+    return thread_status_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  void Run() {
+    utils::SetCurrentThreadName("pg_sub" + std::to_string(id_));
+    if (!thread_config_.Empty()) {
+      thread_status_.store(utils::ApplyThreadConfig(0, thread_config_),
+                           std::memory_order_relaxed);
+    }
+    tid_.store(utils::CurrentThreadId(), std::memory_order_release);
+    T item;
+    while (queue_.Pop(&item)) {
+      if (latency_ == nullptr) {
+        callback_(item);
+      } else {
+        uint64_t start = LatencyTracker::Now();
+        callback_(item);
+        RecordCallback(latency_, item, start, LatencyTracker::Now());
+      }
+      item = T();
+      delivered_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  int id_;
+  int channel_id_;
+  Callback callback_;
+  LatencyTracker *latency_;
+  utils::ThreadConfig thread_config_;
+  utils::DispatchQueue<T> queue_;
+  std::atomic<uint64_t> delivered_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::atomic<int> tid_{0};
+  std::atomic<int> thread_status_{0};
+  std::thread thread_;
+};
+
+}  // namespace detail
+
+/**
+ * @brief  推送式的数据分发：内部接收线程循环调用 RecvData，
+ * 每收到一帧图像或一条IMU数据即投递给已注册的回调
+ * @note   线程约定：
+ * 1. 接收线程只负责入队，不会执行任何回调，入队为 O(1) 且不加锁；
+ * 2. 每个订阅者拥有独立的定长无锁队列和回调线程，同一订阅者的回调串行
+ *    执行，不同订阅者之间并发执行；
+ * 3. 订阅者队列满时按 QueueConfig::policy 处理，默认丢弃最旧的数据并计入
+ *    dropped，慢回调只会影响自身；kBlock 策略会阻塞接收线程，进而使 SDK
+ *    内部缓存积压，只适合不能丢帧的离线处理；
+ *    接收线程复用同一个 VidarData，IMU 以 ImuSample/ImuRecord 定长结构入队，
+ *    不分配内存；
+ * 4. 回调中不能调用本对象的 Unsubscribe/Stop，否则会死锁；
+ * 5. Start 之后不要再在其他线程调用同一 VidarInterface 的 RecvData。
+ * 图像帧的逐帧时间记录与分阶段延迟统计常开，见 GetStats/GetFrameTiming。
+ * 接收线程用图像帧的到达时间在线估计设备时钟到主机时钟的映射，见 ClockSync。
+ * 通道集合、输出类型与帧率可以在运行中切换，见 UpdateStreamConfig。
+ * 接收线程名为 pg_vidar_recv，订阅者线程名为 pg_sub<id>，各线程的 CPU
+ * 绑定与调度策略见 Configure 的 "threads" 字段与 GetThreads。
+ */
+class VidarDispatcher {
+ public:
+  /**
+   * @brief  创建分发器
+   * @param  *vidar: 已 Init 的数据接口，生命周期由调用者管理
+   */
+  explicit VidarDispatcher(VidarInterface *vidar) : vidar_(vidar) {}
+  VidarDispatcher(const VidarDispatcher &) = delete;
+  VidarDispatcher &operator=(const VidarDispatcher &) = delete;
+  ~VidarDispatcher() {
+    Stop();
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    std::atomic_store(&frame_subscribers_, WorkerList<FrameWorker>());
+    std::atomic_store(&imu_subscribers_, WorkerList<ImuWorker>());
+    std::atomic_store(&imu_raw_subscribers_, WorkerList<ImuRawWorker>());
+  }
+
+  /**
+   * @brief  从 json 配置读取订阅者队列配置，只影响之后创建的订阅
+   * @note   读取 "dispatcher" 字段，可与 Init 使用同一份配置，格式为
+   * {
+   *    "dispatcher" :
+   *    {
+   *            "queue_depth" : 4,
+   *            "policy" : "drop_oldest",
+   *            "channels" : [
+   *                    { "channel_id" : 0, "queue_depth" : 1,
+   *                      "policy" : "latest_only" }
+   *            ],
+   *            "imu" : { "queue_depth" : 256, "policy" : "drop_oldest" },
+   *            "threads" : {
+   *                    "recv" : { "cpus" : [2], "sched" : "fifo",
+   *                               "priority" : 50 },
+   *                    "subscriber" : { "cpus" : [4, 5, 6, 7],
+   *                                     "nice" : -5 },
+   *                    "sdk" : { "cpus" : [2, 3], "sched" : "fifo",
+   *                              "priority" : 60 }
+   *            }
+   *    }
+   * }
+   * policy 可选 drop_oldest/drop_newest/block/latest_only；
+   * sched 可选 other/fifo/rr，fifo/rr 须指定 priority（1~99），通常需要
+   * CAP_SYS_NICE。线程配置在 Start、创建订阅与 AdoptSdkThreads 时生效。
+   * 没有 "dispatcher" 字段时保持原配置
+   * @param  conf_json: [in] 配置json字符串
+   * @retval 0 成功，-1 json 无效，-2 配置值无效
+   */
+  int Configure(const std::string &conf_json) {
+    cv::FileStorage fs;
+    if (utils::json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    cv::FileNode node = fs["dispatcher"];
+    if (node.empty()) {
+      return 0;
+    }
+    QueueConfig frame_queue = default_frame_queue_;
+    QueueConfig imu_queue = imu_queue_;
+    DispatcherThreadConfig threads;
+    std::vector<std::pair<int, QueueConfig>> channel_queues;
+    cv::FileNode thread_node = node["threads"];
+    if (ParseQueueConfig(node, &frame_queue) != 0 ||
+        ParseQueueConfig(node["imu"], &imu_queue) != 0 ||
+        ParseThreadConfig(thread_node["recv"], &threads.recv) != 0 ||
+        ParseThreadConfig(thread_node["subscriber"], &threads.subscriber) !=
+            0 ||
+        ParseThreadConfig(thread_node["sdk"], &threads.sdk) != 0) {
+      return -2;
+    }
+    cv::FileNode channels = node["channels"];
+    for (auto it = channels.begin(); it != channels.end(); ++it) {
+      int channel_id = utils::json::GetInt((*it)["channel_id"], -1);
+      QueueConfig queue = frame_queue;
+      if (channel_id < 0 || ParseQueueConfig(*it, &queue) != 0) {
+        return -2;
+      }
+      channel_queues.emplace_back(channel_id, queue);
+    }
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    default_frame_queue_ = frame_queue;
+    imu_queue_ = imu_queue;
+    channel_queues_ = std::move(channel_queues);
+    if (!thread_node.empty()) {
+      thread_config_ = threads;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  把预编译库在 Init 中创建的内部线程纳入管理：按 "threads.sdk"
+   * 配置绑定 CPU、设置调度策略，并命名为 pg_sdk<n>
+   * @note   预编译库不公开其线程，这里以 Init 前后的线程差集识别，
+   * 调用顺序为：
+   *   std::vector<int> before;
+   *   pg::utils::ListThreadIds(&before);
+   *   vidar->Init(conf_json);
+   *   dispatcher.Configure(conf_json);
+   *   dispatcher.AdoptSdkThreads(before);
+   * 期间其他模块新建的线程也会被纳入，应在单线程初始化阶段调用。
+   * @param  before: Init 之前的 ListThreadIds 结果
+   * @retval 0 成功，-1 无法读取线程列表，-2 部分线程设置失败
+   */
+  int AdoptSdkThreads(const std::vector<int> &before) {
+    std::vector<int> now;
+    if (utils::ListThreadIds(&now) != 0) {
+      return -1;
+    }
+    std::vector<int> created;
+    std::set_difference(now.begin(), now.end(), before.begin(), before.end(),
+                        std::back_inserter(created));
+    utils::ThreadConfig config;
+    {
+      std::lock_guard<std::mutex> lock(subscribe_mutex_);
+      config = thread_config_.sdk;
+      sdk_tids_ = created;
+    }
+    int ret = 0;
+    for (size_t i = 0; i < created.size(); ++i) {
+      utils::SetThreadName(created[i], "pg_sdk" + std::to_string(i));
+      if (!config.Empty() &&
+          utils::ApplyThreadConfig(created[i], config) != 0) {
+        ret = -2;
+      }
+    }
+    return ret;
+  }
+
+  /**
+   * @brief  列出接收线程、订阅者线程与 AdoptSdkThreads 纳入的 SDK 线程的
+   * 当前名称、CPU 绑定与调度状态，用于运行时核对线程分布
+   * @note   role 为 recv、frame_sub<id>、imu_sub<id>、imu_raw_sub<id> 或
+   * sdk，已退出的线程不列出
+   * @param  *threads: [out]
+   * @retval 0 成功，-1 参数无效，-2 有线程的配置未能生效（权限不足等）
+   */
+  int GetThreads(std::vector<utils::ThreadInfo> *threads) const {
+    if (threads == nullptr) {
+      return -1;
+    }
+    threads->clear();
+    AddThreadInfo(recv_tid_.load(std::memory_order_acquire), "recv",
+                  threads);
+    AddWorkerThreads(frame_subscribers_, "frame_sub", threads);
+    AddWorkerThreads(imu_subscribers_, "imu_sub", threads);
+    AddWorkerThreads(imu_raw_subscribers_, "imu_raw_sub", threads);
+    std::vector<int> sdk_tids;
+    {
+      std::lock_guard<std::mutex> lock(subscribe_mutex_);
+      sdk_tids = sdk_tids_;
+    }
+    for (int tid : sdk_tids) {
+      AddThreadInfo(tid, "sdk", threads);
+    }
+    bool failed = recv_thread_status_.load(std::memory_order_relaxed) != 0;
+    failed = failed || WorkersFailed(frame_subscribers_) ||
+             WorkersFailed(imu_subscribers_) ||
+             WorkersFailed(imu_raw_subscribers_);
+    return failed ? -2 : 0;
+  }
+
+  /**
+   * @brief  订阅图像帧，队列使用 Configure 中该通道的配置
+   * @param  channel_id: 通道号，kAllChannels 表示订阅全部通道
+   * @param  callback: 回调，在订阅者自己的线程中执行
+   * @param  queue_depth: 订阅者队列长度，0 表示使用配置值
+   * @retval >=0 订阅id，<0 失败
+   */
+  int Subscribe(int channel_id, FrameCallback callback,
+                size_t queue_depth = 0) {
+    QueueConfig queue = FrameQueueConfig(channel_id);
+    if (queue_depth > 0) {
+      queue.depth = queue_depth;
+    }
+    return Subscribe(channel_id, std::move(callback), queue);
+  }
+
+  /**
+   * @brief  订阅图像帧，显式指定队列配置
+   * @retval >=0 订阅id，<0 失败
+   */
+  int Subscribe(int channel_id, FrameCallback callback,
+                const QueueConfig &queue) {
+    return AddWorker(&frame_subscribers_, channel_id, std::move(callback),
+                     queue, &latency_);
+  }
+
+  /**
+   * @brief  订阅解析后的IMU数据
+   * @param  callback: 回调，在订阅者自己的线程中执行
+   * @param  queue_depth: 订阅者队列长度，0 表示使用配置值
+   * @retval >=0 订阅id，<0 失败
+   */
+  int SubscribeImu(ImuCallback callback, size_t queue_depth = 0) {
+    return AddWorker(&imu_subscribers_, kAllChannels, std::move(callback),
+                     ImuQueueConfig(queue_depth));
+  }
+
+  /**
+   * @brief  订阅IMU原始记录，用于调试
+   * @param  callback: 回调，在订阅者自己的线程中执行
+   * @param  queue_depth: 订阅者队列长度，0 表示使用配置值
+   * @retval >=0 订阅id，<0 失败
+   */
+  int SubscribeImuRaw(ImuRawCallback callback, size_t queue_depth = 0) {
+    return AddWorker(&imu_raw_subscribers_, kAllChannels, std::move(callback),
+                     ImuQueueConfig(queue_depth));
+  }
+
+  /**
+   * @brief  取消订阅，返回时该订阅者的回调已执行完毕且不会再被调用
+   * @param  id: Subscribe/SubscribeImu/SubscribeImuRaw 返回的订阅id
+   * @retval 0 成功，否则为错误码
+   */
+  int Unsubscribe(int id) {
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    if (RemoveWorker(&frame_subscribers_, id) == 0 ||
+        RemoveWorker(&imu_subscribers_, id) == 0 ||
+        RemoveWorker(&imu_raw_subscribers_, id) == 0) {
+      return 0;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief  启动接收线程
+   * @param  recv_timeout_ms: 每次 RecvData 的等待时间
+   * @retval 0 成功，否则为错误码
+   */
+  int Start(int recv_timeout_ms = 100) {
+    if (vidar_ == nullptr) {
+      return -1;
+    }
+    bool expected = false;
+    if (!running_.compare_exchange_strong(expected, true)) {
+      return -1;
+    }
+    recv_timeout_ms_ = recv_timeout_ms;
+    {
+      std::lock_guard<std::mutex> lock(subscribe_mutex_);
+      recv_thread_config_ = thread_config_.recv;
+    }
+    recv_thread_ = std::thread([this] { RecvLoop(); });
+    return 0;
+  }
+
+  /**
+   * @brief  停止接收线程，已注册的订阅保持不变
+   * @retval 0 成功，否则为错误码
+   */
+  int Stop() {
+    running_ = false;
+    if (recv_thread_.joinable()) {
+      recv_thread_.join();
+    }
+    recv_tid_.store(0, std::memory_order_release);
+    return 0;
+  }
+
+  /**
+   * @brief  获取订阅者统计信息
+   * @param  id: 订阅id
+   * @param  *stats: [out] 统计信息
+   * @retval 0 成功，否则为错误码
+   */
+  int GetSubscriberStats(int id, SubscriberStats *stats) const {
+    if (stats == nullptr) {
+      return -1;
+    }
+    if (FindStats(frame_subscribers_, id, stats) == 0 ||
+        FindStats(imu_subscribers_, id, stats) == 0 ||
+        FindStats(imu_raw_subscribers_, id, stats) == 0) {
+      return 0;
+    }
+    return -1;
+  }
+
+  /**
+   * @brief  获取各通道的图像帧接收与丢弃数量
+   * @note   只统计通道号小于 kMaxStatsChannels 且收到过数据的通道
+   * @param  *stats: [out] 按通道号排列
+   * @retval 0 成功，否则为错误码
+   */
+  int GetChannelStats(std::vector<ChannelStats> *stats) const {
+    if (stats == nullptr) {
+      return -1;
+    }
+    stats->clear();
+    for (uint32_t i = 0; i < kMaxStatsChannels; ++i) {
+      ChannelStats channel;
+      channel.channel_id = i;
+      channel.received = channel_received_[i].load(std::memory_order_relaxed);
+      channel.dropped = channel_dropped_[i].load(std::memory_order_relaxed);
+      channel.filtered =
+          channel_filtered_[i].load(std::memory_order_relaxed);
+      if (channel.received > 0) {
+        stats->push_back(channel);
+      }
+    }
+    return 0;
+  }
+
+  /// RecvData 返回错误的次数
+  uint64_t RecvErrors() const {
+    return recv_errors_.load(std::memory_order_relaxed);
+  }
+
+  /// 无法解析的IMU记录数
+  uint64_t ImuDecodeErrors() const {
+    return imu_decode_errors_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief  获取图像帧各阶段最近 10 秒的延迟分位数
+   * @param  *stats: [out] 统计结果
+   * @retval 0 成功，否则为错误码
+   */
+  int GetStats(LatencyStats *stats) const { return latency_.GetStats(stats); }
+
+  /**
+   * @brief  查询最近一帧的时间记录
+   * @retval 0 成功，-1 已被覆盖或不存在
+   */
+  int GetFrameTiming(uint32_t channel_id, uint64_t frame_id,
+                     FrameTiming *timing) const {
+    return latency_.GetFrameTiming(channel_id, frame_id, timing);
+  }
+
+  /// 延迟统计，可用于设置设备时钟偏移
+  LatencyTracker &Latency() { return latency_; }
+
+  /// 设备时钟到主机单调时钟的映射，HostTimeOf 可在任意线程调用
+  const ClockSynchronizer &ClockSync() const { return clock_sync_; }
+
+  /**
+   * @brief  投递前是否把图像帧与 IMU 的 time_stamp 换算为主机单调时钟
+   * @note   换算会直接修改帧的 time_stamp，原设备时间戳不再保留；
+   * IMU 时间戳须与图像帧同为设备时钟 ns。时钟尚未同步时不换算。
+   * @param  enable: true 使用主机时间，false 保持设备时间（默认）
+   */
+  void SetHostTimestamp(bool enable) {
+    host_timestamp_.store(enable, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief  RecvData 返回的 imu 记录的编码方式，默认为文本
+   * @note   只影响 IMU 解析后的订阅者，原始记录订阅者收到的数据不变
+   */
+  void SetImuFormat(ImuFormat format) {
+    imu_format_.store(format, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief  不中断数据流地切换输出配置，格式见 ParseStreamConfig
+   * @note   新配置先放入待切换缓冲区，由接收线程在两次 RecvData 之间
+   * 整体替换，同一次 RecvData 的帧总是使用同一份配置。
+   * 1. channel_id：在主机端筛选通道，只能从 Init 打开的通道中选择，
+   *    增加 Init 之外的通道仍需重新 Init；
+   * 2. fps：在主机端按时间戳抽帧，不能高于设备帧率；
+   * 3. type：通过 GetConfig 请求板端切换 ORIG/REMAP，板端返回 2（已激活
+   *    且需要重启）时切换失败，整份配置不生效。
+   * 切换结果与新配置下各通道的第一帧 frame_id 见 GetStreamConfigResult /
+   * WaitStreamConfig。未 Start 时在启动后的第一次 RecvData 前生效；
+   * 连续调用时只有最后一份未生效的配置会被应用，被跳过的序号没有结果。
+   * @param  conf_json: [in] 含 "SourceVideoStream" 的 json 字符串
+   * @param  *generation: [out] 可为空，本次配置的序号，从 1 开始递增
+   * @retval 0 成功，-1 json 无效，-2 配置值无效
+   */
+  int UpdateStreamConfig(const std::string &conf_json,
+                         uint64_t *generation = nullptr) {
+    StreamConfig config;
+    int ret = ParseStreamConfig(conf_json, &config);
+    if (ret != 0) {
+      return ret;
+    }
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    staged_stream_ = std::move(config);
+    staged_generation_ = ++stream_generation_;
+    stream_staged_.store(true, std::memory_order_release);
+    if (generation != nullptr) {
+      *generation = staged_generation_;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  最近一次生效或失败的输出配置切换结果
+   * @retval 0 成功，-1 参数无效
+   */
+  int GetStreamConfigResult(StreamConfigResult *result) const {
+    if (result == nullptr) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    *result = stream_result_;
+    return 0;
+  }
+
+  /**
+   * @brief  等待序号不小于 generation 的配置切换完成
+   * @param  generation: UpdateStreamConfig 返回的序号
+   * @param  timeout_ms: 最长等待时间
+   * @param  *result: [out] 可为空，切换结果；first_frame_ids 在新配置下的
+   * 帧到达后才逐个填入
+   * @retval 0 已切换（结果见 result->status），-1 超时
+   */
+  int WaitStreamConfig(uint64_t generation, int timeout_ms,
+                       StreamConfigResult *result = nullptr) {
+    std::unique_lock<std::mutex> lock(stream_mutex_);
+    if (!stream_cond_.wait_for(
+            lock, std::chrono::milliseconds(timeout_ms), [&] {
+              return stream_result_.generation >= generation;
+            })) {
+      return -1;
+    }
+    if (result != nullptr) {
+      *result = stream_result_;
+    }
+    return 0;
+  }
+
+ private:
+  using FrameWorker = detail::SubscriberWorker<phigent::vision::ImageFramePtr>;
+  using ImuWorker = detail::SubscriberWorker<ImuSample>;
+  using ImuRawWorker = detail::SubscriberWorker<ImuRecord>;
+  template <typename Worker>
+  using WorkerList = std::shared_ptr<std::vector<std::shared_ptr<Worker>>>;
+
+  static int ParseQueueConfig(const cv::FileNode &node, QueueConfig *queue) {
+    if (node.empty()) {
+      return 0;
+    }
+    int depth = utils::json::GetInt(node["queue_depth"],
+                                    static_cast<int>(queue->depth));
+    std::string policy = utils::json::GetString(node["policy"], "");
+    if (depth <= 0 ||
+        (!policy.empty() &&
+         utils::ParseQueuePolicy(policy, &queue->policy) != 0)) {
+      return -1;
+    }
+    queue->depth = static_cast<size_t>(depth);
+    return 0;
+  }
+
+  static int ParseThreadConfig(const cv::FileNode &node,
+                               utils::ThreadConfig *thread) {
+    if (node.empty()) {
+      return 0;
+    }
+    utils::ThreadConfig parsed;
+    parsed.cpus = utils::json::GetIntArray(node["cpus"]);
+    parsed.sched = utils::json::GetString(node["sched"], "");
+    parsed.priority = utils::json::GetInt(node["priority"], 0);
+    parsed.set_nice = !node["nice"].empty();
+    parsed.nice = utils::json::GetInt(node["nice"], 0);
+    int policy = 0;
+    bool realtime = parsed.sched == "fifo" || parsed.sched == "rr";
+    if ((!parsed.sched.empty() &&
+         utils::ParseSchedPolicy(parsed.sched, &policy) != 0) ||
+        (realtime && (parsed.priority < 1 || parsed.priority > 99)) ||
+        parsed.nice < -20 || parsed.nice > 19) {
+      return -1;
+    }
+    if (!realtime) {
+      parsed.priority = 0;
+    }
+    for (int cpu : parsed.cpus) {
+      if (cpu < 0 || cpu >= CPU_SETSIZE) {
+        return -1;
+      }
+    }
+    *thread = parsed;
+    return 0;
+  }
+
+  static void AddThreadInfo(int tid, const std::string &role,
+                            std::vector<utils::ThreadInfo> *threads) {
+    utils::ThreadInfo info;
+    if (tid > 0 && utils::GetThreadInfo(tid, &info) == 0) {
+      info.role = role;
+      threads->push_back(info);
+    }
+  }
+
+  template <typename Worker>
+  static void AddWorkerThreads(const WorkerList<Worker> &list,
+                               const std::string &role,
+                               std::vector<utils::ThreadInfo> *threads) {
+    for (auto &worker : *std::atomic_load(&list)) {
+      AddThreadInfo(worker->ThreadId(), role + std::to_string(worker->Id()),
+                    threads);
+    }
+  }
+
+  template <typename Worker>
+  static bool WorkersFailed(const WorkerList<Worker> &list) {
+    for (auto &worker : *std::atomic_load(&list)) {
+      if (worker->ThreadStatus() != 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  QueueConfig FrameQueueConfig(int channel_id) {
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    for (auto &channel : channel_queues_) {
+      if (channel.first == channel_id) {
+        return channel.second;
+      }
+    }
+    return default_frame_queue_;
+  }
+
+  QueueConfig ImuQueueConfig(size_t queue_depth) {
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    QueueConfig queue = imu_queue_;
+    if (queue_depth > 0) {
+      queue.depth = queue_depth;
+    }
+    return queue;
+  }
+
+  template <typename Worker>
+  int AddWorker(WorkerList<Worker> *list, int channel_id,
+                typename Worker::Callback callback, const QueueConfig &queue,
+                LatencyTracker *latency = nullptr) {
+    if (!callback || queue.depth == 0) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(subscribe_mutex_);
+    auto updated = std::make_shared<std::vector<std::shared_ptr<Worker>>>(
+        *std::atomic_load(list));
+    int id = next_id_++;
+    updated->push_back(
+        std::make_shared<Worker>(id, channel_id, std::move(callback), queue,
+                                 latency, thread_config_.subscriber));
+    std::atomic_store(list, WorkerList<Worker>(updated));
+    return id;
+  }
+
+  template <typename Worker>
+  static int RemoveWorker(WorkerList<Worker> *list, int id) {
+    auto current = std::atomic_load(list);
+    auto updated = std::make_shared<std::vector<std::shared_ptr<Worker>>>();
+    std::shared_ptr<Worker> removed;
+    for (auto &worker : *current) {
+      if (worker->Id() == id) {
+        removed = worker;
+      } else {
+        updated->push_back(worker);
+      }
+    }
+    if (!removed) {
+      return -1;
+    }
+    std::atomic_store(list, WorkerList<Worker>(updated));
+    removed->Stop();
+    return 0;
+  }
+
+  template <typename Worker>
+  static int FindStats(const WorkerList<Worker> &list, int id,
+                       SubscriberStats *stats) {
+    for (auto &worker : *std::atomic_load(&list)) {
+      if (worker->Id() == id) {
+        *stats = worker->Stats();
+        return 0;
+      }
+    }
+    return -1;
+  }
+
+  /// 在帧边界应用待切换的输出配置，只在接收线程调用
+  void ApplyStagedStream() {
+    StreamConfig config;
+    uint64_t generation = 0;
+    {
+      std::lock_guard<std::mutex> lock(stream_mutex_);
+      config = std::move(staged_stream_);
+      generation = staged_generation_;
+      stream_staged_.store(false, std::memory_order_relaxed);
+    }
+    int status = 0;
+    if (!config.type.empty() && config.type != stream_type_) {
+      std::string flow_json =
+          "{\"action\": \"GetSourceVideoStream\", \"type\": \"" +
+          config.type + "\"}";
+      std::string return_json;
+      int ret = vidar_->GetConfig(flow_json, return_json);
+      status = ret == 2 ? -1 : (ret < 0 ? -2 : 0);
+    }
+    if (status == 0) {
+      if (!config.type.empty()) {
+        stream_type_ = config.type;
+      }
+      stream_filtering_ = !config.channel_ids.empty() || config.fps > 0;
+      stream_filter_.Reset(config);
+      first_frame_channels_.clear();
+      track_first_frames_ = true;
+    }
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    stream_result_.generation = generation;
+    stream_result_.status = status;
+    stream_result_.applied_ns = LatencyTracker::Now();
+    stream_result_.first_frame_ids.clear();
+    stream_cond_.notify_all();
+  }
+
+  /// 记录新配置下各通道的第一帧，只在接收线程调用
+  void RecordFirstFrame(const phigent::vision::ImageFrame &frame) {
+    for (uint32_t channel_id : first_frame_channels_) {
+      if (channel_id == frame.channel_id) {
+        return;
+      }
+    }
+    first_frame_channels_.push_back(frame.channel_id);
+    std::lock_guard<std::mutex> lock(stream_mutex_);
+    stream_result_.first_frame_ids.emplace_back(frame.channel_id,
+                                                frame.frame_id);
+    stream_cond_.notify_all();
+  }
+
+  void RecvLoop() {
+    utils::SetCurrentThreadName("pg_vidar_recv");
+    recv_thread_status_.store(
+        recv_thread_config_.Empty()
+            ? 0
+            : utils::ApplyThreadConfig(0, recv_thread_config_),
+        std::memory_order_relaxed);
+    recv_tid_.store(utils::CurrentThreadId(), std::memory_order_release);
+    VidarData data;
+    ImuRecord record;
+    ImuSample sample;
+    while (running_) {
+      if (stream_staged_.load(std::memory_order_acquire)) {
+        ApplyStagedStream();
+      }
+      auto start = std::chrono::steady_clock::now();
+      int ret = vidar_->RecvData(&data, recv_timeout_ms_);
+      if (ret < 0) {
+        recv_errors_.fetch_add(1, std::memory_order_relaxed);
+        // 回放结束等立即返回的错误不空转，每个 recv_timeout_ms_ 最多重试一次
+        auto wait = start + std::chrono::milliseconds(recv_timeout_ms_);
+        if (running_ && std::chrono::steady_clock::now() < wait) {
+          std::this_thread::sleep_until(wait);
+        }
+        continue;
+      }
+      uint64_t recv_ns = LatencyTracker::Now();
+      bool host_timestamp =
+          host_timestamp_.load(std::memory_order_relaxed) &&
+          clock_sync_.Synced();
+      auto frame_subscribers = std::atomic_load(&frame_subscribers_);
+      for (auto &img : data.images) {
+        if (!img) {
+          continue;
+        }
+        if (img->time_stamp != 0) {
+          clock_sync_.AddSample(img->time_stamp, recv_ns);
+        }
+        latency_.OnRecv(*img, recv_ns);
+        uint32_t channel_id = img->channel_id;
+        if (channel_id < kMaxStatsChannels) {
+          channel_received_[channel_id].fetch_add(1,
+                                                  std::memory_order_relaxed);
+        }
+        if (stream_filtering_ && !stream_filter_.Accept(*img)) {
+          if (channel_id < kMaxStatsChannels) {
+            channel_filtered_[channel_id].fetch_add(
+                1, std::memory_order_relaxed);
+          }
+          continue;
+        }
+        if (track_first_frames_) {
+          RecordFirstFrame(*img);
+        }
+        if (host_timestamp) {
+          img->time_stamp = clock_sync_.HostTimeOf(img->time_stamp);
+        }
+        uint64_t dropped = 0;
+        for (auto &worker : *frame_subscribers) {
+          if ((worker->ChannelId() == kAllChannels ||
+               static_cast<uint32_t>(worker->ChannelId()) == channel_id) &&
+              !worker->Push(img)) {
+            ++dropped;
+          }
+        }
+        if (channel_id < kMaxStatsChannels && dropped > 0) {
+          channel_dropped_[channel_id].fetch_add(dropped,
+                                                 std::memory_order_relaxed);
+        }
+      }
+      ImuFormat imu_format = imu_format_.load(std::memory_order_relaxed);
+      auto imu_subscribers = std::atomic_load(&imu_subscribers_);
+      auto imu_raw_subscribers = std::atomic_load(&imu_raw_subscribers_);
+      for (auto &imu : data.imu) {
+        if (!imu_raw_subscribers->empty()) {
+          record.Assign(imu.data(), imu.size());
+          for (auto &worker : *imu_raw_subscribers) {
+            worker->Push(record);
+          }
+        }
+        if (imu_subscribers->empty()) {
+          continue;
+        }
+        if (ParseImuSample(imu.data(), imu.size(), imu_format, &sample) !=
+            0) {
+          imu_decode_errors_.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+        if (host_timestamp) {
+          sample.time_stamp = clock_sync_.HostTimeOf(sample.time_stamp);
+        }
+        for (auto &worker : *imu_subscribers) {
+          worker->Push(sample);
+        }
+      }
+    }
+  }
+
+  VidarInterface *vidar_ = nullptr;
+  int recv_timeout_ms_ = 100;
+  std::atomic<bool> running_{false};
+  std::atomic<uint64_t> recv_errors_{0};
+  std::thread recv_thread_;
+  utils::ThreadConfig recv_thread_config_;
+  std::atomic<int> recv_tid_{0};
+  std::atomic<int> recv_thread_status_{0};
+  std::atomic<uint64_t> imu_decode_errors_{0};
+  LatencyTracker latency_;
+  ClockSynchronizer clock_sync_;
+  std::atomic<bool> host_timestamp_{false};
+  std::atomic<ImuFormat> imu_format_{ImuFormat::kText};
+  mutable std::mutex subscribe_mutex_;
+  int next_id_ = 0;
+  QueueConfig default_frame_queue_;
+  QueueConfig imu_queue_{256, utils::QueuePolicy::kDropOldest};
+  std::vector<std::pair<int, QueueConfig>> channel_queues_;
+  DispatcherThreadConfig thread_config_;
+  std::vector<int> sdk_tids_;
+  std::array<std::atomic<uint64_t>, kMaxStatsChannels> channel_received_{};
+  std::array<std::atomic<uint64_t>, kMaxStatsChannels> channel_dropped_{};
+  std::array<std::atomic<uint64_t>, kMaxStatsChannels> channel_filtered_{};
+  // 输出配置：待切换缓冲区由 stream_mutex_ 保护，其余只由接收线程访问
+  mutable std::mutex stream_mutex_;
+  std::condition_variable stream_cond_;
+  std::atomic<bool> stream_staged_{false};
+  StreamConfig staged_stream_;
+  uint64_t staged_generation_ = 0;
+  uint64_t stream_generation_ = 0;
+  StreamConfigResult stream_result_;
+  StreamFilter stream_filter_;
+  bool stream_filtering_ = false;
+  std::string stream_type_;
+  bool track_first_frames_ = false;
+  std::vector<uint32_t> first_frame_channels_;
+  WorkerList<FrameWorker> frame_subscribers_ =
+      std::make_shared<std::vector<std::shared_ptr<FrameWorker>>>();
+  WorkerList<ImuWorker> imu_subscribers_ =
+      std::make_shared<std::vector<std::shared_ptr<ImuWorker>>>();
+  WorkerList<ImuRawWorker> imu_raw_subscribers_ =
+      std::make_shared<std::vector<std::shared_ptr<ImuRawWorker>>>();
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_DISPATCHER_HPP_
@@ -0,0 +1,510 @@
+/**
+ * @file vidar_frame_set.hpp
+ * @brief 按 frame_id/time_stamp 对齐左图、右图、视差图和IMU
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_FRAME_SET_HPP_
+#define PG_VIDAR_FRAME_SET_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/ring_buffer.hpp"
+#include "pg/vidar_imu.hpp"
+#include "pg/vidar_interface.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 同一拍摄时刻的一组数据
+ */
+struct FrameSet {
+  phigent::vision::ImageFramePtr left;
+  phigent::vision::ImageFramePtr right;
+  phigent::vision::ImageFramePtr disparity;
+  /// 上一组之后、本组时间戳之前（含）的IMU数据
+  std::vector<ImuSample> imu;
+  uint64_t frame_id = 0;
+  uint64_t time_stamp = 0;
+  /// 是否包含全部期望的成员
+  bool complete = false;
+
+  void Clear() {
+    left.reset();
+    right.reset();
+    disparity.reset();
+    imu.clear();
+    frame_id = 0;
+    time_stamp = 0;
+    complete = false;
+  }
+};
+
+/**
+ * @brief 成员缺失时的处理策略
+ */
+enum class FrameSetPolicy {
+  /// 更新的一组已齐全时，丢弃更早的不完整组
+  kDrop = 0,
+  /// 更新的一组已齐全时，按原样输出更早的不完整组
+  kPartial = 1,
+  /// 按顺序等待缺失成员，超过 max_wait_ms 后丢弃
+  kWait = 2,
+};
+
+struct FrameSetConfig {
+  /// 各成员对应的通道号，<0 表示不需要该成员
+  int left_channel = 0;
+  int right_channel = 1;
+  int disparity_channel = 2;
+  /// 重排窗口大小，即同时等待的组数
+  size_t window = 8;
+  FrameSetPolicy policy = FrameSetPolicy::kDrop;
+  /// kWait 策略下的最长等待时间
+  int max_wait_ms = 100;
+  /// true 时把 time_stamp 相差不超过 time_stamp_tolerance 的帧分为一组，
+  /// 否则按 frame_id 分组
+  bool match_by_time_stamp = false;
+  uint64_t time_stamp_tolerance = 1000;
+  /// 按 time_stamp 分组时，时间戳比已见过的最大值回退超过该值视为设备时钟
+  /// 重置
+  uint64_t time_stamp_reset = 1000000000;
+  /// 按 frame_id 分组时，frame_id 比已见过的最大值回退超过该值视为重置，
+  /// 至少取 2 * window；回退较少的帧只是迟到，丢弃并计入 LateFrames
+  uint64_t frame_id_reset = 64;
+  /// IMU 缓存容量
+  size_t imu_capacity = 4096;
+  /// RecvData 返回的 imu 记录的编码方式
+  ImuFormat imu_format = ImuFormat::kText;
+};
+
+/**
+ * @brief  从 json 读取 FrameSet 配置，缺省项保持默认值
+ * @param  conf_json: json 字符串
+ * {
+ *    "FrameSet": {
+ *        "left": 0, "right": 1, "disparity": 2,
+ *        "window": 8,
+ *        "policy": "drop",            // drop / partial / wait
+ *        "max_wait_ms": 100,
+ *        "match_by": "frame_id",      // frame_id / time_stamp
+ *        "time_stamp_tolerance": 1000,
+ *        "time_stamp_reset": 1000000000,
+ *        "frame_id_reset": 64
+ *    }
+ * }
+ * @param  *config: [in/out]
+ * @retval 0 成功，否则为错误码
+ */
+inline int ParseFrameSetConfig(const std::string &conf_json,
+                               FrameSetConfig *config) {
+  cv::FileStorage fs;
+  if (utils::json::Open(conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode node = fs["FrameSet"];
+  if (node.empty()) {
+    return 0;
+  }
+  config->left_channel =
+      utils::json::GetInt(node["left"], config->left_channel);
+  config->right_channel =
+      utils::json::GetInt(node["right"], config->right_channel);
+  config->disparity_channel =
+      utils::json::GetInt(node["disparity"], config->disparity_channel);
+  int window =
+      utils::json::GetInt(node["window"], static_cast<int>(config->window));
+  if (window <= 0) {
+    return -1;
+  }
+  config->window = static_cast<size_t>(window);
+  std::string policy = utils::json::GetString(node["policy"], "");
+  if (policy == "drop") {
+    config->policy = FrameSetPolicy::kDrop;
+  } else if (policy == "partial") {
+    config->policy = FrameSetPolicy::kPartial;
+  } else if (policy == "wait") {
+    config->policy = FrameSetPolicy::kWait;
+  } else if (!policy.empty()) {
+    return -1;
+  }
+  config->max_wait_ms =
+      utils::json::GetInt(node["max_wait_ms"], config->max_wait_ms);
+  std::string match_by = utils::json::GetString(node["match_by"], "");
+  if (!match_by.empty()) {
+    config->match_by_time_stamp = (match_by == "time_stamp");
+  }
+  config->time_stamp_tolerance = static_cast<uint64_t>(utils::json::GetDouble(
+      node["time_stamp_tolerance"],
+      static_cast<double>(config->time_stamp_tolerance)));
+  if (config->time_stamp_tolerance == 0) {
+    return -1;
+  }
+  config->time_stamp_reset = static_cast<uint64_t>(utils::json::GetDouble(
+      node["time_stamp_reset"], static_cast<double>(config->time_stamp_reset)));
+  config->frame_id_reset = static_cast<uint64_t>(utils::json::GetDouble(
+      node["frame_id_reset"], static_cast<double>(config->frame_id_reset)));
+  return 0;
+}
+
+/**
+ * @brief 帧对齐器：按 frame_id 分组时按 frame_id % window 直接定位槽位，
+ * 插入为 O(1)；按 time_stamp 分组时在窗口内查找时间差不超过
+ * time_stamp_tolerance 的组，插入为 O(window)
+ * @note frame_id 或 time_stamp 大幅回退（设备重启、计数回绕）时按强制结束
+ * 处理全部待对齐的组后重新开始，计入 Resets。非线程安全
+ */
+class FrameSetMatcher {
+ public:
+  explicit FrameSetMatcher(const FrameSetConfig &config = FrameSetConfig())
+      : config_(config),
+        slots_(config.window > 0 ? config.window : 1),
+        ready_(config.window > 0 ? config.window * 2 : 2) {
+    if (config_.left_channel >= 0) {
+      expected_mask_ |= kLeftBit;
+    }
+    if (config_.right_channel >= 0) {
+      expected_mask_ |= kRightBit;
+    }
+    if (config_.disparity_channel >= 0) {
+      expected_mask_ |= kDisparityBit;
+    }
+    imu_.Reset(config_.imu_capacity);
+    order_.reserve(slots_.size());
+  }
+
+  /// 加入一帧，不属于任何成员通道的帧被忽略
+  void PushFrame(const phigent::vision::ImageFramePtr &frame) {
+    if (!frame) {
+      return;
+    }
+    int bit = MemberBit(frame->channel_id);
+    if (bit == 0) {
+      return;
+    }
+    bool by_time = config_.match_by_time_stamp;
+    uint64_t key = by_time ? frame->time_stamp : frame->frame_id;
+    uint64_t reset =
+        by_time ? config_.time_stamp_reset
+                : std::max<uint64_t>(config_.frame_id_reset, slots_.size() * 2);
+    if (has_key_ && key + reset < newest_key_) {
+      // 设备重启或计数回绕，之前的组不会再有新成员
+      ++resets_;
+      Release(UINT64_MAX, true);
+      has_released_ = false;
+      has_key_ = false;
+    }
+    if (!has_key_ || key > newest_key_) {
+      newest_key_ = key;
+    }
+    has_key_ = true;
+    Slot *found = by_time ? FindByTime(key) : FindById(key);
+    if (found == nullptr) {
+      ++late_frames_;
+      return;
+    }
+    Slot &slot = *found;
+    if (!slot.used) {
+      slot.used = true;
+      slot.key = key;
+      slot.mask = 0;
+      slot.first_seen = Clock::now();
+      slot.set.Clear();
+      slot.set.frame_id = frame->frame_id;
+      slot.set.time_stamp = frame->time_stamp;
+    }
+    slot.mask |= bit;
+    if (bit == kLeftBit) {
+      slot.set.left = frame;
+      slot.set.time_stamp = frame->time_stamp;
+    } else if (bit == kRightBit) {
+      slot.set.right = frame;
+    } else {
+      slot.set.disparity = frame;
+    }
+    if (slot.mask == expected_mask_) {
+      if (config_.policy == FrameSetPolicy::kWait) {
+        ReleaseWaiting();
+      } else {
+        Release(slot.key, false);
+      }
+    }
+  }
+
+  void PushImu(const ImuSample &sample) { imu_.Push(sample); }
+
+  /// kWait 策略下检查等待超时，在没有新数据时也应定期调用
+  void Poll() {
+    if (config_.policy == FrameSetPolicy::kWait) {
+      ReleaseWaiting();
+    }
+  }
+
+  /**
+   * @brief  取出一组已对齐的数据
+   * @param  *set: [out]
+   * @retval true 成功，false 没有可输出的组
+   */
+  bool Pop(FrameSet *set) { return ready_.PopFront(set); }
+
+  /// 被丢弃的组数量，包括不完整的组和未及时 Pop 而被覆盖的组
+  uint64_t DroppedSets() const { return dropped_sets_ + ready_.Overwritten(); }
+  /// 以不完整状态输出的组数量
+  uint64_t PartialSets() const { return partial_sets_; }
+  /// 到达时所属组已输出或已移出窗口的帧数量
+  uint64_t LateFrames() const { return late_frames_; }
+  /// frame_id 或 time_stamp 大幅回退而重新开始的次数
+  uint64_t Resets() const { return resets_; }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  static constexpr int kLeftBit = 1;
+  static constexpr int kRightBit = 2;
+  static constexpr int kDisparityBit = 4;
+
+  struct Slot {
+    bool used = false;
+    uint64_t key = 0;
+    int mask = 0;
+    Clock::time_point first_seen;
+    FrameSet set;
+  };
+
+  int MemberBit(uint32_t channel_id) const {
+    int channel = static_cast<int>(channel_id);
+    if (channel == config_.left_channel) {
+      return kLeftBit;
+    }
+    if (channel == config_.right_channel) {
+      return kRightBit;
+    }
+    if (channel == config_.disparity_channel) {
+      return kDisparityBit;
+    }
+    return 0;
+  }
+
+  /// frame_id 对应的槽位，窗口已满时强制结束最早的组；迟到返回空
+  Slot *FindById(uint64_t key) {
+    if (has_released_ && key <= last_released_key_) {
+      return nullptr;
+    }
+    Slot &slot = slots_[key % slots_.size()];
+    if (slot.used && slot.key != key) {
+      if (key < slot.key) {
+        return nullptr;
+      }
+      Release(slot.key, true);
+    }
+    return &slot;
+  }
+
+  /**
+   * 与 time_stamp 相差不超过 tolerance 的最近的组，没有时取空闲槽位，
+   * 窗口已满时强制结束最早的组；迟到返回空。组的 key 为首个成员的时间戳
+   */
+  Slot *FindByTime(uint64_t time_stamp) {
+    uint64_t tolerance = config_.time_stamp_tolerance;
+    if (has_released_ && time_stamp <= last_released_key_ + tolerance) {
+      return nullptr;
+    }
+    Slot *best = nullptr;
+    uint64_t best_diff = UINT64_MAX;
+    Slot *free_slot = nullptr;
+    Slot *oldest = nullptr;
+    for (auto &slot : slots_) {
+      if (!slot.used) {
+        free_slot = free_slot != nullptr ? free_slot : &slot;
+        continue;
+      }
+      uint64_t diff = slot.key > time_stamp ? slot.key - time_stamp
+                                            : time_stamp - slot.key;
+      if (diff <= tolerance && diff < best_diff) {
+        best = &slot;
+        best_diff = diff;
+      }
+      if (oldest == nullptr || slot.key < oldest->key) {
+        oldest = &slot;
+      }
+    }
+    if (best != nullptr) {
+      return best;
+    }
+    if (free_slot == nullptr) {
+      if (time_stamp < oldest->key) {
+        return nullptr;
+      }
+      Release(oldest->key, true);
+      free_slot = oldest;
+    }
+    return free_slot;
+  }
+
+  /// 按 key 升序收集 key <= up_to 的槽位
+  void CollectOrder(uint64_t up_to) {
+    order_.clear();
+    for (auto &slot : slots_) {
+      if (slot.used && slot.key <= up_to) {
+        order_.push_back(&slot);
+      }
+    }
+    std::sort(order_.begin(), order_.end(),
+              [](const Slot *a, const Slot *b) { return a->key < b->key; });
+  }
+
+  /// 输出 key <= up_to 的所有组，force 时不完整的组也按策略结束
+  void Release(uint64_t up_to, bool force) {
+    CollectOrder(up_to);
+    for (Slot *slot : order_) {
+      bool complete = slot->mask == expected_mask_;
+      if (complete || config_.policy == FrameSetPolicy::kPartial) {
+        Emit(slot, complete);
+      } else if (force || config_.policy == FrameSetPolicy::kDrop) {
+        Discard(slot);
+      }
+    }
+  }
+
+  /// kWait：按顺序输出，遇到未超时的不完整组即停止
+  void ReleaseWaiting() {
+    CollectOrder(UINT64_MAX);
+    auto now = Clock::now();
+    for (Slot *slot : order_) {
+      if (slot->mask == expected_mask_) {
+        Emit(slot, true);
+      } else if (now - slot->first_seen >
+                 std::chrono::milliseconds(config_.max_wait_ms)) {
+        Discard(slot);
+      } else {
+        break;
+      }
+    }
+  }
+
+  void Emit(Slot *slot, bool complete) {
+    FrameSet *out = ready_.PushSlot();
+    out->Clear();
+    std::swap(*out, slot->set);
+    out->complete = complete;
+    while (!imu_.Empty() && imu_.At(0).time_stamp <= out->time_stamp) {
+      ImuSample sample;
+      imu_.PopFront(&sample);
+      out->imu.push_back(sample);
+    }
+    if (!complete) {
+      ++partial_sets_;
+    }
+    Retire(slot);
+  }
+
+  void Discard(Slot *slot) {
+    slot->set.Clear();
+    ++dropped_sets_;
+    Retire(slot);
+  }
+
+  void Retire(Slot *slot) {
+    if (!has_released_ || slot->key > last_released_key_) {
+      last_released_key_ = slot->key;
+    }
+    has_released_ = true;
+    slot->used = false;
+  }
+
+  FrameSetConfig config_;
+  int expected_mask_ = 0;
+  std::vector<Slot> slots_;
+  std::vector<Slot *> order_;
+  utils::RingBuffer<FrameSet> ready_;
+  utils::RingBuffer<ImuSample> imu_;
+  bool has_released_ = false;
+  uint64_t last_released_key_ = 0;
+  bool has_key_ = false;
+  uint64_t newest_key_ = 0;
+  uint64_t resets_ = 0;
+  uint64_t dropped_sets_ = 0;
+  uint64_t partial_sets_ = 0;
+  uint64_t late_frames_ = 0;
+};
+
+/**
+ * @brief 在 RecvData 之上提供 RecvFrameSet
+ */
+class FrameSetReceiver {
+ public:
+  /**
+   * @brief  创建对齐接收器
+   * @param  *vidar: 已 Init 的数据接口，生命周期由调用者管理
+   * @param  config: 对齐配置
+   */
+  explicit FrameSetReceiver(VidarInterface *vidar,
+                            const FrameSetConfig &config = FrameSetConfig())
+      : vidar_(vidar), matcher_(config), imu_format_(config.imu_format) {}
+
+  /**
+   * @brief  接收一组对齐的数据
+   * @param  *set: [out] 对齐结果，可以跨调用复用
+   * @param  timeout_ms: 最长等待时间
+   * @retval 0 成功，否则为错误码
+   */
+  int RecvFrameSet(FrameSet *set, int timeout_ms) {
+    if (vidar_ == nullptr || set == nullptr) {
+      return -1;
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout_ms);
+    while (true) {
+      matcher_.Poll();
+      if (matcher_.Pop(set)) {
+        return 0;
+      }
+      auto remain = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now())
+                        .count();
+      if (remain <= 0) {
+        return -1;
+      }
+      if (vidar_->RecvData(&data_, static_cast<int>(remain)) < 0) {
+        // 回放结束等立即返回的错误不空转，等到超时再返回
+        if (std::chrono::steady_clock::now() < deadline) {
+          std::this_thread::sleep_until(deadline);
+        }
+        continue;
+      }
+      DecodeImu(data_, imu_format_, &imu_samples_);
+      for (auto &sample : imu_samples_) {
+        matcher_.PushImu(sample);
+      }
+      for (auto &img : data_.images) {
+        matcher_.PushFrame(img);
+      }
+    }
+  }
+
+  const FrameSetMatcher &Matcher() const { return matcher_; }
+
+ private:
+  VidarInterface *vidar_ = nullptr;
+  FrameSetMatcher matcher_;
+  ImuFormat imu_format_;
+  VidarData data_;
+  std::vector<ImuSample> imu_samples_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_FRAME_SET_HPP_
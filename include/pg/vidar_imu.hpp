@@ -0,0 +1,220 @@
+/**
+ * @file vidar_imu.hpp
+ * @brief IMU 数据类型及解析
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_IMU_HPP_
+#define PG_VIDAR_IMU_HPP_
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "pg/utils/ring_buffer.hpp"
+#include "pg/vidar_interface.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief IMU 原始数据的定长二进制记录，拷贝时不分配内存
+ */
+struct ImuRecord {
+  static constexpr size_t kMaxSize = 124;
+  uint32_t size = 0;
+  char data[kMaxSize];
+
+  /// 超出 kMaxSize 的部分被截断，返回 -1
+  int Assign(const char *src, size_t len) {
+    int ret = 0;
+    if (len > kMaxSize) {
+      len = kMaxSize;
+      ret = -1;
+    }
+    memcpy(data, src, len);
+    size = static_cast<uint32_t>(len);
+    return ret;
+  }
+  std::string ToString() const { return std::string(data, size); }
+};
+
+/**
+ * @brief 解析后的 IMU 数据
+ */
+struct ImuSample {
+  /// 设备时间戳
+  uint64_t time_stamp;
+  /// 加速度 x/y/z
+  float acc[3];
+  /// 角速度 x/y/z
+  float gyro[3];
+  /// 温度
+  float temp;
+};
+static_assert(std::is_pod<ImuSample>::value, "ImuSample must stay POD");
+
+/// 板端二进制 IMU 记录长度：小端 uint64 时间戳 + 7 个 float32，无填充
+constexpr size_t kImuBinaryRecordSize = 8 + 7 * 4;
+
+/**
+ * @brief IMU 记录的编码方式
+ */
+enum class ImuFormat {
+  /// 文本记录
+  kText = 0,
+  /// 板端二进制记录，长度为 kImuBinaryRecordSize
+  kBinary = 1,
+};
+
+/**
+ * @brief  解析一条 IMU 记录
+ * @note   文本记录依次取出 时间戳、acc[3]、gyro[3]、temp 共8个数值，数值之间
+ * 可以是任意分隔符（空格、逗号、json 键名等），缺少温度时 temp 为 0。紧跟
+ * 在字母、数字或下划线之后的数字属于标识符（如 "acc1"、"imu0"），不作为
+ * 数值；
+ * 编码方式由调用方指定，不按长度猜测。不分配内存。
+ * @param  *data: 原始数据
+ * @param  len: 原始数据长度
+ * @param  format: 记录的编码方式
+ * @param  *sample: [out] 解析结果
+ * @retval 0 成功，否则为错误码
+ */
+inline int ParseImuSample(const char *data, size_t len, ImuFormat format,
+                          ImuSample *sample) {
+  if (data == nullptr || sample == nullptr) {
+    return -1;
+  }
+  if (format == ImuFormat::kBinary) {
+    if (len != kImuBinaryRecordSize) {
+      return -1;
+    }
+    memcpy(&sample->time_stamp, data, 8);
+    memcpy(sample->acc, data + 8, 12);
+    memcpy(sample->gyro, data + 20, 12);
+    memcpy(&sample->temp, data + 32, 4);
+    return 0;
+  }
+  char text[256];
+  if (len >= sizeof(text)) {
+    return -1;
+  }
+  memcpy(text, data, len);
+  text[len] = '\0';
+  float values[7] = {0};
+  int count = 0;
+  const char *p = text;
+  while (*p != '\0' && count < 8) {
+    bool in_word = p > text && (isalnum(static_cast<unsigned char>(p[-1])) ||
+                                p[-1] == '_');
+    bool number_start = (*p >= '0' && *p <= '9') ||
+                        ((*p == '-' || *p == '+' || *p == '.') &&
+                         p[1] >= '0' && p[1] <= '9');
+    if (in_word || !number_start) {
+      ++p;
+      continue;
+    }
+    char *end = nullptr;
+    if (count == 0) {
+      sample->time_stamp = strtoull(p, &end, 10);
+      // 跳过时间戳可能带的小数部分
+      while (*end == '.' || (*end >= '0' && *end <= '9')) {
+        ++end;
+      }
+    } else {
+      values[count - 1] = strtof(p, &end);
+    }
+    if (end == p) {
+      ++p;
+      continue;
+    }
+    p = end;
+    ++count;
+  }
+  if (count < 7) {
+    return -1;
+  }
+  memcpy(sample->acc, values, sizeof(sample->acc));
+  memcpy(sample->gyro, values + 3, sizeof(sample->gyro));
+  sample->temp = values[6];
+  return 0;
+}
+
+/**
+ * @brief  把 IMU 数据格式化为文本记录，可由 ParseImuSample 按
+ * ImuFormat::kText 解析。不分配内存
+ * @param  &sample: IMU 数据
+ * @param  *buf: [out] 输出缓存，以 '\0' 结尾
+ * @param  size: 输出缓存大小
+ * @param  precision: 有效数字位数，9 位时 float 可无损解析回相同的值
+ * @retval 文本长度，缓存不足时返回 -1
+ */
+inline int FormatImuSample(const ImuSample &sample, char *buf, size_t size,
+                           int precision = 9) {
+  int n = snprintf(buf, size, "%llu %.*g %.*g %.*g %.*g %.*g %.*g %.*g",
+                   static_cast<unsigned long long>(sample.time_stamp),
+                   precision, sample.acc[0], precision, sample.acc[1],
+                   precision, sample.acc[2], precision, sample.gyro[0],
+                   precision, sample.gyro[1], precision, sample.gyro[2],
+                   precision, sample.temp);
+  return n < 0 || static_cast<size_t>(n) >= size ? -1 : n;
+}
+
+/// CommitImu 首次分配 IMU 环形缓存时的容量
+constexpr size_t kDefaultImuRingCapacity = 1024;
+
+/**
+ * @brief  将 data.imu 解析为 IMU 数据，无法解析的记录被跳过
+ * @note   VidarData 的布局与预编译库一致，解析结果与编码方式都由调用方
+ * 保存；samples 先清空再追加，容量保留
+ * @param  &data: RecvData 的结果
+ * @param  format: imu 中记录的编码方式
+ * @param  *samples: [out] 解析结果
+ * @retval 解析失败的记录数
+ */
+inline size_t DecodeImu(const VidarData &data, ImuFormat format,
+                        std::vector<ImuSample> *samples) {
+  size_t failed = 0;
+  samples->clear();
+  for (auto &raw : data.imu) {
+    ImuSample sample;
+    if (ParseImuSample(raw.data(), raw.size(), format, &sample) == 0) {
+      samples->push_back(sample);
+    } else {
+      ++failed;
+    }
+  }
+  return failed;
+}
+
+/**
+ * @brief  将 data.imu 中的记录拷贝进环形缓存，满后覆盖最旧的记录
+ * @note   imu 中的字符串在下一次 RecvData 时失效，需要跨调用保留时使用；
+ * ring 容量为 0 时先分配 kDefaultImuRingCapacity，之后不分配内存
+ * @retval 本次写入的记录数
+ */
+inline size_t CommitImu(const VidarData &data,
+                        utils::RingBuffer<ImuRecord> *ring) {
+  if (ring->Capacity() == 0) {
+    ring->Reset(kDefaultImuRingCapacity);
+  }
+  for (auto &raw : data.imu) {
+    ring->PushSlot()->Assign(raw.data(), raw.size());
+  }
+  return data.imu.size();
+}
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_IMU_HPP_
@@ -0,0 +1,343 @@
+/**
+ * @file vidar_latency.hpp
+ * @brief 逐帧延迟记录与分阶段延迟统计
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_LATENCY_HPP_
+#define PG_VIDAR_LATENCY_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "pg/utils/latency_histogram.hpp"
+#include "vision_type/base_type.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 一帧在各处理节点的时间点，单位 ns，未知时为 0
+ * @note exposure_ns 与 device_transmit_ns 为设备时钟，其余为主机单调时钟
+ * （steady_clock）。当前预编译库未提供 device_transmit_ns、usb_complete_ns
+ * 与 assembled_ns，这三项保持为 0，相应阶段不参与统计。
+ */
+struct FrameTiming {
+  uint32_t channel_id = 0;
+  uint64_t frame_id = 0;
+  /// 曝光时间，即 ImageFrame::time_stamp
+  uint64_t exposure_ns = 0;
+  /// 设备发出时间
+  uint64_t device_transmit_ns = 0;
+  /// 主机 USB 传输完成时间
+  uint64_t usb_complete_ns = 0;
+  /// 解码/组帧完成时间
+  uint64_t assembled_ns = 0;
+  /// RecvData 返回该帧的时间
+  uint64_t recv_ns = 0;
+  /// 第一个订阅者回调开始的时间
+  uint64_t dispatch_ns = 0;
+  /// 最后一个订阅者回调结束的时间
+  uint64_t done_ns = 0;
+};
+
+/**
+ * @brief 延迟统计的阶段
+ */
+enum class LatencyStage {
+  /// 曝光到 RecvData 返回，需先 SetDeviceClockOffset
+  kExposureToRecv = 0,
+  /// 设备发出到 USB 传输完成，需先 SetDeviceClockOffset
+  kTransmitToUsb,
+  /// USB 传输完成到组帧完成
+  kUsbToAssembled,
+  /// 组帧完成到 RecvData 返回
+  kAssembledToRecv,
+  /// RecvData 返回到订阅者回调开始（分发队列等待）
+  kRecvToCallback,
+  /// 订阅者回调执行时间
+  kCallback,
+  kCount,
+};
+
+constexpr int kLatencyStageCount = static_cast<int>(LatencyStage::kCount);
+
+/// 阶段名，用于日志
+inline const char *LatencyStageName(LatencyStage stage) {
+  switch (stage) {
+    case LatencyStage::kExposureToRecv:
+      return "exposure_to_recv";
+    case LatencyStage::kTransmitToUsb:
+      return "transmit_to_usb";
+    case LatencyStage::kUsbToAssembled:
+      return "usb_to_assembled";
+    case LatencyStage::kAssembledToRecv:
+      return "assembled_to_recv";
+    case LatencyStage::kRecvToCallback:
+      return "recv_to_callback";
+    case LatencyStage::kCallback:
+      return "callback";
+    default:
+      return "unknown";
+  }
+}
+
+/**
+ * @brief 各阶段在滑动窗口内的延迟分位数
+ */
+struct LatencyStats {
+  /// 已记录的帧数（不限于窗口内）
+  uint64_t frames = 0;
+  utils::LatencyPercentiles stages[kLatencyStageCount];
+
+  const utils::LatencyPercentiles &Stage(LatencyStage stage) const {
+    return stages[static_cast<int>(stage)];
+  }
+};
+
+/**
+ * @brief 记录每帧的时间点，并按阶段维护延迟直方图
+ * @note OnRecv/OnCallback 只有原子操作，不加锁、不分配内存，可以常开。
+ * 最近 kTimingSlots 帧的 FrameTiming 保存在按 (channel_id, frame_id)
+ * 散列的环形表中，冲突时新帧覆盖旧帧；并发更新同一槽位时结果为近似值。
+ * 统计窗口默认为最近 10 秒。
+ */
+class LatencyTracker {
+ public:
+  static constexpr size_t kTimingSlots = 1024;
+
+  LatencyTracker() : slots_(new TimingSlot[kTimingSlots]) {}
+
+  LatencyTracker(const LatencyTracker &) = delete;
+  LatencyTracker &operator=(const LatencyTracker &) = delete;
+
+  /// 主机单调时钟，ns
+  static uint64_t Now() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  /**
+   * @brief  设置设备时钟到主机单调时钟的偏移，host = device + offset_ns
+   * @note   未设置时不统计依赖设备时钟的阶段
+   */
+  void SetDeviceClockOffset(int64_t offset_ns) {
+    clock_offset_ns_.store(offset_ns, std::memory_order_relaxed);
+    has_clock_offset_.store(true, std::memory_order_release);
+  }
+
+  /// 清除设备时钟偏移
+  void ClearDeviceClockOffset() {
+    has_clock_offset_.store(false, std::memory_order_release);
+  }
+
+  /**
+   * @brief  记录 RecvData 返回的一帧
+   * @param  &frame: 图像帧
+   * @param  recv_ns: RecvData 返回时的 Now()
+   */
+  void OnRecv(const phigent::vision::ImageFrame &frame, uint64_t recv_ns) {
+    FrameTiming timing;
+    timing.channel_id = frame.channel_id;
+    timing.frame_id = frame.frame_id;
+    timing.exposure_ns = frame.time_stamp;
+    timing.recv_ns = recv_ns;
+    Record(timing);
+  }
+
+  /**
+   * @brief  记录一条由调用者填写的时间记录，按已知的时间点统计各阶段
+   * @note   dispatch_ns/done_ns 应通过 OnCallback 记录
+   */
+  void Record(const FrameTiming &timing) {
+    uint64_t key = Key(timing.channel_id, timing.frame_id);
+    TimingSlot &slot = slots_[SlotIndex(key)];
+    slot.key.store(kInvalidKey, std::memory_order_release);
+    slot.exposure_ns.store(timing.exposure_ns, std::memory_order_relaxed);
+    slot.device_transmit_ns.store(timing.device_transmit_ns,
+                                  std::memory_order_relaxed);
+    slot.usb_complete_ns.store(timing.usb_complete_ns,
+                               std::memory_order_relaxed);
+    slot.assembled_ns.store(timing.assembled_ns, std::memory_order_relaxed);
+    slot.recv_ns.store(timing.recv_ns, std::memory_order_relaxed);
+    slot.dispatch_ns.store(0, std::memory_order_relaxed);
+    slot.done_ns.store(0, std::memory_order_relaxed);
+    slot.key.store(key, std::memory_order_release);
+    frames_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t now = timing.recv_ns;
+    int64_t offset = 0;
+    bool has_offset = DeviceClockOffset(&offset);
+    if (has_offset && timing.exposure_ns != 0) {
+      RecordStage(LatencyStage::kExposureToRecv,
+                  static_cast<int64_t>(timing.recv_ns) -
+                      static_cast<int64_t>(timing.exposure_ns) - offset,
+                  now);
+    }
+    if (has_offset && timing.device_transmit_ns != 0 &&
+        timing.usb_complete_ns != 0) {
+      RecordStage(LatencyStage::kTransmitToUsb,
+                  static_cast<int64_t>(timing.usb_complete_ns) -
+                      static_cast<int64_t>(timing.device_transmit_ns) -
+                      offset,
+                  now);
+    }
+    if (timing.usb_complete_ns != 0 && timing.assembled_ns != 0) {
+      RecordStage(LatencyStage::kUsbToAssembled,
+                  static_cast<int64_t>(timing.assembled_ns) -
+                      static_cast<int64_t>(timing.usb_complete_ns),
+                  now);
+    }
+    if (timing.assembled_ns != 0) {
+      RecordStage(LatencyStage::kAssembledToRecv,
+                  static_cast<int64_t>(timing.recv_ns) -
+                      static_cast<int64_t>(timing.assembled_ns),
+                  now);
+    }
+  }
+
+  /**
+   * @brief  记录一次订阅者回调
+   * @param  &frame: 图像帧
+   * @param  start_ns: 回调开始时的 Now()
+   * @param  end_ns: 回调结束时的 Now()
+   */
+  void OnCallback(const phigent::vision::ImageFrame &frame, uint64_t start_ns,
+                  uint64_t end_ns) {
+    uint64_t key = Key(frame.channel_id, frame.frame_id);
+    TimingSlot &slot = slots_[SlotIndex(key)];
+    RecordStage(LatencyStage::kCallback,
+                static_cast<int64_t>(end_ns) - static_cast<int64_t>(start_ns),
+                end_ns);
+    if (slot.key.load(std::memory_order_acquire) != key) {
+      return;
+    }
+    uint64_t recv_ns = slot.recv_ns.load(std::memory_order_relaxed);
+    if (recv_ns != 0) {
+      RecordStage(LatencyStage::kRecvToCallback,
+                  static_cast<int64_t>(start_ns) -
+                      static_cast<int64_t>(recv_ns),
+                  end_ns);
+    }
+    uint64_t expected = 0;
+    slot.dispatch_ns.compare_exchange_strong(expected, start_ns,
+                                             std::memory_order_relaxed);
+    uint64_t done = slot.done_ns.load(std::memory_order_relaxed);
+    while (end_ns > done &&
+           !slot.done_ns.compare_exchange_weak(done, end_ns,
+                                               std::memory_order_relaxed)) {
+    }
+  }
+
+  /**
+   * @brief  查询最近一帧的时间记录
+   * @param  channel_id: 通道号
+   * @param  frame_id: 帧号
+   * @param  *timing: [out] 时间记录
+   * @retval 0 成功，-1 已被覆盖或不存在
+   */
+  int GetFrameTiming(uint32_t channel_id, uint64_t frame_id,
+                     FrameTiming *timing) const {
+    uint64_t key = Key(channel_id, frame_id);
+    const TimingSlot &slot = slots_[SlotIndex(key)];
+    if (timing == nullptr || slot.key.load(std::memory_order_acquire) != key) {
+      return -1;
+    }
+    FrameTiming out;
+    out.channel_id = channel_id;
+    out.frame_id = frame_id;
+    out.exposure_ns = slot.exposure_ns.load(std::memory_order_relaxed);
+    out.device_transmit_ns =
+        slot.device_transmit_ns.load(std::memory_order_relaxed);
+    out.usb_complete_ns = slot.usb_complete_ns.load(std::memory_order_relaxed);
+    out.assembled_ns = slot.assembled_ns.load(std::memory_order_relaxed);
+    out.recv_ns = slot.recv_ns.load(std::memory_order_relaxed);
+    out.dispatch_ns = slot.dispatch_ns.load(std::memory_order_relaxed);
+    out.done_ns = slot.done_ns.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.key.load(std::memory_order_relaxed) != key) {
+      return -1;
+    }
+    *timing = out;
+    return 0;
+  }
+
+  /**
+   * @brief  获取各阶段在统计窗口内的延迟分位数
+   * @param  *stats: [out] 统计结果
+   * @retval 0 成功，否则为错误码
+   */
+  int GetStats(LatencyStats *stats) const {
+    if (stats == nullptr) {
+      return -1;
+    }
+    uint64_t now = Now();
+    stats->frames = frames_.load(std::memory_order_relaxed);
+    for (int i = 0; i < kLatencyStageCount; ++i) {
+      stats->stages[i] = histograms_[i].Percentiles(now);
+    }
+    return 0;
+  }
+
+ private:
+  static constexpr uint64_t kInvalidKey = ~0ull;
+
+  struct TimingSlot {
+    std::atomic<uint64_t> key{kInvalidKey};
+    std::atomic<uint64_t> exposure_ns{0};
+    std::atomic<uint64_t> device_transmit_ns{0};
+    std::atomic<uint64_t> usb_complete_ns{0};
+    std::atomic<uint64_t> assembled_ns{0};
+    std::atomic<uint64_t> recv_ns{0};
+    std::atomic<uint64_t> dispatch_ns{0};
+    std::atomic<uint64_t> done_ns{0};
+  };
+
+  /// 低 16 位为通道号，其余为帧号
+  static uint64_t Key(uint32_t channel_id, uint64_t frame_id) {
+    return (frame_id << 16) | (channel_id & 0xffffu);
+  }
+
+  static size_t SlotIndex(uint64_t key) {
+    // 同一帧的各通道落在相邻槽位
+    uint64_t frame_id = key >> 16;
+    uint64_t channel_id = key & 0xffffu;
+    return static_cast<size_t>((frame_id * 4 + channel_id) &
+                               (kTimingSlots - 1));
+  }
+
+  bool DeviceClockOffset(int64_t *offset) const {
+    if (!has_clock_offset_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *offset = clock_offset_ns_.load(std::memory_order_relaxed);
+    return true;
+  }
+
+  void RecordStage(LatencyStage stage, int64_t delta_ns, uint64_t now_ns) {
+    // 时钟偏移不准时可能出现负值，按 0 计
+    uint64_t us = delta_ns > 0 ? static_cast<uint64_t>(delta_ns) / 1000 : 0;
+    histograms_[static_cast<int>(stage)].Record(us, now_ns);
+  }
+
+  std::unique_ptr<TimingSlot[]> slots_;
+  utils::LatencyHistogram histograms_[kLatencyStageCount];
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<int64_t> clock_offset_ns_{0};
+  std::atomic<bool> has_clock_offset_{false};
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_LATENCY_HPP_
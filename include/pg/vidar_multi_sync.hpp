@@ -0,0 +1,373 @@
+/**
+ * @file vidar_multi_sync.hpp
+ * @brief 多台视觉雷达的跨设备时间对齐
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_MULTI_SYNC_HPP_
+#define PG_VIDAR_MULTI_SYNC_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/ring_buffer.hpp"
+#include "pg/vidar_clock_sync.hpp"
+#include "pg/vidar_device_manager.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 各设备同一时刻的一组图像
+ */
+struct AlignedGroup {
+  /// 按设备下标排列，缺失的设备为空
+  std::vector<phigent::vision::ImageFramePtr> frames;
+  /// 各成员换算到主机单调时钟的时间，缺失为 0
+  std::vector<uint64_t> host_ns;
+  /// 成员主机时间的平均值
+  uint64_t time_stamp = 0;
+  /// 成员主机时间的最大差
+  uint64_t spread_ns = 0;
+  /// 是否包含全部设备
+  bool complete = false;
+};
+
+struct MultiSyncConfig {
+  /// 设备数
+  int num_devices = 0;
+  /// 每台设备参与对齐的通道，其他通道被忽略
+  int channel_id = 0;
+  /// 同一组成员的最大时间差
+  uint64_t tolerance_ns = 1000000;
+  /// 一组自最早成员起最多等待的时间，超过后按 emit_partial 输出或丢弃
+  uint64_t max_latency_ns = 50000000;
+  /// 缺少设备的组是否输出
+  bool emit_partial = false;
+  /// 每台设备待对齐的帧数上限，满时丢弃最旧的帧
+  size_t queue_depth = 8;
+  /// 已对齐未取出的组数上限，满时覆盖最旧的组
+  size_t output_depth = 8;
+  /// frame_id 回退超过该值时视为设备重启或计数回绕，重新开始计数；
+  /// 回退不超过该值的帧视为重复帧并忽略
+  uint64_t frame_id_reset = 64;
+  ClockSyncConfig clock;
+};
+
+/**
+ * @brief  从 json 读取多设备对齐配置，缺省项保持默认值
+ * @param  conf_json: json 字符串
+ * {
+ *    "MultiSync": {
+ *        "channel_id": 0,
+ *        "tolerance_ms": 1.0,
+ *        "max_latency_ms": 50,
+ *        "emit_partial": false,
+ *        "queue_depth": 8
+ *    }
+ * }
+ * @param  *config: [in/out]
+ * @retval 0 成功，否则为错误码
+ */
+inline int ParseMultiSyncConfig(const std::string &conf_json,
+                                MultiSyncConfig *config) {
+  cv::FileStorage fs;
+  if (utils::json::Open(conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode node = fs["MultiSync"];
+  if (node.empty()) {
+    return 0;
+  }
+  config->channel_id =
+      utils::json::GetInt(node["channel_id"], config->channel_id);
+  double tolerance_ms = utils::json::GetDouble(
+      node["tolerance_ms"], config->tolerance_ns / 1e6);
+  double latency_ms = utils::json::GetDouble(
+      node["max_latency_ms"], config->max_latency_ns / 1e6);
+  int depth = utils::json::GetInt(node["queue_depth"],
+                                  static_cast<int>(config->queue_depth));
+  if (tolerance_ms <= 0 || latency_ms <= 0 || depth <= 0) {
+    return -1;
+  }
+  config->tolerance_ns = static_cast<uint64_t>(tolerance_ms * 1e6);
+  config->max_latency_ns = static_cast<uint64_t>(latency_ms * 1e6);
+  config->queue_depth = static_cast<size_t>(depth);
+  config->emit_partial =
+      utils::json::GetBool(node["emit_partial"], config->emit_partial);
+  return 0;
+}
+
+/**
+ * @brief 多设备帧对齐器：各设备的时间戳先由各自的 ClockSynchronizer
+ * 换算到主机单调时钟，再以最早的待对齐帧为基准，把 tolerance_ns 内的
+ * 各设备帧组成一组
+ * @note 每台设备的帧按到达顺序（即 frame_id 顺序）排队，每次对齐只比较
+ * 各设备的队首，每帧的均摊开销为 O(设备数)。frame_id 不连续时计入
+ * FrameGaps，重复的 frame_id 被忽略；回退超过 frame_id_reset 时计入
+ * FrameIdResets，先按超时处理全部待对齐的帧，再重新开始计数。
+ * 某台设备既没有待对齐的帧、也尚未越过当前组时，该组最多等待
+ * max_latency_ns，等待以 Push/Poll 传入的主机时间计算。非线程安全。
+ */
+class MultiDeviceAligner {
+ public:
+  explicit MultiDeviceAligner(const MultiSyncConfig &config)
+      : config_(config),
+        devices_(std::max(config.num_devices, 0)),
+        ready_(config.output_depth > 0 ? config.output_depth : 1) {
+    for (auto &device : devices_) {
+      device.clock.reset(new ClockSynchronizer(config.clock));
+      device.pending.Reset(config.queue_depth > 0 ? config.queue_depth : 1);
+    }
+  }
+
+  /**
+   * @brief  加入一帧
+   * @param  device: 设备下标
+   * @param  &frame: 图像帧，不是 channel_id 通道的帧被忽略
+   * @param  arrival_ns: 收到该帧时的主机单调时钟（如
+   * DeviceItem::arrival_ns），不能传入已换算的主机时间，否则映射会叠加两次
+   * @retval 0 成功，-1 参数无效或帧被忽略
+   */
+  int Push(int device, const phigent::vision::ImageFramePtr &frame,
+           uint64_t arrival_ns) {
+    if (device < 0 || device >= static_cast<int>(devices_.size()) || !frame ||
+        frame->channel_id != static_cast<uint32_t>(config_.channel_id)) {
+      return -1;
+    }
+    Device &d = devices_[device];
+    if (d.has_frame_id && frame->frame_id <= d.last_frame_id) {
+      if (d.last_frame_id - frame->frame_id <= config_.frame_id_reset) {
+        return -1;
+      }
+      // 设备重启或 frame_id 回绕，之前的帧不会再有同组成员
+      ++frame_id_resets_;
+      Align(UINT64_MAX);
+      d.has_frame_id = false;
+    }
+    if (d.has_frame_id && frame->frame_id > d.last_frame_id + 1) {
+      frame_gaps_ += frame->frame_id - d.last_frame_id - 1;
+    }
+    d.has_frame_id = true;
+    d.last_frame_id = frame->frame_id;
+    d.clock->AddSample(frame->time_stamp, arrival_ns);
+    Pending *slot = d.pending.PushSlot();
+    slot->frame = frame;
+    slot->host_ns = d.clock->HostTimeOf(frame->time_stamp);
+    d.last_host_ns = slot->host_ns;
+    Align(arrival_ns);
+    return 0;
+  }
+
+  /// 按当前主机时间检查等待超时，没有新数据时应定期调用
+  void Poll(uint64_t now_ns) { Align(now_ns); }
+
+  /**
+   * @brief  取出一组已对齐的帧
+   * @param  *group: [out]
+   * @retval true 成功，false 没有可输出的组
+   */
+  bool Pop(AlignedGroup *group) { return ready_.PopFront(group); }
+
+  /// 输出的组数，含不完整的组
+  uint64_t Groups() const { return groups_; }
+  /// 以不完整状态输出的组数
+  uint64_t PartialGroups() const { return partial_groups_; }
+  /// 未能组成完整组而被丢弃的帧数，含待对齐队列溢出
+  uint64_t DroppedFrames() const {
+    uint64_t overwritten = 0;
+    for (auto &device : devices_) {
+      overwritten += device.pending.Overwritten();
+    }
+    return dropped_frames_ + overwritten;
+  }
+  /// 按 frame_id 推算的缺失帧数
+  uint64_t FrameGaps() const { return frame_gaps_; }
+  /// frame_id 大幅回退（设备重启或回绕）的次数
+  uint64_t FrameIdResets() const { return frame_id_resets_; }
+
+  /// 第 device 台设备的时钟映射状态
+  ClockSyncState DeviceClock(int device) const {
+    return devices_[device].clock->GetState();
+  }
+
+ private:
+  struct Pending {
+    phigent::vision::ImageFramePtr frame;
+    uint64_t host_ns = 0;
+  };
+
+  struct Device {
+    std::unique_ptr<ClockSynchronizer> clock;
+    utils::RingBuffer<Pending> pending;
+    bool has_frame_id = false;
+    uint64_t last_frame_id = 0;
+    uint64_t last_host_ns = 0;
+  };
+
+  void Align(uint64_t now_ns) {
+    int count = static_cast<int>(devices_.size());
+    while (true) {
+      uint64_t oldest = UINT64_MAX;
+      for (auto &device : devices_) {
+        if (!device.pending.Empty()) {
+          oldest = std::min(oldest, device.pending.At(0).host_ns);
+        }
+      }
+      if (oldest == UINT64_MAX) {
+        return;
+      }
+      uint64_t limit = oldest + config_.tolerance_ns;
+      int members = 0;
+      bool waiting = false;
+      for (auto &device : devices_) {
+        if (!device.pending.Empty()) {
+          if (device.pending.At(0).host_ns <= limit) {
+            ++members;
+          }
+        } else if (device.last_host_ns <= limit) {
+          // 该设备还可能送来属于本组的帧
+          waiting = true;
+        }
+      }
+      if (members < count && waiting &&
+          now_ns < oldest + config_.max_latency_ns) {
+        return;
+      }
+      Finish(limit, members == count);
+    }
+  }
+
+  /// 取出主机时间不晚于 limit 的各设备队首，组成一组输出或丢弃
+  void Finish(uint64_t limit, bool complete) {
+    bool emit = complete || config_.emit_partial;
+    AlignedGroup *group = nullptr;
+    if (emit) {
+      group = ready_.PushSlot();
+      group->frames.assign(devices_.size(), nullptr);
+      group->host_ns.assign(devices_.size(), 0);
+      group->complete = complete;
+    }
+    uint64_t sum = 0;
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    int members = 0;
+    Pending pending;
+    for (size_t i = 0; i < devices_.size(); ++i) {
+      Device &device = devices_[i];
+      if (device.pending.Empty() || device.pending.At(0).host_ns > limit) {
+        continue;
+      }
+      device.pending.PopFront(&pending);
+      ++members;
+      if (!emit) {
+        continue;
+      }
+      group->frames[i] = std::move(pending.frame);
+      group->host_ns[i] = pending.host_ns;
+      sum += pending.host_ns;
+      min_ns = std::min(min_ns, pending.host_ns);
+      max_ns = std::max(max_ns, pending.host_ns);
+    }
+    if (!emit) {
+      dropped_frames_ += members;
+      return;
+    }
+    group->time_stamp = sum / members;
+    group->spread_ns = max_ns - min_ns;
+    ++groups_;
+    if (!complete) {
+      ++partial_groups_;
+    }
+  }
+
+  MultiSyncConfig config_;
+  std::vector<Device> devices_;
+  utils::RingBuffer<AlignedGroup> ready_;
+  uint64_t groups_ = 0;
+  uint64_t partial_groups_ = 0;
+  uint64_t dropped_frames_ = 0;
+  uint64_t frame_gaps_ = 0;
+  uint64_t frame_id_resets_ = 0;
+};
+
+/**
+ * @brief 在 VidarDeviceManager 的合并流之上提供 RecvAligned
+ * @note 管理器须以 DeviceDelivery::kMerged 打开并已 Start
+ */
+class AlignedGroupReceiver {
+ public:
+  /**
+   * @param  *manager: 设备管理器，生命周期由调用者管理
+   * @param  config: 对齐配置，num_devices 为 0 时取 manager->Size()
+   */
+  AlignedGroupReceiver(VidarDeviceManager *manager, MultiSyncConfig config)
+      : manager_(manager), aligner_(WithDevices(config, manager)) {}
+
+  /**
+   * @brief  接收一组对齐的帧
+   * @param  *group: [out] 对齐结果，可以跨调用复用
+   * @param  timeout_ms: 最长等待时间
+   * @retval 0 成功，-1 超时，-2 管理器无效或交付方式不符
+   */
+  int RecvAligned(AlignedGroup *group, int timeout_ms) {
+    if (manager_ == nullptr || group == nullptr) {
+      return -2;
+    }
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeout_ms);
+    while (true) {
+      if (aligner_.Pop(group)) {
+        return 0;
+      }
+      auto remain = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        deadline - std::chrono::steady_clock::now())
+                        .count();
+      if (remain <= 0) {
+        return -1;
+      }
+      int ret = manager_->RecvMerged(&item_, static_cast<int>(remain));
+      if (ret == -2) {
+        return -2;
+      }
+      if (ret == 0 && item_.frame) {
+        aligner_.Push(item_.device, item_.frame, item_.arrival_ns);
+      }
+      aligner_.Poll(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch())
+              .count()));
+    }
+  }
+
+  const MultiDeviceAligner &Aligner() const { return aligner_; }
+
+ private:
+  static MultiSyncConfig WithDevices(MultiSyncConfig config,
+                                     const VidarDeviceManager *manager) {
+    if (config.num_devices <= 0 && manager != nullptr) {
+      config.num_devices = static_cast<int>(manager->Size());
+    }
+    return config;
+  }
+
+  VidarDeviceManager *manager_ = nullptr;
+  MultiDeviceAligner aligner_;
+  DeviceItem item_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_MULTI_SYNC_HPP_
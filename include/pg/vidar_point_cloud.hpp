@@ -0,0 +1,597 @@
+/**
+ * @file vidar_point_cloud.hpp
+ * @brief 视差图转 SoA 点云
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_POINT_CLOUD_HPP_
+#define PG_VIDAR_POINT_CLOUD_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pg/utils/thread_pool.hpp"
+#include "pg/vidar_calibration.hpp"
+#include "pg/vidar_depth.hpp"
+#include "vision_type/base_type.hpp"
+#include "vision_type/simd_dispatch.hpp"
+
+namespace pg {
+namespace vidar {
+
+struct PointCloudConfig {
+  /// 视差图上的 ROI，宽高为 0 时到图像边缘
+  uint32_t roi_x = 0;
+  uint32_t roi_y = 0;
+  uint32_t roi_w = 0;
+  uint32_t roi_h = 0;
+  /// 行列采样间隔
+  uint32_t step = 1;
+  /// 视差（像素）不大于该值时视为无效
+  float min_disparity = 0.5f;
+  /// 深度超过该值（米）时视为无效，0 表示不限制
+  float max_depth_m = 0.0f;
+  /// true 时只输出有效点，不输出 mask
+  bool compact = false;
+  /// 标定中平移量的单位（米），0 表示自动判断：基线大于 1 视为毫米
+  double baseline_unit_m = 0.0;
+  /// 是否把 GetConfig 返回的 shift（>= 0 时）作为视差偏移
+  bool apply_shift = true;
+  /// 行分块的并行度，0 表示 std::thread::hardware_concurrency()
+  int num_threads = 0;
+};
+
+/**
+ * @brief 调用方提供的点云缓冲区（单位：米）
+ */
+struct PointCloudView {
+  float *x = nullptr;
+  float *y = nullptr;
+  float *z = nullptr;
+  /// 可为空；提供左图时输出对应位置的亮度
+  uint8_t *intensity = nullptr;
+  /// 可为空；有序输出时每个采样点 1 为有效，0 为无效（坐标为 0）
+  uint8_t *mask = nullptr;
+  /// 每个数组可容纳的点数
+  size_t capacity = 0;
+};
+
+/**
+ * @brief SoA 点云，可在帧间复用以避免重新分配
+ */
+struct PointCloud {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  /// 未提供左图时为空
+  std::vector<uint8_t> intensity;
+  /// compact 时为空
+  std::vector<uint8_t> mask;
+  /// 有序点云的网格尺寸；compact 时 width 为点数，height 为 1
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint64_t time_stamp = 0;
+  uint64_t frame_id = 0;
+
+  size_t Size() const { return x.size(); }
+};
+
+namespace detail {
+
+/**
+ * 每行的投影参数，u 为列坐标，d 为视差：
+ * [X Y Z W] = q[.][0] * u + q[.][2] * d + row[.]
+ * 输出 (X, Y, Z) * unit / W
+ */
+struct ReprojectParams {
+  float q0[4];
+  float q2[4];
+  float unit = 1.0f;
+  float min_disp = 0.5f;
+  /// 与 unit 之后的 z 比较，0 表示不限制
+  float max_z = 0.0f;
+};
+
+inline bool ReprojectPoint(float u, float d, const ReprojectParams &p,
+                           const float *row, float *x, float *y, float *z) {
+  float w = p.q0[3] * u + p.q2[3] * d + row[3];
+  float inv = p.unit / w;
+  float px = (p.q0[0] * u + p.q2[0] * d + row[0]) * inv;
+  float py = (p.q0[1] * u + p.q2[1] * d + row[1]) * inv;
+  float pz = (p.q0[2] * u + p.q2[2] * d + row[2]) * inv;
+  // w 为 0 时结果为 inf 或 NaN，比较为假
+  bool valid =
+      d > p.min_disp && pz > 0 && pz <= (p.max_z > 0 ? p.max_z : 3.4e38f);
+  *x = valid ? px : 0.0f;
+  *y = valid ? py : 0.0f;
+  *z = valid ? pz : 0.0f;
+  return valid;
+}
+
+inline void ReprojectRowScalar(const float *disp, float u0, float du,
+                               const ReprojectParams &p, const float *row,
+                               float *x, float *y, float *z, uint8_t *mask,
+                               int begin, int count) {
+  for (int i = begin; i < count; ++i) {
+    bool valid = ReprojectPoint(u0 + du * i, disp[i], p, row, x + i, y + i,
+                                z + i);
+    mask[i] = valid ? 1 : 0;
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void ReprojectRowSse41(const float *disp, float u0,
+                                              float du,
+                                              const ReprojectParams &p,
+                                              const float *row, float *x,
+                                              float *y, float *z,
+                                              uint8_t *mask, int count) {
+  __m128 q0[4], q2[4], r[4];
+  for (int k = 0; k < 4; ++k) {
+    q0[k] = _mm_set1_ps(p.q0[k]);
+    q2[k] = _mm_set1_ps(p.q2[k]);
+    r[k] = _mm_set1_ps(row[k]);
+  }
+  const __m128 unit = _mm_set1_ps(p.unit);
+  const __m128 min_disp = _mm_set1_ps(p.min_disp);
+  const __m128 max_z = _mm_set1_ps(p.max_z > 0 ? p.max_z : 3.4e38f);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 lane = _mm_setr_ps(0, 1, 2, 3);
+  const __m128 vdu = _mm_set1_ps(du);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 u = _mm_add_ps(_mm_set1_ps(u0),
+                          _mm_mul_ps(vdu, _mm_add_ps(_mm_set1_ps(i), lane)));
+    __m128 d = _mm_loadu_ps(disp + i);
+    __m128 c[4];
+    for (int k = 0; k < 4; ++k) {
+      c[k] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q0[k], u), _mm_mul_ps(q2[k], d)),
+                        r[k]);
+    }
+    __m128 inv = _mm_div_ps(unit, c[3]);
+    __m128 px = _mm_mul_ps(c[0], inv);
+    __m128 py = _mm_mul_ps(c[1], inv);
+    __m128 pz = _mm_mul_ps(c[2], inv);
+    __m128 valid = _mm_and_ps(
+        _mm_and_ps(_mm_cmpgt_ps(d, min_disp), _mm_cmpgt_ps(pz, zero)),
+        _mm_cmple_ps(pz, max_z));
+    _mm_storeu_ps(x + i, _mm_and_ps(px, valid));
+    _mm_storeu_ps(y + i, _mm_and_ps(py, valid));
+    _mm_storeu_ps(z + i, _mm_and_ps(pz, valid));
+    int bits = _mm_movemask_ps(valid);
+    for (int k = 0; k < 4; ++k) {
+      mask[i + k] = (bits >> k) & 1;
+    }
+  }
+  ReprojectRowScalar(disp, u0, du, p, row, x, y, z, mask, i, count);
+}
+
+PG_TARGET_AVX2 inline void ReprojectRowAvx2(const float *disp, float u0,
+                                            float du,
+                                            const ReprojectParams &p,
+                                            const float *row, float *x,
+                                            float *y, float *z, uint8_t *mask,
+                                            int count) {
+  __m256 q0[4], q2[4], r[4];
+  for (int k = 0; k < 4; ++k) {
+    q0[k] = _mm256_set1_ps(p.q0[k]);
+    q2[k] = _mm256_set1_ps(p.q2[k]);
+    r[k] = _mm256_set1_ps(row[k]);
+  }
+  const __m256 unit = _mm256_set1_ps(p.unit);
+  const __m256 min_disp = _mm256_set1_ps(p.min_disp);
+  const __m256 max_z = _mm256_set1_ps(p.max_z > 0 ? p.max_z : 3.4e38f);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 lane = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+  const __m256 vdu = _mm256_set1_ps(du);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 u = _mm256_add_ps(
+        _mm256_set1_ps(u0),
+        _mm256_mul_ps(vdu, _mm256_add_ps(_mm256_set1_ps(i), lane)));
+    __m256 d = _mm256_loadu_ps(disp + i);
+    __m256 c[4];
+    for (int k = 0; k < 4; ++k) {
+      c[k] = _mm256_add_ps(
+          _mm256_add_ps(_mm256_mul_ps(q0[k], u), _mm256_mul_ps(q2[k], d)),
+          r[k]);
+    }
+    __m256 inv = _mm256_div_ps(unit, c[3]);
+    __m256 px = _mm256_mul_ps(c[0], inv);
+    __m256 py = _mm256_mul_ps(c[1], inv);
+    __m256 pz = _mm256_mul_ps(c[2], inv);
+    __m256 valid = _mm256_and_ps(
+        _mm256_and_ps(_mm256_cmp_ps(d, min_disp, _CMP_GT_OQ),
+                      _mm256_cmp_ps(pz, zero, _CMP_GT_OQ)),
+        _mm256_cmp_ps(pz, max_z, _CMP_LE_OQ));
+    _mm256_storeu_ps(x + i, _mm256_and_ps(px, valid));
+    _mm256_storeu_ps(y + i, _mm256_and_ps(py, valid));
+    _mm256_storeu_ps(z + i, _mm256_and_ps(pz, valid));
+    // 每个 lane 的全 1 掩码压缩为 0/1 字节
+    __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(valid), 31);
+    __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(bits),
+                                     _mm256_extracti128_si256(bits, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(mask + i),
+                     _mm_packus_epi16(packed, packed));
+  }
+  ReprojectRowScalar(disp, u0, du, p, row, x, y, z, mask, i, count);
+}
+#endif  // PG_SIMD_X86
+
+#if defined(PG_SIMD_NEON)
+inline void ReprojectRowNeon(const float *disp, float u0, float du,
+                             const ReprojectParams &p, const float *row,
+                             float *x, float *y, float *z, uint8_t *mask,
+                             int count) {
+  const float32x4_t min_disp = vdupq_n_f32(p.min_disp);
+  const float32x4_t max_z = vdupq_n_f32(p.max_z > 0 ? p.max_z : 3.4e38f);
+  const float lane_init[4] = {0, 1, 2, 3};
+  const float32x4_t lane = vld1q_f32(lane_init);
+  int i = 0;
+  for (; i + 4 <= count; i += 4) {
+    float32x4_t u = vaddq_f32(
+        vdupq_n_f32(u0),
+        vmulq_n_f32(vaddq_f32(vdupq_n_f32(static_cast<float>(i)), lane), du));
+    float32x4_t d = vld1q_f32(disp + i);
+    float32x4_t c[4];
+    for (int k = 0; k < 4; ++k) {
+      c[k] = vaddq_f32(vaddq_f32(vmulq_n_f32(u, p.q0[k]),
+                                 vmulq_n_f32(d, p.q2[k])),
+                       vdupq_n_f32(row[k]));
+    }
+    // 倒数估计加两次牛顿迭代，armv7 没有向量除法
+    float32x4_t inv = vrecpeq_f32(c[3]);
+    inv = vmulq_f32(inv, vrecpsq_f32(c[3], inv));
+    inv = vmulq_f32(inv, vrecpsq_f32(c[3], inv));
+    inv = vmulq_n_f32(inv, p.unit);
+    float32x4_t px = vmulq_f32(c[0], inv);
+    float32x4_t py = vmulq_f32(c[1], inv);
+    float32x4_t pz = vmulq_f32(c[2], inv);
+    uint32x4_t valid = vandq_u32(
+        vandq_u32(vcgtq_f32(d, min_disp), vcgtq_f32(pz, vdupq_n_f32(0))),
+        vcleq_f32(pz, max_z));
+    vst1q_f32(x + i, vreinterpretq_f32_u32(
+                         vandq_u32(vreinterpretq_u32_f32(px), valid)));
+    vst1q_f32(y + i, vreinterpretq_f32_u32(
+                         vandq_u32(vreinterpretq_u32_f32(py), valid)));
+    vst1q_f32(z + i, vreinterpretq_f32_u32(
+                         vandq_u32(vreinterpretq_u32_f32(pz), valid)));
+    uint32x4_t bits = vshrq_n_u32(valid, 31);
+    for (int k = 0; k < 4; ++k) {
+      mask[i + k] = static_cast<uint8_t>(vgetq_lane_u32(bits, 0));
+      bits = vextq_u32(bits, bits, 1);
+    }
+  }
+  ReprojectRowScalar(disp, u0, du, p, row, x, y, z, mask, i, count);
+}
+#endif  // PG_SIMD_NEON
+
+/// 一行采样点投影，mask 必须非空
+inline void ReprojectRow(const float *disp, float u0, float du,
+                         const ReprojectParams &p, const float *row, float *x,
+                         float *y, float *z, uint8_t *mask, int count) {
+  using phigent::vision::SimdLevel;
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      ReprojectRowAvx2(disp, u0, du, p, row, x, y, z, mask, count);
+      return;
+    case SimdLevel::kSse41:
+      ReprojectRowSse41(disp, u0, du, p, row, x, y, z, mask, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      ReprojectRowNeon(disp, u0, du, p, row, x, y, z, mask, count);
+      return;
+#endif
+    default:
+      ReprojectRowScalar(disp, u0, du, p, row, x, y, z, mask, 0, count);
+      return;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 使用重投影矩阵 Q 把视差图转为 SoA 点云（单位：米）
+ * @note 投影为 [X Y Z W]^T = Q * [u v d 1]^T，输出 (X/W, Y/W, Z/W)，与
+ * cv::reprojectImageTo3D 一致。有序输出时无效点坐标为 0、mask 为 0。
+ * 按行分块在内部线程池上并行。Init 之后 Compute 线程安全
+ */
+class DisparityToPointCloud {
+ public:
+  DisparityToPointCloud() = default;
+  DisparityToPointCloud(const DisparityToPointCloud &) = delete;
+  DisparityToPointCloud &operator=(const DisparityToPointCloud &) = delete;
+
+  /**
+   * @brief  使用 ParseCameraConfig 解析出的标定初始化
+   * @param  calib: 标定参数，需包含 Q 或 P1/P2
+   * @param  config: 配置
+   * @retval 0 成功，-1 标定中没有重投影矩阵
+   */
+  int Init(const StereoCalibration &calib,
+           const PointCloudConfig &config = PointCloudConfig()) {
+    cv::Matx44d q;
+    if (!calib.GetReprojection(&q)) {
+      return -1;
+    }
+    double unit = config.baseline_unit_m;
+    if (unit <= 0) {
+      unit = calib.Baseline() > 1.0 ? 0.001 : 1.0;
+    }
+    double offset =
+        config.apply_shift && calib.shift >= 0 ? calib.shift : 0.0;
+    return Init(q, unit, offset, config);
+  }
+
+  /**
+   * @brief  直接指定重投影矩阵初始化
+   * @param  q: 重投影矩阵
+   * @param  unit_m: Q 投影结果的单位（米）
+   * @param  disparity_offset: 加到视差上的偏移（像素）
+   * @param  config: 配置
+   * @retval 0 成功，-1 参数无效
+   */
+  int Init(const cv::Matx44d &q, double unit_m, double disparity_offset,
+           const PointCloudConfig &config = PointCloudConfig()) {
+    if (unit_m <= 0 || config.step == 0) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    q_ = q;
+    config_ = config;
+    offset_ = static_cast<float>(disparity_offset);
+    for (int k = 0; k < 4; ++k) {
+      params_.q0[k] = static_cast<float>(q(k, 0));
+      params_.q2[k] = static_cast<float>(q(k, 2));
+    }
+    params_.unit = static_cast<float>(unit_m);
+    params_.min_disp = config.min_disparity;
+    params_.max_z = config.max_depth_m;
+    ready_ = true;
+    int threads = utils::ThreadPool::ResolveNumThreads(config.num_threads);
+    if (!pool_ || pool_->NumThreads() != threads) {
+      pool_.reset(new utils::ThreadPool(config.num_threads));
+    }
+    return 0;
+  }
+
+  /**
+   * @brief  计算 ROI 与采样间隔下的网格尺寸
+   * @param  disparity: 视差帧
+   * @param  *width: [out] 每行采样点数
+   * @param  *height: [out] 采样行数
+   * @retval 0 成功，-1 未初始化或 ROI 越界
+   */
+  int GridSize(phigent::vision::ImageFrame &disparity, uint32_t *width,
+               uint32_t *height) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Grid grid;
+    if (!ready_ || ResolveGrid(disparity, &grid) != 0) {
+      return -1;
+    }
+    *width = grid.cols;
+    *height = grid.rows;
+    return 0;
+  }
+
+  /**
+   * @brief  生成点云，写入调用方提供的缓冲区
+   * @param  disparity: 视差帧，支持 kPGPixelFormatInt16/Uint8/RawGRAY/
+   * Float32，float_scale 为原始值到像素视差的系数
+   * @param  left: 校正后的左图，可为空；支持单通道 8 位图和 YUV420（取 Y），
+   * 尺寸与视差图不同时按比例采样
+   * @param  *view: [out] 输出缓冲区，容量需不小于 GridSize 的点数
+   * @param  *count: [out] 输出点数（有序输出时为网格点数）
+   * @retval 0 成功，-1 未初始化，-2 格式或 ROI 不支持，-3 缓冲区不足
+   */
+  int Compute(phigent::vision::ImageFrame &disparity,
+              phigent::vision::ImageFrame *left, const PointCloudView &view,
+              size_t *count) {
+    detail::ReprojectParams params;
+    cv::Matx44d q;
+    float offset;
+    bool compact;
+    Grid grid;
+    std::shared_ptr<utils::ThreadPool> pool;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!ready_) {
+        return -1;
+      }
+      params = params_;
+      q = q_;
+      offset = offset_;
+      compact = config_.compact;
+      pool = pool_;
+      if (ResolveGrid(disparity, &grid) != 0) {
+        return -2;
+      }
+    }
+    size_t total = static_cast<size_t>(grid.cols) * grid.rows;
+    if (view.x == nullptr || view.y == nullptr || view.z == nullptr ||
+        view.capacity < total) {
+      return -3;
+    }
+    PGPixelFormat format = disparity.pixel_format;
+    size_t elem = detail::DisparityElemSize(format);
+    if (elem == 0 || disparity.Data() == nullptr) {
+      return -2;
+    }
+    size_t src_step = phigent::vision::FrameRowStep(
+        disparity.Stride(), disparity.Width(), elem);
+    const uint8_t *src = disparity.Data();
+    const uint8_t *gray = nullptr;
+    size_t gray_step = 0;
+    if (left != nullptr && view.intensity != nullptr) {
+      if (!detail::IsGrayLike(left->pixel_format) || left->Data() == nullptr) {
+        return -2;
+      }
+      gray = left->Data();
+      gray_step =
+          phigent::vision::FrameRowStep(left->Stride(), left->Width(), 1);
+    }
+    float sx = gray ? static_cast<float>(left->Width()) / disparity.Width()
+                    : 0.0f;
+    float sy = gray ? static_cast<float>(left->Height()) / disparity.Height()
+                    : 0.0f;
+    // compact 或调用方未提供 mask 时写入线程局部缓冲区
+    thread_local std::vector<uint8_t> mask_buffer;
+    uint8_t *mask = view.mask;
+    if (compact || mask == nullptr) {
+      mask_buffer.resize(total);
+      mask = mask_buffer.data();
+    }
+    float scale = disparity.float_scale;
+    auto rows = [&](int begin, int end) {
+      thread_local std::vector<float> disp_row;
+      disp_row.resize(grid.cols);
+      for (int r = begin; r < end; ++r) {
+        uint32_t v = grid.y0 + grid.step * r;
+        detail::LoadDisparityRow(src + src_step * v, format, scale, offset,
+                                 grid.x0, grid.step, grid.cols,
+                                 disp_row.data());
+        float row[4];
+        for (int k = 0; k < 4; ++k) {
+          row[k] = static_cast<float>(q(k, 1) * v + q(k, 3));
+        }
+        size_t base = static_cast<size_t>(grid.cols) * r;
+        detail::ReprojectRow(disp_row.data(), static_cast<float>(grid.x0),
+                             static_cast<float>(grid.step), params, row,
+                             view.x + base, view.y + base, view.z + base,
+                             mask + base, static_cast<int>(grid.cols));
+        if (gray != nullptr) {
+          const uint8_t *g =
+              gray + gray_step * static_cast<uint32_t>(v * sy);
+          for (uint32_t i = 0; i < grid.cols; ++i) {
+            uint32_t u = grid.x0 + grid.step * i;
+            view.intensity[base + i] = g[static_cast<uint32_t>(u * sx)];
+          }
+        }
+      }
+    };
+    pool->ParallelFor(0, static_cast<int>(grid.rows), kRowGrain, rows);
+    if (!compact) {
+      *count = total;
+      return 0;
+    }
+    // 按顺序把有效点前移，写位置不超过读位置
+    size_t n = 0;
+    for (size_t i = 0; i < total; ++i) {
+      if (mask[i]) {
+        view.x[n] = view.x[i];
+        view.y[n] = view.y[i];
+        view.z[n] = view.z[i];
+        if (gray != nullptr) {
+          view.intensity[n] = view.intensity[i];
+        }
+        ++n;
+      }
+    }
+    *count = n;
+    return 0;
+  }
+
+  /**
+   * @brief  生成点云，输出到可复用的 PointCloud
+   * @param  disparity: 视差帧
+   * @param  left: 校正后的左图，可为空
+   * @param  *cloud: [out] 点云，容量足够时不重新分配
+   * @retval 0 成功，否则为错误码，见 Compute(disparity, left, view, count)
+   */
+  int Compute(phigent::vision::ImageFrame &disparity,
+              phigent::vision::ImageFrame *left, PointCloud *cloud) {
+    uint32_t cols = 0;
+    uint32_t rows = 0;
+    if (GridSize(disparity, &cols, &rows) != 0) {
+      return -1;
+    }
+    size_t total = static_cast<size_t>(cols) * rows;
+    bool compact;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      compact = config_.compact;
+    }
+    cloud->x.resize(total);
+    cloud->y.resize(total);
+    cloud->z.resize(total);
+    cloud->intensity.resize(left != nullptr ? total : 0);
+    cloud->mask.resize(compact ? 0 : total);
+    PointCloudView view;
+    view.x = cloud->x.data();
+    view.y = cloud->y.data();
+    view.z = cloud->z.data();
+    view.intensity = left != nullptr ? cloud->intensity.data() : nullptr;
+    view.mask = compact ? nullptr : cloud->mask.data();
+    view.capacity = total;
+    size_t count = 0;
+    int ret = Compute(disparity, left, view, &count);
+    if (ret != 0) {
+      return ret;
+    }
+    cloud->x.resize(count);
+    cloud->y.resize(count);
+    cloud->z.resize(count);
+    cloud->intensity.resize(left != nullptr ? count : 0);
+    cloud->width = compact ? static_cast<uint32_t>(count) : cols;
+    cloud->height = compact ? 1 : rows;
+    cloud->time_stamp = disparity.time_stamp;
+    cloud->frame_id = disparity.frame_id;
+    return 0;
+  }
+
+ private:
+  /// 每个分块最少行数
+  static constexpr int kRowGrain = 8;
+
+  struct Grid {
+    uint32_t x0 = 0;
+    uint32_t y0 = 0;
+    uint32_t cols = 0;
+    uint32_t rows = 0;
+    uint32_t step = 1;
+  };
+
+  /// 调用方持有 mutex_
+  int ResolveGrid(phigent::vision::ImageFrame &disparity, Grid *grid) const {
+    uint32_t width = disparity.Width();
+    uint32_t height = disparity.Height();
+    const PointCloudConfig &c = config_;
+    if (c.roi_x >= width || c.roi_y >= height) {
+      return -1;
+    }
+    uint32_t w = c.roi_w != 0 ? c.roi_w : width - c.roi_x;
+    uint32_t h = c.roi_h != 0 ? c.roi_h : height - c.roi_y;
+    if (w > width - c.roi_x || h > height - c.roi_y) {
+      return -1;
+    }
+    grid->x0 = c.roi_x;
+    grid->y0 = c.roi_y;
+    grid->step = c.step;
+    grid->cols = (w + c.step - 1) / c.step;
+    grid->rows = (h + c.step - 1) / c.step;
+    return 0;
+  }
+
+  mutable std::mutex mutex_;
+  bool ready_ = false;
+  PointCloudConfig config_;
+  cv::Matx44d q_;
+  float offset_ = 0.0f;
+  detail::ReprojectParams params_;
+  std::shared_ptr<utils::ThreadPool> pool_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_POINT_CLOUD_HPP_
@@ -0,0 +1,603 @@
+/**
+ * @file vidar_record.hpp
+ * @brief 录制 RecvData 数据的分块文件格式与后台写入
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_RECORD_HPP_
+#define PG_VIDAR_RECORD_HPP_
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "pg/utils/bounded_queue.hpp"
+#include "pg/vidar_imu.hpp"
+#include "pg/vidar_interface.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * 录制文件（.pgrec）布局，均为小端：
+ * 1. RecordFileHeader；
+ * 2. 若干条记录，每条为 RecordHeader + 负载，负载补齐到 8 字节。图像负载为
+ *    主平面 data_size 字节（按 stride 原样保存）加 UV 平面 data_uv_size
+ *    字节；IMU 负载为 VidarData::imu 中的原始记录；
+ * 3. 索引：RecordIndexEntry 数组，按 time_stamp 排序（相同时按写入顺序）；
+ * 4. frame_id 序：uint32 数组，为索引下标按 frame_id 排序的结果；
+ * 5. RecordFileTrailer，位于文件末尾。
+ * 未正常结束的文件没有 3～5，读取时按记录头顺序扫描重建索引。
+ */
+constexpr uint64_t kRecordFileMagic = 0x3130434552564750ull;  // "PGVREC01"
+constexpr uint32_t kRecordMagic = 0x44524750u;                // "PGRD"
+constexpr uint32_t kRecordIndexMagic = 0x58494750u;           // "PGIX"
+constexpr uint32_t kRecordVersion = 1;
+constexpr const char *kRecordFileSuffix = ".pgrec";
+
+enum class RecordType : uint16_t {
+  kImage = 1,
+  kImu = 2,
+};
+
+struct RecordFileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t header_size;
+  /// 文件创建时的系统时间，ns
+  uint64_t create_time;
+  /// 分卷序号，从 0 开始
+  uint32_t file_index;
+  uint32_t reserved[9];
+};
+static_assert(sizeof(RecordFileHeader) == 64, "RecordFileHeader layout");
+
+struct RecordHeader {
+  uint32_t magic;
+  uint16_t type;
+  uint16_t header_size;
+  uint64_t time_stamp;
+  uint64_t frame_id;
+  uint32_t channel_id;
+  int32_t pixel_format;
+  uint32_t width;
+  uint32_t height;
+  uint32_t stride;
+  uint32_t stride_uv;
+  uint32_t channel;
+  float float_scale;
+  /// 主平面负载字节数，IMU 为文本记录长度（格式见 FormatImuSample）
+  uint32_t data_size;
+  uint32_t data_uv_size;
+};
+static_assert(sizeof(RecordHeader) == 64, "RecordHeader layout");
+
+struct RecordIndexEntry {
+  uint64_t time_stamp;
+  uint64_t frame_id;
+  /// RecordHeader 在文件中的偏移
+  uint64_t offset;
+  uint32_t channel_id;
+  uint16_t type;
+  uint16_t reserved;
+};
+static_assert(sizeof(RecordIndexEntry) == 32, "RecordIndexEntry layout");
+
+struct RecordFileTrailer {
+  uint64_t index_offset;
+  uint64_t index_count;
+  uint64_t frame_order_offset;
+  uint32_t version;
+  uint32_t magic;
+};
+static_assert(sizeof(RecordFileTrailer) == 32, "RecordFileTrailer layout");
+
+/// 负载补齐后的长度
+inline uint64_t RecordPayloadSpan(const RecordHeader &header) {
+  uint64_t size =
+      static_cast<uint64_t>(header.data_size) + header.data_uv_size;
+  return (size + 7) & ~static_cast<uint64_t>(7);
+}
+
+/// 第 file_index 个分卷的文件名
+inline std::string RecordFileName(const std::string &prefix,
+                                  uint32_t file_index) {
+  char buf[32];
+  snprintf(buf, sizeof(buf), "_%06u", file_index);
+  return prefix + buf + kRecordFileSuffix;
+}
+
+namespace detail {
+
+/**
+ * @brief 经由对齐缓存顺序写文件，缓存写满后整块写出，可使用 O_DIRECT
+ * @note 非线程安全，只在录制线程中使用
+ */
+class RecordFileWriter {
+ public:
+  static constexpr size_t kAlignment = 4096;
+
+  ~RecordFileWriter() { Close(); }
+
+  /**
+   * @retval 0 成功，-1 打开文件或分配缓存失败
+   */
+  int Open(const std::string &file_name, size_t buffer_bytes,
+           bool direct_io) {
+    Close();
+    buffer_bytes = std::max<size_t>(
+        (buffer_bytes + kAlignment - 1) / kAlignment * kAlignment,
+        kAlignment);
+    if (buffer_size_ != buffer_bytes) {
+      void *mem = nullptr;
+      if (posix_memalign(&mem, kAlignment, buffer_bytes) != 0) {
+        return -1;
+      }
+      buffer_.reset(static_cast<uint8_t *>(mem));
+      buffer_size_ = buffer_bytes;
+    }
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+    fd_ = -1;
+#ifdef O_DIRECT
+    if (direct_io) {
+      // 部分文件系统（如 tmpfs）不支持 O_DIRECT，此时退回普通写入
+      fd_ = open(file_name.c_str(), flags | O_DIRECT, 0644);
+    }
+#endif
+    if (fd_ < 0) {
+      fd_ = open(file_name.c_str(), flags, 0644);
+    }
+    if (fd_ < 0) {
+      return -1;
+    }
+    used_ = 0;
+    size_ = 0;
+    failed_ = false;
+    return 0;
+  }
+
+  bool IsOpen() const { return fd_ >= 0; }
+  bool Failed() const { return failed_; }
+  /// 已追加的字节数，即下一次追加的文件偏移
+  uint64_t Size() const { return size_; }
+
+  void Append(const void *data, size_t len) {
+    const uint8_t *src = static_cast<const uint8_t *>(data);
+    size_ += len;
+    while (len > 0) {
+      size_t n = std::min(len, buffer_size_ - used_);
+      memcpy(buffer_.get() + used_, src, n);
+      used_ += n;
+      src += n;
+      len -= n;
+      if (used_ == buffer_size_) {
+        Flush();
+      }
+    }
+  }
+
+  void AppendZeros(size_t len) {
+    static const uint8_t kZeros[8] = {0};
+    while (len > 0) {
+      size_t n = std::min(len, sizeof(kZeros));
+      Append(kZeros, n);
+      len -= n;
+    }
+  }
+
+  /**
+   * @brief  写出缓存中剩余的数据并关闭文件
+   * @retval 0 成功，-1 写入失败
+   */
+  int Close() {
+    if (fd_ < 0) {
+      return 0;
+    }
+#ifdef O_DIRECT
+    // 尾部不满一块，关闭 O_DIRECT 后写出
+    int flags = fcntl(fd_, F_GETFL);
+    if (flags >= 0 && (flags & O_DIRECT) != 0) {
+      fcntl(fd_, F_SETFL, flags & ~O_DIRECT);
+    }
+#endif
+    Flush();
+    if (fdatasync(fd_) != 0) {
+      failed_ = true;
+    }
+    close(fd_);
+    fd_ = -1;
+    return failed_ ? -1 : 0;
+  }
+
+ private:
+  struct FreeDeleter {
+    void operator()(uint8_t *p) const { free(p); }
+  };
+
+  void Flush() {
+    size_t done = 0;
+    while (done < used_ && !failed_) {
+      ssize_t n = write(fd_, buffer_.get() + done, used_ - done);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        failed_ = true;
+        break;
+      }
+      done += static_cast<size_t>(n);
+    }
+    used_ = 0;
+  }
+
+  int fd_ = -1;
+  std::unique_ptr<uint8_t, FreeDeleter> buffer_;
+  size_t buffer_size_ = 0;
+  size_t used_ = 0;
+  uint64_t size_ = 0;
+  bool failed_ = false;
+};
+
+/// 录制队列中的一项，frame 为空时为 IMU 记录
+struct RecordItem {
+  phigent::vision::ImageFramePtr frame;
+  ImuRecord imu;
+  uint64_t imu_time_stamp = 0;
+};
+
+}  // namespace detail
+
+/**
+ * @brief 录制配置
+ */
+struct RecorderConfig {
+  /// 单个文件的最大字节数，超过后写入下一个分卷
+  uint64_t max_file_bytes = 1ull << 30;
+  /// 写缓存大小，按 4096 对齐
+  size_t buffer_bytes = 8u << 20;
+  /// 待写入的记录数上限，满时丢弃最旧的记录
+  size_t queue_depth = 256;
+  /// 尽量使用 O_DIRECT 绕过页缓存
+  bool direct_io = true;
+  bool record_imu = true;
+};
+
+/**
+ * @brief 录制统计
+ */
+struct RecorderStats {
+  uint64_t frames = 0;
+  uint64_t imu = 0;
+  /// 因队列满丢弃的记录数
+  uint64_t dropped = 0;
+  /// 已写入的字节数（含索引）
+  uint64_t bytes = 0;
+  uint32_t files = 0;
+  /// 写文件失败的次数
+  uint64_t errors = 0;
+};
+
+/**
+ * @brief 把 RecvData 的结果追加写入 .pgrec 文件
+ * @note Write 只把帧的共享指针与 IMU 记录放入队列，由录制线程拷贝到对齐
+ * 缓存中整块写出；文件超过 max_file_bytes 时结束当前分卷（写入索引）并打开
+ * 下一个。队列中持有的帧在写出前不会归还缓存池，queue_depth 不宜超过帧来源
+ * 的缓存容量。Write 可以在多个线程调用。
+ *
+ * 使用示例：
+ *    SessionRecorder recorder;
+ *    recorder.Start("/data/session/rec");
+ *    while (vidar->RecvData(&data, 1000) == 0) recorder.Write(data);
+ *    recorder.Stop();
+ */
+class SessionRecorder {
+ public:
+  SessionRecorder() = default;
+  ~SessionRecorder() { Stop(); }
+
+  SessionRecorder(const SessionRecorder &) = delete;
+  SessionRecorder &operator=(const SessionRecorder &) = delete;
+
+  /**
+   * @brief  开始录制
+   * @param  prefix: 文件名前缀，分卷为 "<prefix>_000000.pgrec" 等
+   * @param  config: 录制配置
+   * @retval 0 成功，-1 已在录制，-2 无法创建文件
+   */
+  int Start(const std::string &prefix,
+            const RecorderConfig &config = RecorderConfig()) {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    if (thread_.joinable()) {
+      return -1;
+    }
+    prefix_ = prefix;
+    config_ = config;
+    {
+      std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+      stats_ = RecorderStats();
+      files_.clear();
+    }
+    dropped_.store(0);
+    file_index_ = 0;
+    if (OpenFile() != 0) {
+      return -2;
+    }
+    // 队列与配置就绪后才发布 recording_，Write 不会看到未创建的队列
+    auto queue = std::make_shared<utils::BoundedQueue<detail::RecordItem>>(
+        config.queue_depth);
+    std::atomic_store(&queue_, queue);
+    record_imu_.store(config.record_imu);
+    thread_ = std::thread([this, queue] { Run(queue.get()); });
+    recording_.store(true);
+    return 0;
+  }
+
+  /**
+   * @brief  停止录制，写完队列中的数据并结束当前分卷
+   * @retval 0 成功，-1 录制过程中发生过写入错误
+   */
+  int Stop() {
+    std::lock_guard<std::mutex> lock(control_mutex_);
+    if (!thread_.joinable()) {
+      return 0;
+    }
+    // 先停止接收新的 Write，已取得旧队列的 Write 写入关闭的队列时计为丢弃
+    recording_.store(false);
+    std::atomic_load(&queue_)->Close();
+    thread_.join();
+    return Stats().errors == 0 ? 0 : -1;
+  }
+
+  bool Recording() const { return recording_.load(); }
+
+  /**
+   * @brief  追加一次 RecvData 的结果，不阻塞
+   * @note   IMU 一律以文本记录写入，二进制记录先格式化为文本，无法解析的
+   * 二进制记录被跳过
+   * @param  &data: RecvData 的结果
+   * @param  imu_format: data.imu 中记录的编码方式
+   * @retval 0 成功，-1 未在录制
+   */
+  int Write(const VidarData &data, ImuFormat imu_format = ImuFormat::kText) {
+    if (!recording_.load()) {
+      return -1;
+    }
+    auto queue = std::atomic_load(&queue_);
+    if (!queue) {
+      return -1;
+    }
+    for (auto &frame : data.images) {
+      if (frame) {
+        detail::RecordItem item;
+        item.frame = frame;
+        Push(queue.get(), std::move(item));
+      }
+    }
+    if (!record_imu_.load()) {
+      return 0;
+    }
+    for (auto &raw : data.imu) {
+      detail::RecordItem item;
+      ImuSample sample;
+      bool parsed =
+          ParseImuSample(raw.data(), raw.size(), imu_format, &sample) == 0;
+      if (imu_format == ImuFormat::kText) {
+        item.imu.Assign(raw.data(), raw.size());
+      } else if (!parsed || !AssignImuText(sample, &item.imu)) {
+        continue;
+      }
+      item.imu_time_stamp = parsed ? sample.time_stamp : 0;
+      Push(queue.get(), std::move(item));
+    }
+    return 0;
+  }
+
+  RecorderStats Stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    RecorderStats stats = stats_;
+    stats.dropped = dropped_.load();
+    return stats;
+  }
+
+  /// 已创建的分卷文件名
+  std::vector<std::string> Files() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return files_;
+  }
+
+ private:
+  void Push(utils::BoundedQueue<detail::RecordItem> *queue,
+            detail::RecordItem item) {
+    if (!queue->PushDropOldest(std::move(item))) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// 9 位有效数字超出 ImuRecord::kMaxSize 时（多为指数形式）退回 7 位
+  static bool AssignImuText(const ImuSample &sample, ImuRecord *record) {
+    char text[ImuRecord::kMaxSize + 1];
+    int n = FormatImuSample(sample, text, sizeof(text));
+    if (n < 0) {
+      n = FormatImuSample(sample, text, sizeof(text), 7);
+    }
+    return n >= 0 && record->Assign(text, static_cast<size_t>(n)) == 0;
+  }
+
+  int OpenFile() {
+    std::string name = RecordFileName(prefix_, file_index_);
+    if (writer_.Open(name, config_.buffer_bytes, config_.direct_io) != 0) {
+      return -1;
+    }
+    RecordFileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kRecordFileMagic;
+    header.version = kRecordVersion;
+    header.header_size = sizeof(header);
+    header.create_time = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+    header.file_index = file_index_;
+    writer_.Append(&header, sizeof(header));
+    index_.clear();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    files_.push_back(name);
+    stats_.files = static_cast<uint32_t>(files_.size());
+    return 0;
+  }
+
+  /// 写入索引与文件尾并关闭
+  void FinishFile() {
+    RecordFileTrailer trailer;
+    memset(&trailer, 0, sizeof(trailer));
+    std::stable_sort(index_.begin(), index_.end(),
+                     [](const RecordIndexEntry &a, const RecordIndexEntry &b) {
+                       return a.time_stamp < b.time_stamp;
+                     });
+    std::vector<uint32_t> order(index_.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+      return index_[a].frame_id < index_[b].frame_id;
+    });
+    trailer.index_offset = writer_.Size();
+    trailer.index_count = index_.size();
+    writer_.Append(index_.data(), index_.size() * sizeof(RecordIndexEntry));
+    trailer.frame_order_offset = writer_.Size();
+    writer_.Append(order.data(), order.size() * sizeof(uint32_t));
+    writer_.AppendZeros((8 - writer_.Size() % 8) % 8);
+    trailer.version = kRecordVersion;
+    trailer.magic = kRecordIndexMagic;
+    writer_.Append(&trailer, sizeof(trailer));
+    uint64_t size = writer_.Size();
+    int ret = writer_.Close();
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    stats_.bytes += size;
+    if (ret != 0) {
+      ++stats_.errors;
+    }
+  }
+
+  void WriteItem(const detail::RecordItem &item) {
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = kRecordMagic;
+    header.header_size = sizeof(header);
+    const uint8_t *data = nullptr;
+    const uint8_t *data_uv = nullptr;
+    phigent::vision::ImageFrame *frame = item.frame.get();
+    if (frame != nullptr) {
+      header.type = static_cast<uint16_t>(RecordType::kImage);
+      header.time_stamp = frame->time_stamp;
+      header.frame_id = frame->frame_id;
+      header.channel_id = frame->channel_id;
+      header.pixel_format = static_cast<int32_t>(frame->pixel_format);
+      header.width = frame->Width();
+      header.height = frame->Height();
+      header.stride = frame->Stride();
+      header.stride_uv = frame->StrideUV();
+      header.channel = frame->Channel();
+      header.float_scale = frame->float_scale;
+      data = frame->Data();
+      data_uv = frame->DataUV();
+      header.data_size = data != nullptr ? frame->DataSize() : 0;
+      if (header.data_size == 0 && data != nullptr) {
+        header.data_size = header.stride * header.height;
+      }
+      header.data_uv_size = data_uv != nullptr ? frame->DataUVSize() : 0;
+    } else {
+      header.type = static_cast<uint16_t>(RecordType::kImu);
+      header.time_stamp = item.imu_time_stamp;
+      header.data_size = item.imu.size;
+      data = reinterpret_cast<const uint8_t *>(item.imu.data);
+    }
+    uint64_t span = RecordPayloadSpan(header);
+    if (!index_.empty() &&
+        writer_.Size() + sizeof(header) + span + sizeof(RecordFileTrailer) +
+                (index_.size() + 1) * (sizeof(RecordIndexEntry) + 4) >
+            config_.max_file_bytes) {
+      FinishFile();
+      ++file_index_;
+      if (OpenFile() != 0) {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        ++stats_.errors;
+        recording_.store(false);
+        return;
+      }
+    }
+    RecordIndexEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.time_stamp = header.time_stamp;
+    entry.frame_id = header.frame_id;
+    entry.offset = writer_.Size();
+    entry.channel_id = header.channel_id;
+    entry.type = header.type;
+    index_.push_back(entry);
+    writer_.Append(&header, sizeof(header));
+    writer_.Append(data, header.data_size);
+    if (header.data_uv_size > 0) {
+      writer_.Append(data_uv, header.data_uv_size);
+    }
+    writer_.AppendZeros(span - header.data_size - header.data_uv_size);
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    if (frame != nullptr) {
+      ++stats_.frames;
+    } else {
+      ++stats_.imu;
+    }
+  }
+
+  void Run(utils::BoundedQueue<detail::RecordItem> *queue) {
+    detail::RecordItem item;
+    while (queue->Pop(&item)) {
+      if (writer_.IsOpen()) {
+        WriteItem(item);
+      }
+      item = detail::RecordItem();
+    }
+    recording_.store(false);
+    if (writer_.IsOpen()) {
+      FinishFile();
+    }
+  }
+
+  std::mutex control_mutex_;
+  std::string prefix_;
+  RecorderConfig config_;
+  /// 通过 std::atomic_load/atomic_store 访问，Write 持有快照
+  std::shared_ptr<utils::BoundedQueue<detail::RecordItem>> queue_;
+  std::thread thread_;
+  std::atomic<bool> recording_{false};
+  std::atomic<bool> record_imu_{true};
+  std::atomic<uint64_t> dropped_{0};
+  // 以下只在录制线程中访问
+  detail::RecordFileWriter writer_;
+  std::vector<RecordIndexEntry> index_;
+  uint32_t file_index_ = 0;
+  mutable std::mutex stats_mutex_;
+  RecorderStats stats_;
+  std::vector<std::string> files_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_RECORD_HPP_
@@ -0,0 +1,348 @@
+/**
+ * @file vidar_record_reader.hpp
+ * @brief 基于 mmap 的 .pgrec 录制文件随机读取
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_RECORD_READER_HPP_
+#define PG_VIDAR_RECORD_READER_HPP_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "pg/vidar_record.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 一条记录的只读视图，指针指向映射内存，随 SessionReader 关闭失效
+ */
+struct RecordView {
+  const RecordHeader *header = nullptr;
+  /// 主平面（IMU 为原始记录）
+  const uint8_t *data = nullptr;
+  /// UV 平面，没有时为空
+  const uint8_t *data_uv = nullptr;
+
+  RecordType Type() const { return static_cast<RecordType>(header->type); }
+};
+
+namespace detail {
+
+/// 整个文件的只读映射，最后一个引用释放时解除映射
+struct RecordMapping {
+  RecordMapping(uint8_t *mapped, size_t mapped_size)
+      : data(mapped), size(mapped_size) {}
+  ~RecordMapping() {
+    if (data != nullptr) {
+      munmap(data, size);
+    }
+  }
+  RecordMapping(const RecordMapping &) = delete;
+  RecordMapping &operator=(const RecordMapping &) = delete;
+
+  uint8_t *data;
+  size_t size;
+};
+
+}  // namespace detail
+
+/**
+ * @brief 以 mmap 方式打开一个 .pgrec 分卷，按时间戳或 frame_id 二分查找
+ * @note 文件没有索引（录制异常中断）时顺序扫描记录头重建索引，截断的尾部
+ * 记录被忽略。映射为 MAP_PRIVATE，ReadFrame 返回的帧可以就地修改而不影响
+ * 文件。打开后只读访问线程安全。不可拷贝：扫描重建的索引由 index_ 等指针
+ * 指向自身的成员。
+ */
+class SessionReader {
+ public:
+  static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+  SessionReader() = default;
+  SessionReader(const SessionReader &) = delete;
+  SessionReader &operator=(const SessionReader &) = delete;
+
+  /**
+   * @brief  打开并映射文件
+   * @param  file_name: 分卷文件名
+   * @retval 0 成功，-1 打开或映射失败，-2 不是 .pgrec 文件或版本不支持
+   */
+  int Open(const std::string &file_name) {
+    Close();
+    int fd = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      return -1;
+    }
+    if (st.st_size < static_cast<off_t>(sizeof(RecordFileHeader))) {
+      close(fd);
+      return -2;
+    }
+    size_t size = static_cast<size_t>(st.st_size);
+    void *mem =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED) {
+      return -1;
+    }
+    mapping_ = std::make_shared<detail::RecordMapping>(
+        static_cast<uint8_t *>(mem), size);
+    const RecordFileHeader *header =
+        reinterpret_cast<const RecordFileHeader *>(mapping_->data);
+    if (header->magic != kRecordFileMagic ||
+        header->version != kRecordVersion ||
+        header->header_size < sizeof(RecordFileHeader)) {
+      Close();
+      return -2;
+    }
+    file_header_ = *header;
+    if (!LoadIndex()) {
+      ScanIndex();
+    }
+    return 0;
+  }
+
+  void Close() {
+    mapping_.reset();
+    index_ = nullptr;
+    frame_order_ = nullptr;
+    count_ = 0;
+    scanned_index_.clear();
+    scanned_order_.clear();
+    recovered_ = false;
+  }
+
+  bool IsOpen() const { return mapping_ != nullptr; }
+
+  /// 记录数
+  size_t Size() const { return count_; }
+
+  /// 索引是否由扫描重建（文件未正常结束）
+  bool Recovered() const { return recovered_; }
+
+  const RecordFileHeader &FileHeader() const { return file_header_; }
+
+  /// 按 time_stamp 排序的第 i 条索引
+  const RecordIndexEntry &Entry(size_t i) const { return index_[i]; }
+
+  /**
+   * @brief  第一条 time_stamp >= time_stamp 的记录，O(log n)
+   * @retval 索引下标，不存在时返回 Size()
+   */
+  size_t LowerBound(uint64_t time_stamp) const {
+    const RecordIndexEntry *it = std::lower_bound(
+        index_, index_ + count_, time_stamp,
+        [](const RecordIndexEntry &e, uint64_t ts) {
+          return e.time_stamp < ts;
+        });
+    return static_cast<size_t>(it - index_);
+  }
+
+  /**
+   * @brief  查找 frame_id 相同的第一条图像记录，O(log n)
+   * @param  frame_id: 帧号
+   * @param  channel_id: 通道，<0 表示任意通道
+   * @retval 索引下标，不存在时返回 kNotFound
+   */
+  size_t FindFrameId(uint64_t frame_id, int channel_id = -1) const {
+    const uint32_t *it = std::lower_bound(
+        frame_order_, frame_order_ + count_, frame_id,
+        [this](uint32_t i, uint64_t id) { return index_[i].frame_id < id; });
+    for (; it != frame_order_ + count_ && index_[*it].frame_id == frame_id;
+         ++it) {
+      const RecordIndexEntry &e = index_[*it];
+      if (e.type == static_cast<uint16_t>(RecordType::kImage) &&
+          (channel_id < 0 ||
+           e.channel_id == static_cast<uint32_t>(channel_id))) {
+        return *it;
+      }
+    }
+    return kNotFound;
+  }
+
+  /**
+   * @brief  读取第 i 条记录，不拷贝
+   * @retval 0 成功，-1 下标越界或记录损坏
+   */
+  int Read(size_t i, RecordView *view) const {
+    if (i >= count_ || !RecordInBounds(index_[i].offset)) {
+      return -1;
+    }
+    const uint8_t *base = mapping_->data + index_[i].offset;
+    view->header = reinterpret_cast<const RecordHeader *>(base);
+    view->data = base + view->header->header_size;
+    view->data_uv = view->header->data_uv_size > 0
+                        ? view->data + view->header->data_size
+                        : nullptr;
+    return 0;
+  }
+
+  /**
+   * @brief  把第 i 条图像记录包装为 ImageFrame，像素数据直接引用映射内存
+   * @note   返回的帧持有映射，SessionReader 关闭后仍然有效
+   * @retval 不是图像记录或越界时返回 nullptr
+   */
+  phigent::vision::ImageFramePtr ReadFrame(size_t i) const {
+    RecordView view;
+    if (Read(i, &view) != 0 || view.Type() != RecordType::kImage) {
+      return nullptr;
+    }
+    const RecordHeader &h = *view.header;
+    auto frame = std::make_shared<phigent::vision::ImageFrameImpl>();
+    frame->pixel_format = static_cast<PGPixelFormat>(h.pixel_format);
+    frame->channel_id = h.channel_id;
+    frame->time_stamp = h.time_stamp;
+    frame->frame_id = h.frame_id;
+    frame->float_scale = h.float_scale;
+    frame->width = h.width;
+    frame->height = h.height;
+    frame->stride = h.stride;
+    frame->stride_uv = h.stride_uv;
+    frame->channel = h.channel;
+    frame->data_size = h.data_size;
+    frame->data_uv_size = h.data_uv_size;
+    uint8_t *data = const_cast<uint8_t *>(view.data);
+    frame->virt_data_addr = data;
+    frame->virt_uv_data_addr = const_cast<uint8_t *>(view.data_uv);
+    auto buffer = std::make_shared<phigent::vision::DataBuffer>();
+    // 与映射共享引用计数
+    buffer->data =
+        std::shared_ptr<char>(mapping_, reinterpret_cast<char *>(data));
+    buffer->data_size = static_cast<size_t>(h.data_size) + h.data_uv_size;
+    frame->DataBuffer_ = buffer;
+    return frame;
+  }
+
+  /**
+   * @brief  读取第 i 条 IMU 记录
+   * @retval 0 成功，-1 不是 IMU 记录或越界
+   */
+  int ReadImu(size_t i, ImuRecord *record) const {
+    RecordView view;
+    if (Read(i, &view) != 0 || view.Type() != RecordType::kImu) {
+      return -1;
+    }
+    record->Assign(reinterpret_cast<const char *>(view.data),
+                   view.header->data_size);
+    return 0;
+  }
+
+ private:
+  bool LoadIndex() {
+    size_t size = mapping_->size;
+    if (size < sizeof(RecordFileHeader) + sizeof(RecordFileTrailer)) {
+      return false;
+    }
+    RecordFileTrailer trailer;
+    memcpy(&trailer, mapping_->data + size - sizeof(trailer), sizeof(trailer));
+    if (trailer.magic != kRecordIndexMagic ||
+        trailer.version != kRecordVersion ||
+        trailer.index_offset % 8 != 0 || trailer.frame_order_offset % 4 != 0 ||
+        trailer.index_offset > size || trailer.frame_order_offset > size ||
+        trailer.index_count >
+            (size - trailer.index_offset) / sizeof(RecordIndexEntry) ||
+        trailer.index_count >
+            (size - trailer.frame_order_offset) / sizeof(uint32_t)) {
+      return false;
+    }
+    index_ = reinterpret_cast<const RecordIndexEntry *>(mapping_->data +
+                                                        trailer.index_offset);
+    frame_order_ = reinterpret_cast<const uint32_t *>(
+        mapping_->data + trailer.frame_order_offset);
+    count_ = static_cast<size_t>(trailer.index_count);
+    // 只检查索引本身，不访问记录内容；索引损坏时按扫描处理
+    for (size_t i = 0; i < count_; ++i) {
+      if (frame_order_[i] >= count_ ||
+          index_[i].offset > size - sizeof(RecordHeader)) {
+        index_ = nullptr;
+        frame_order_ = nullptr;
+        count_ = 0;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool RecordInBounds(uint64_t offset) const {
+    size_t size = mapping_->size;
+    if (offset % 8 != 0 || offset > size ||
+        size - offset < sizeof(RecordHeader)) {
+      return false;
+    }
+    const RecordHeader *h =
+        reinterpret_cast<const RecordHeader *>(mapping_->data + offset);
+    return h->magic == kRecordMagic &&
+           h->header_size >= sizeof(RecordHeader) &&
+           h->header_size + RecordPayloadSpan(*h) <= size - offset;
+  }
+
+  void ScanIndex() {
+    recovered_ = true;
+    size_t size = mapping_->size;
+    uint64_t offset = file_header_.header_size;
+    while (offset + sizeof(RecordHeader) <= size) {
+      if (!RecordInBounds(offset)) {
+        break;
+      }
+      const RecordHeader *h =
+          reinterpret_cast<const RecordHeader *>(mapping_->data + offset);
+      RecordIndexEntry entry;
+      memset(&entry, 0, sizeof(entry));
+      entry.time_stamp = h->time_stamp;
+      entry.frame_id = h->frame_id;
+      entry.offset = offset;
+      entry.channel_id = h->channel_id;
+      entry.type = h->type;
+      scanned_index_.push_back(entry);
+      offset += h->header_size + RecordPayloadSpan(*h);
+    }
+    std::stable_sort(scanned_index_.begin(), scanned_index_.end(),
+                     [](const RecordIndexEntry &a, const RecordIndexEntry &b) {
+                       return a.time_stamp < b.time_stamp;
+                     });
+    scanned_order_.resize(scanned_index_.size());
+    std::iota(scanned_order_.begin(), scanned_order_.end(), 0u);
+    std::stable_sort(scanned_order_.begin(), scanned_order_.end(),
+                     [this](uint32_t a, uint32_t b) {
+                       return scanned_index_[a].frame_id <
+                              scanned_index_[b].frame_id;
+                     });
+    index_ = scanned_index_.data();
+    frame_order_ = scanned_order_.data();
+    count_ = scanned_index_.size();
+  }
+
+  std::shared_ptr<detail::RecordMapping> mapping_;
+  RecordFileHeader file_header_;
+  const RecordIndexEntry *index_ = nullptr;
+  const uint32_t *frame_order_ = nullptr;
+  size_t count_ = 0;
+  std::vector<RecordIndexEntry> scanned_index_;
+  std::vector<uint32_t> scanned_order_;
+  bool recovered_ = false;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_RECORD_READER_HPP_
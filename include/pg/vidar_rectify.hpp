@@ -0,0 +1,628 @@
+/**
+ * @file vidar_rectify.hpp
+ * @brief 主机端双目校正：定点映射表与分块并行 remap
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_RECTIFY_HPP_
+#define PG_VIDAR_RECTIFY_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pg/utils/thread_pool.hpp"
+#include "pg/vidar_calibration.hpp"
+#include "vision_type/image_frame_pool.hpp"
+#include "vision_type/simd_dispatch.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 左右相机
+ */
+enum class StereoSide {
+  kLeft = 0,
+  kRight = 1,
+};
+
+struct RectifierConfig {
+  /// 行分块的并行度，0 表示 std::thread::hardware_concurrency()
+  int num_threads = 0;
+  /// 每个分块的行数，分块内的源像素访问集中在相邻几行，缓存命中率高
+  int tile_rows = 16;
+};
+
+namespace detail {
+
+/*
+ * 映射表与 cv::initUndistortRectifyMap 的 CV_16SC2 + CV_16UC1 表示相同：
+ * 源坐标取 5 位小数，小数部分存为 fy * 32 + fx；整数部分预先换算为源
+ * 图像内的字节偏移 y * step + x，remap 时不需要乘法，AVX2 可直接 gather。
+ * 插值先水平后垂直：h = p0 * (32 - fx) + p1 * fx，
+ * out = (h0 * (32 - fy) + h1 * fy + 512) >> 10，所有实现输出逐位一致
+ */
+constexpr int kRemapBits = 5;
+constexpr int kRemapScale = 1 << kRemapBits;
+/// frac 的最高位表示靠近源图像边缘，须逐点检查越界，此时 ofs 为 edge_xy
+/// 中的下标；越界的邻点按 0 处理
+constexpr uint16_t kRemapEdge = 0x8000;
+
+struct RemapTable {
+  int width = 0;
+  int height = 0;
+  /// 生成时使用的源图像行字节数
+  size_t step = 0;
+  std::vector<int32_t> ofs;
+  std::vector<uint16_t> frac;
+  /// 边缘点的源坐标 (x, y)
+  std::vector<int16_t> edge_xy;
+};
+
+/// 3x3 矩阵求逆，行优先，奇异时返回 false
+inline bool Invert3x3(const double *m, double *inv) {
+  double c0 = m[4] * m[8] - m[5] * m[7];
+  double c1 = m[5] * m[6] - m[3] * m[8];
+  double c2 = m[3] * m[7] - m[4] * m[6];
+  double det = m[0] * c0 + m[1] * c1 + m[2] * c2;
+  if (det == 0) {
+    return false;
+  }
+  double s = 1.0 / det;
+  inv[0] = c0 * s;
+  inv[1] = (m[2] * m[7] - m[1] * m[8]) * s;
+  inv[2] = (m[1] * m[5] - m[2] * m[4]) * s;
+  inv[3] = c1 * s;
+  inv[4] = (m[0] * m[8] - m[2] * m[6]) * s;
+  inv[5] = (m[2] * m[3] - m[0] * m[5]) * s;
+  inv[6] = c2 * s;
+  inv[7] = (m[1] * m[6] - m[0] * m[7]) * s;
+  inv[8] = (m[0] * m[4] - m[1] * m[3]) * s;
+  return true;
+}
+
+/**
+ * @brief  单个相机的校正参数，已按输出分辨率缩放
+ */
+struct RectifyCamera {
+  /// 原始内参 fx, fy, cx, cy
+  double k[4] = {0, 0, 0, 0};
+  /// k1, k2, p1, p2, k3, k4, k5, k6
+  double dist[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+  /// (Knew * R) 的逆，行优先
+  double ir[9] = {0, 0, 0, 0, 0, 0, 0, 0, 0};
+};
+
+/**
+ * @brief  生成映射表，与 cv::initUndistortRectifyMap 的计算相同
+ * @param  step: 源图像行字节数，不小于 width
+ */
+inline void BuildRemapTable(const RectifyCamera &cam, int width, int height,
+                            size_t step, RemapTable *table) {
+  table->width = width;
+  table->height = height;
+  table->step = step;
+  table->ofs.resize(static_cast<size_t>(width) * height);
+  table->frac.resize(static_cast<size_t>(width) * height);
+  table->edge_xy.clear();
+  const double *ir = cam.ir;
+  const double *d = cam.dist;
+  for (int v = 0; v < height; ++v) {
+    double x0 = v * ir[1] + ir[2];
+    double y0 = v * ir[4] + ir[5];
+    double w0 = v * ir[7] + ir[8];
+    int32_t *ofs = &table->ofs[static_cast<size_t>(v) * width];
+    uint16_t *frac = &table->frac[static_cast<size_t>(v) * width];
+    for (int u = 0; u < width; ++u) {
+      double w = 1.0 / (w0 + u * ir[6]);
+      double x = (x0 + u * ir[0]) * w;
+      double y = (y0 + u * ir[3]) * w;
+      double x2 = x * x;
+      double y2 = y * y;
+      double r2 = x2 + y2;
+      double xy2 = 2 * x * y;
+      double kr = (1 + ((d[4] * r2 + d[1]) * r2 + d[0]) * r2) /
+                  (1 + ((d[7] * r2 + d[6]) * r2 + d[5]) * r2);
+      double su = cam.k[0] * (x * kr + d[2] * xy2 + d[3] * (r2 + 2 * x2)) +
+                  cam.k[2];
+      double sv = cam.k[1] * (y * kr + d[2] * (r2 + 2 * y2) + d[3] * xy2) +
+                  cam.k[3];
+      // 远离图像的点钳位，避免 int16 溢出
+      su = std::min(std::max(su * kRemapScale, -32768.0 * kRemapScale),
+                    32767.0 * kRemapScale);
+      sv = std::min(std::max(sv * kRemapScale, -32768.0 * kRemapScale),
+                    32767.0 * kRemapScale);
+      int iu = static_cast<int>(std::lround(su));
+      int iv = static_cast<int>(std::lround(sv));
+      int sx = iu >> kRemapBits;
+      int sy = iv >> kRemapBits;
+      uint16_t f = static_cast<uint16_t>((iv & (kRemapScale - 1)) *
+                                             kRemapScale +
+                                         (iu & (kRemapScale - 1)));
+      // gather 每次读取 4 字节，右侧多留 2 列
+      if (sx < 0 || sy < 0 || sx + 3 >= width || sy + 1 >= height) {
+        ofs[u] = static_cast<int32_t>(table->edge_xy.size());
+        table->edge_xy.push_back(static_cast<int16_t>(sx));
+        table->edge_xy.push_back(static_cast<int16_t>(sy));
+        f |= kRemapEdge;
+      } else {
+        ofs[u] = static_cast<int32_t>(step * sy + sx);
+      }
+      frac[u] = f;
+    }
+  }
+}
+
+inline uint8_t RemapBlend(int p00, int p01, int p10, int p11, uint16_t f) {
+  int fx = f & (kRemapScale - 1);
+  int fy = (f >> kRemapBits) & (kRemapScale - 1);
+  int h0 = p00 * (kRemapScale - fx) + p01 * fx;
+  int h1 = p10 * (kRemapScale - fx) + p11 * fx;
+  return static_cast<uint8_t>((h0 * (kRemapScale - fy) + h1 * fy + 512) >>
+                              10);
+}
+
+/// 边缘点：逐个邻点检查越界
+inline uint8_t RemapEdgePixel(const uint8_t *src, size_t step, int width,
+                              int height, int x, int y, uint16_t f) {
+  int p[4] = {0, 0, 0, 0};
+  for (int k = 0; k < 4; ++k) {
+    int px = x + (k & 1);
+    int py = y + (k >> 1);
+    if (px >= 0 && py >= 0 && px < width && py < height) {
+      p[k] = src[step * py + px];
+    }
+  }
+  return RemapBlend(p[0], p[1], p[2], p[3], f);
+}
+
+/**
+ * @brief  映射一行中 [begin, count) 的点
+ * @param  *ofs, *frac: 该行在映射表中的起点
+ */
+inline void RemapRowScalar(const uint8_t *src, const RemapTable &table,
+                           const int32_t *ofs, const uint16_t *frac,
+                           uint8_t *dst, int begin, int count) {
+  size_t step = table.step;
+  for (int i = begin; i < count; ++i) {
+    uint16_t f = frac[i];
+    if (f & kRemapEdge) {
+      const int16_t *xy = &table.edge_xy[ofs[i]];
+      dst[i] = RemapEdgePixel(src, step, table.width, table.height, xy[0],
+                              xy[1], f);
+      continue;
+    }
+    const uint8_t *p = src + ofs[i];
+    dst[i] = RemapBlend(p[0], p[1], p[step], p[step + 1], f);
+  }
+}
+
+#if defined(PG_SIMD_X86)
+/// 每个 32 位元素为一个点的 (p00, p01, p10, p11)，f 为 frac
+PG_TARGET_SSE41 inline __m128i RemapBlendSse41(__m128i pix, __m128i f) {
+  const __m128i mask = _mm_set1_epi32(kRemapScale - 1);
+  const __m128i scale = _mm_set1_epi32(kRemapScale);
+  __m128i fx = _mm_and_si128(f, mask);
+  __m128i fy = _mm_and_si128(_mm_srli_epi32(f, kRemapBits), mask);
+  // 水平权重按字节排列为 (32 - fx, fx, 32 - fx, fx)
+  __m128i t = _mm_or_si128(_mm_sub_epi32(scale, fx), _mm_slli_epi32(fx, 8));
+  __m128i wx = _mm_or_si128(t, _mm_slli_epi32(t, 16));
+  __m128i wy = _mm_or_si128(_mm_sub_epi32(scale, fy), _mm_slli_epi32(fy, 16));
+  __m128i sum = _mm_madd_epi16(_mm_maddubs_epi16(pix, wx), wy);
+  return _mm_srai_epi32(_mm_add_epi32(sum, _mm_set1_epi32(512)), 10);
+}
+
+PG_TARGET_SSE41 inline void RemapRowSse41(const uint8_t *src,
+                                          const RemapTable &table,
+                                          const int32_t *ofs,
+                                          const uint16_t *frac, uint8_t *dst,
+                                          int count) {
+  size_t step = table.step;
+  alignas(16) uint32_t pix[8];
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i f = _mm_loadu_si128(reinterpret_cast<const __m128i *>(frac + i));
+    if (_mm_movemask_epi8(f) & 0xAAAA) {
+      RemapRowScalar(src, table, ofs, frac, dst, i, i + 8);
+      continue;
+    }
+    for (int k = 0; k < 8; ++k) {
+      const uint8_t *p = src + ofs[i + k];
+      uint16_t top;
+      uint16_t bottom;
+      memcpy(&top, p, sizeof(top));
+      memcpy(&bottom, p + step, sizeof(bottom));
+      pix[k] = top | static_cast<uint32_t>(bottom) << 16;
+    }
+    __m128i lo = RemapBlendSse41(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(pix)),
+        _mm_cvtepu16_epi32(f));
+    __m128i hi = RemapBlendSse41(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(pix + 4)),
+        _mm_cvtepu16_epi32(_mm_srli_si128(f, 8)));
+    __m128i out =
+        _mm_packus_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), out);
+  }
+  RemapRowScalar(src, table, ofs, frac, dst, i, count);
+}
+
+PG_TARGET_AVX2 inline void RemapRowAvx2(const uint8_t *src,
+                                        const RemapTable &table,
+                                        const int32_t *ofs,
+                                        const uint16_t *frac, uint8_t *dst,
+                                        int count) {
+  const int *top = reinterpret_cast<const int *>(src);
+  const int *bottom = reinterpret_cast<const int *>(src + table.step);
+  const __m256i mask = _mm256_set1_epi32(kRemapScale - 1);
+  const __m256i scale = _mm256_set1_epi32(kRemapScale);
+  const __m256i half = _mm256_set1_epi32(512);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i f16 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(frac + i));
+    if (_mm_movemask_epi8(f16) & 0xAAAA) {
+      RemapRowScalar(src, table, ofs, frac, dst, i, i + 8);
+      continue;
+    }
+    __m256i o = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ofs + i));
+    // 每个点读取上下两行各 4 字节，只保留前 2 字节
+    __m256i g0 = _mm256_i32gather_epi32(top, o, 1);
+    __m256i g1 = _mm256_i32gather_epi32(bottom, o, 1);
+    __m256i pix = _mm256_blend_epi16(g0, _mm256_slli_epi32(g1, 16), 0xAA);
+    __m256i f = _mm256_cvtepu16_epi32(f16);
+    __m256i fx = _mm256_and_si256(f, mask);
+    __m256i fy = _mm256_and_si256(_mm256_srli_epi32(f, kRemapBits), mask);
+    __m256i t = _mm256_or_si256(_mm256_sub_epi32(scale, fx),
+                                _mm256_slli_epi32(fx, 8));
+    __m256i wx = _mm256_or_si256(t, _mm256_slli_epi32(t, 16));
+    __m256i wy = _mm256_or_si256(_mm256_sub_epi32(scale, fy),
+                                 _mm256_slli_epi32(fy, 16));
+    __m256i sum = _mm256_madd_epi16(_mm256_maddubs_epi16(pix, wx), wy);
+    sum = _mm256_srai_epi32(_mm256_add_epi32(sum, half), 10);
+    __m128i out = _mm_packus_epi16(
+        _mm_packs_epi32(_mm256_castsi256_si128(sum),
+                        _mm256_extracti128_si256(sum, 1)),
+        _mm_setzero_si128());
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + i), out);
+  }
+  RemapRowScalar(src, table, ofs, frac, dst, i, count);
+}
+#endif
+
+#if defined(PG_SIMD_NEON)
+inline void RemapRowNeon(const uint8_t *src, const RemapTable &table,
+                         const int32_t *ofs, const uint16_t *frac,
+                         uint8_t *dst, int count) {
+  size_t step = table.step;
+  const uint16x8_t mask = vdupq_n_u16(kRemapScale - 1);
+  const uint16x8_t scale = vdupq_n_u16(kRemapScale);
+  uint8_t p[4][8];
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    uint16x8_t f = vld1q_u16(frac + i);
+    // armv7 没有跨通道归约，合并为 64 位后检查边缘标志
+    uint16x4_t any = vorr_u16(vget_low_u16(f), vget_high_u16(f));
+    if (vget_lane_u64(vreinterpret_u64_u16(any), 0) &
+        0x8000800080008000ull) {
+      RemapRowScalar(src, table, ofs, frac, dst, i, i + 8);
+      continue;
+    }
+    for (int k = 0; k < 8; ++k) {
+      const uint8_t *q = src + ofs[i + k];
+      p[0][k] = q[0];
+      p[1][k] = q[1];
+      p[2][k] = q[step];
+      p[3][k] = q[step + 1];
+    }
+    uint16x8_t fx = vandq_u16(f, mask);
+    uint16x8_t fy = vandq_u16(vshrq_n_u16(f, kRemapBits), mask);
+    uint16x8_t rx = vsubq_u16(scale, fx);
+    uint16x8_t ry = vsubq_u16(scale, fy);
+    uint16x8_t h0 = vmlaq_u16(vmulq_u16(vmovl_u8(vld1_u8(p[0])), rx),
+                              vmovl_u8(vld1_u8(p[1])), fx);
+    uint16x8_t h1 = vmlaq_u16(vmulq_u16(vmovl_u8(vld1_u8(p[2])), rx),
+                              vmovl_u8(vld1_u8(p[3])), fx);
+    uint32x4_t lo = vmlal_u16(vmull_u16(vget_low_u16(h0), vget_low_u16(ry)),
+                              vget_low_u16(h1), vget_low_u16(fy));
+    uint32x4_t hi =
+        vmlal_u16(vmull_u16(vget_high_u16(h0), vget_high_u16(ry)),
+                  vget_high_u16(h1), vget_high_u16(fy));
+    uint16x8_t out = vcombine_u16(vrshrn_n_u32(lo, 10), vrshrn_n_u32(hi, 10));
+    vst1_u8(dst + i, vqmovn_u16(out));
+  }
+  RemapRowScalar(src, table, ofs, frac, dst, i, count);
+}
+#endif
+
+/// 映射输出的第 y 行
+inline void RemapRow(const uint8_t *src, const RemapTable &table, int y,
+                     uint8_t *dst) {
+  size_t offset = static_cast<size_t>(y) * table.width;
+  const int32_t *ofs = &table.ofs[offset];
+  const uint16_t *frac = &table.frac[offset];
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+      RemapRowAvx2(src, table, ofs, frac, dst, table.width);
+      return;
+    case phigent::vision::SimdLevel::kSse41:
+      RemapRowSse41(src, table, ofs, frac, dst, table.width);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case phigent::vision::SimdLevel::kNeon:
+      RemapRowNeon(src, table, ofs, frac, dst, table.width);
+      return;
+#endif
+    default:
+      RemapRowScalar(src, table, ofs, frac, dst, 0, table.width);
+      return;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief 主机端双目校正：板端输出 ORIG（未校正）图像时，按标定中的
+ * M1/D1/R1/P1（左）与 M2/D2/R2/P2（右）校正为与 REMAP 相同几何的图像
+ * @note 每个相机、每种分辨率（及行字节数）的映射表在首次使用时生成
+ * 一次（或调用 Prepare 预先生成），之后复用。映射表为 5 位小数的定点格式，
+ * 每像素 6 字节；remap 按 tile_rows 行分块在内部线程池上并行，四邻点插值
+ * 使用 SIMD。
+ * 帧分辨率与标定的 image_width/image_height 不同时按比例缩放内参；
+ * 标定未提供图像尺寸时假定与帧一致。畸变支持 4/5/8 参数模型。
+ * 输入为 GRAY 或 NV12/NV21/I420/YV12（只校正亮度平面），输出为 GRAY。
+ * Init 之后 Rectify 线程安全。
+ */
+class Rectifier {
+ public:
+  Rectifier() = default;
+  Rectifier(const Rectifier &) = delete;
+  Rectifier &operator=(const Rectifier &) = delete;
+
+  /**
+   * @brief  使用 ParseCameraConfig 或 CalibrationCache 得到的标定初始化
+   * @param  calib: 需包含 M1/M2、R1/R2 与 P1/P2，D1/D2 可选
+   * @param  config: 校正配置
+   * @retval 0 成功，-1 标定不完整
+   */
+  int Init(const StereoCalibration &calib,
+           const RectifierConfig &config = RectifierConfig()) {
+    Side sides[2];
+    if (ParseSide(calib.M1, calib.D1, calib.R1, calib.P1, &sides[0]) != 0 ||
+        ParseSide(calib.M2, calib.D2, calib.R2, calib.P2, &sides[1]) != 0) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    config_.tile_rows = std::max(config_.tile_rows, 1);
+    sides_[0] = sides[0];
+    sides_[1] = sides[1];
+    calib_width_ = calib.image_width;
+    calib_height_ = calib.image_height;
+    tables_.clear();
+    int threads = utils::ThreadPool::ResolveNumThreads(config.num_threads);
+    if (!pool_ || pool_->NumThreads() != threads) {
+      pool_.reset(new utils::ThreadPool(config.num_threads));
+    }
+    ready_ = true;
+    return 0;
+  }
+
+  /// 是否已初始化
+  bool Ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ready_;
+  }
+
+  /**
+   * @brief  预先生成指定分辨率的映射表，避免首帧延迟
+   * @param  step: 源图像行字节数，0 表示与 width 相同
+   * @retval 0 成功，-1 未初始化或尺寸无效
+   */
+  int Prepare(StereoSide side, int width, int height, size_t step = 0) {
+    return GetTable(side, width, height, std::max<size_t>(step, width)) ? 0
+                                                                        : -1;
+  }
+
+  /**
+   * @brief  校正一帧，输出帧来自缓存池
+   * @param  src: 未校正的图像
+   * @param  side: 该图像所属的相机
+   * @param  pool: 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+   * @retval 校正后的 GRAY 帧，继承 channel_id/time_stamp/frame_id/type；
+   * 失败返回 nullptr
+   */
+  phigent::vision::ImageFramePtr Rectify(
+      phigent::vision::ImageFrame &src, StereoSide side,
+      phigent::vision::ImageFramePool *pool = nullptr) {
+    if (pool == nullptr) {
+      pool = &phigent::vision::DefaultImageFramePool();
+    }
+    auto dst = pool->Acquire(kPGPixelFormatRawGRAY, src.Width(), src.Height());
+    if (!dst || Rectify(src, side, dst.get()) != 0) {
+      return nullptr;
+    }
+    return dst;
+  }
+
+  /**
+   * @brief  校正一帧，写入调用方提供的帧
+   * @param  src: 未校正的图像
+   * @param  side: 该图像所属的相机
+   * @param  *dst: [out] 与 src 同尺寸的 GRAY 帧
+   * @retval 0 成功，-1 未初始化，-2 输入格式不支持，-3 输出帧不匹配
+   */
+  int Rectify(phigent::vision::ImageFrame &src, StereoSide side,
+              phigent::vision::ImageFrame *dst) {
+    if (!IsLumaFormat(src.pixel_format) || src.Data() == nullptr) {
+      return -2;
+    }
+    int width = static_cast<int>(src.Width());
+    int height = static_cast<int>(src.Height());
+    if (dst == nullptr || dst->Data() == nullptr ||
+        dst->pixel_format != kPGPixelFormatRawGRAY ||
+        dst->Width() != src.Width() || dst->Height() != src.Height()) {
+      return -3;
+    }
+    size_t src_step =
+        phigent::vision::FrameRowStep(src.Stride(), src.Width(), 1);
+    size_t dst_step =
+        phigent::vision::FrameRowStep(dst->Stride(), dst->Width(), 1);
+    auto table = GetTable(side, width, height, src_step);
+    std::shared_ptr<utils::ThreadPool> pool;
+    int tile_rows = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pool = pool_;
+      tile_rows = config_.tile_rows;
+    }
+    if (!table || !pool) {
+      return -1;
+    }
+    const uint8_t *in = src.Data();
+    uint8_t *out = dst->Data();
+    auto rows = [&](int begin, int end) {
+      for (int y = begin; y < end; ++y) {
+        detail::RemapRow(in, *table, y, out + dst_step * y);
+      }
+    };
+    pool->ParallelFor(0, height, tile_rows, rows);
+    dst->channel_id = src.channel_id;
+    dst->time_stamp = src.time_stamp;
+    dst->frame_id = src.frame_id;
+    dst->type = src.type;
+    return 0;
+  }
+
+ private:
+  struct Side {
+    double k[4];
+    double dist[8];
+    /// 校正旋转 R 与新内参 Knew（P 的前三列），行优先
+    double r[9];
+    double knew[9];
+  };
+
+  static bool IsLumaFormat(PGPixelFormat format) {
+    return format == kPGPixelFormatRawGRAY || format == kPGPixelFormatRawNV12 ||
+           format == kPGPixelFormatRawNV21 || format == kPGPixelFormatRawI420 ||
+           format == kPGPixelFormatRawYV12;
+  }
+
+  static int ParseSide(const cv::Mat &m, const cv::Mat &d, const cv::Mat &r,
+                       const cv::Mat &p, Side *side) {
+    if (m.rows != 3 || m.cols != 3 || r.rows != 3 || r.cols != 3 ||
+        p.rows != 3 || p.cols < 3) {
+      return -1;
+    }
+    side->k[0] = m.at<double>(0, 0);
+    side->k[1] = m.at<double>(1, 1);
+    side->k[2] = m.at<double>(0, 2);
+    side->k[3] = m.at<double>(1, 2);
+    for (int i = 0; i < 8; ++i) {
+      side->dist[i] = i < static_cast<int>(d.total())
+                          ? reinterpret_cast<const double *>(d.data)[i]
+                          : 0;
+    }
+    for (int i = 0; i < 9; ++i) {
+      side->r[i] = r.at<double>(i / 3, i % 3);
+      side->knew[i] = p.at<double>(i / 3, i % 3);
+    }
+    return side->k[0] > 0 && side->k[1] > 0 ? 0 : -1;
+  }
+
+  /// 把内参从标定分辨率缩放到 width x height（像素中心对齐）
+  static void ScaleIntrinsics(double sx, double sy, double *fx, double *fy,
+                              double *cx, double *cy) {
+    *fx *= sx;
+    *fy *= sy;
+    *cx = (*cx + 0.5) * sx - 0.5;
+    *cy = (*cy + 0.5) * sy - 0.5;
+  }
+
+  std::shared_ptr<const detail::RemapTable> GetTable(StereoSide side,
+                                                     int width, int height,
+                                                     size_t step) {
+    int index = static_cast<int>(side);
+    if (width < 2 || height < 2 || index < 0 || index > 1) {
+      return nullptr;
+    }
+    Side params;
+    int calib_width = 0;
+    int calib_height = 0;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!ready_) {
+        return nullptr;
+      }
+      for (auto &entry : tables_) {
+        if (entry.side == index && entry.table->width == width &&
+            entry.table->height == height && entry.table->step == step) {
+          return entry.table;
+        }
+      }
+      params = sides_[index];
+      calib_width = calib_width_;
+      calib_height = calib_height_;
+    }
+    // 在锁外生成，同一分辨率并发首帧时可能重复生成一次，结果相同
+    double sx = calib_width > 0 ? static_cast<double>(width) / calib_width
+                                : 1.0;
+    double sy = calib_height > 0 ? static_cast<double>(height) / calib_height
+                                 : 1.0;
+    detail::RectifyCamera cam;
+    memcpy(cam.k, params.k, sizeof(cam.k));
+    memcpy(cam.dist, params.dist, sizeof(cam.dist));
+    ScaleIntrinsics(sx, sy, &cam.k[0], &cam.k[1], &cam.k[2], &cam.k[3]);
+    double knew[9];
+    memcpy(knew, params.knew, sizeof(knew));
+    ScaleIntrinsics(sx, sy, &knew[0], &knew[4], &knew[2], &knew[5]);
+    double kr[9];
+    for (int i = 0; i < 3; ++i) {
+      for (int j = 0; j < 3; ++j) {
+        kr[i * 3 + j] = knew[i * 3] * params.r[j] +
+                        knew[i * 3 + 1] * params.r[3 + j] +
+                        knew[i * 3 + 2] * params.r[6 + j];
+      }
+    }
+    if (!detail::Invert3x3(kr, cam.ir)) {
+      return nullptr;
+    }
+    auto table = std::make_shared<detail::RemapTable>();
+    detail::BuildRemapTable(cam, width, height, step, table.get());
+    std::lock_guard<std::mutex> lock(mutex_);
+    tables_.push_back(TableEntry{index, table});
+    return table;
+  }
+
+  struct TableEntry {
+    int side;
+    std::shared_ptr<const detail::RemapTable> table;
+  };
+
+  mutable std::mutex mutex_;
+  RectifierConfig config_;
+  bool ready_ = false;
+  Side sides_[2];
+  int calib_width_ = 0;
+  int calib_height_ = 0;
+  std::vector<TableEntry> tables_;
+  std::shared_ptr<utils::ThreadPool> pool_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_RECTIFY_HPP_
@@ -0,0 +1,661 @@
+/**
+ * @file vidar_replay.hpp
+ * @brief 从磁盘回放录制数据的 VidarInterface 实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_REPLAY_HPP_
+#define PG_VIDAR_REPLAY_HPP_
+
+#include <dirent.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgcodecs.hpp"
+#include "opencv2/imgproc.hpp"
+#include "pg/utils/frame_pool_group.hpp"
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/pace_clock.hpp"
+#include "pg/vidar_imu.hpp"
+#include "pg/vidar_interface.hpp"
+#include "pg/vidar_record_reader.hpp"
+#include "vision_type/image_frame_pool.hpp"
+
+namespace pg {
+namespace vidar {
+
+namespace detail {
+
+/// 读取整个文本文件，失败返回 -1
+inline int ReadFileToString(const std::string &file_name, std::string *out) {
+  FILE *fd = fopen(file_name.c_str(), "rb");
+  if (fd == nullptr) {
+    return -1;
+  }
+  out->clear();
+  char buf[4096];
+  size_t n = 0;
+  while ((n = fread(buf, 1, sizeof(buf), fd)) > 0) {
+    out->append(buf, n);
+  }
+  fclose(fd);
+  return 0;
+}
+
+/// 是否以 suffix 结尾
+inline bool EndsWith(const std::string &name, const std::string &suffix) {
+  return name.size() >= suffix.size() &&
+         name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+/// 解析 "<time_stamp>_ns_<channel_id>.png"
+inline bool ParseReplayFileName(const std::string &name, uint64_t *time_stamp,
+                                uint32_t *channel_id) {
+  unsigned long long ts = 0;
+  unsigned int ch = 0;
+  int consumed = 0;
+  if (sscanf(name.c_str(), "%llu_ns_%u.png%n", &ts, &ch, &consumed) != 2 ||
+      consumed != static_cast<int>(name.size())) {
+    return false;
+  }
+  *time_stamp = ts;
+  *channel_id = ch;
+  return true;
+}
+
+/**
+ * @brief  把解码后的图像拷贝进缓存池中的帧，可选转换为 target 格式
+ * @note   8 位图像支持转换为 GRAY/BGR/RGB/I420/YV12，YUV420 要求宽高为偶数；
+ * 16 位图像输出为 Int16（视差）
+ * @retval 输出帧，格式不支持时返回 nullptr
+ */
+inline phigent::vision::ImageFramePtr MatToFrame(
+    const cv::Mat &mat, PGPixelFormat target,
+    phigent::vision::ImageFramePool *pool) {
+  using namespace phigent::vision;
+  PGPixelFormat format = kPGPixelFormatNone;
+  int code = -1;
+  switch (mat.type()) {
+    case CV_16UC1:
+    case CV_16SC1:
+      format = kPGPixelFormatInt16;
+      break;
+    case CV_8UC1:
+      format = kPGPixelFormatRawGRAY;
+      if (target == kPGPixelFormatRawBGR) {
+        code = cv::COLOR_GRAY2BGR;
+      } else if (target == kPGPixelFormatRawRGB) {
+        code = cv::COLOR_GRAY2RGB;
+      }
+      break;
+    case CV_8UC3:
+      format = kPGPixelFormatRawBGR;
+      if (target == kPGPixelFormatRawGRAY) {
+        code = cv::COLOR_BGR2GRAY;
+      } else if (target == kPGPixelFormatRawRGB) {
+        code = cv::COLOR_BGR2RGB;
+      } else if (target == kPGPixelFormatRawI420) {
+        code = cv::COLOR_BGR2YUV_I420;
+      } else if (target == kPGPixelFormatRawYV12) {
+        code = cv::COLOR_BGR2YUV_YV12;
+      }
+      break;
+    case CV_8UC4:
+      format = kPGPixelFormatRawBGRA;
+      break;
+    default:
+      return nullptr;
+  }
+  bool yuv = code == cv::COLOR_BGR2YUV_I420 || code == cv::COLOR_BGR2YUV_YV12;
+  if (yuv && (mat.cols % 2 != 0 || mat.rows % 2 != 0)) {
+    code = -1;
+  }
+  if (code >= 0) {
+    format = target;
+  }
+  ImageFramePtr frame = pool->Acquire(format, mat.cols, mat.rows);
+  if (!frame) {
+    return nullptr;
+  }
+  if (yuv && code >= 0) {
+    // 宽高为偶数时 Y 与 UV 平面连续，与 OpenCV 的 YUV420 布局一致
+    cv::Mat out(mat.rows * 3 / 2, mat.cols, CV_8UC1, frame->Data());
+    cv::cvtColor(mat, out, code);
+    return frame;
+  }
+  // 16 位视差 PNG 读出为 CV_16UC1，按原类型包装，copyTo 才会直接写入帧
+  cv::Mat out(mat.rows, mat.cols,
+              format == kPGPixelFormatInt16
+                  ? mat.type()
+                  : CV_MAKETYPE(CV_8U, frame->Channel()),
+              frame->Data(), frame->Stride());
+  if (code >= 0) {
+    cv::cvtColor(mat, out, code);
+  } else {
+    mat.copyTo(out);
+  }
+  // 类型或尺寸不一致时 OpenCV 会重新分配，帧内容未写入
+  if (out.data != frame->Data()) {
+    return nullptr;
+  }
+  return frame;
+}
+
+/// 拷贝帧头，像素数据通过 DataBuffer_ 共享
+inline std::shared_ptr<phigent::vision::ImageFrameImpl> ShallowCopyFrame(
+    const phigent::vision::ImageFrameImpl &src) {
+  auto copy = std::make_shared<phigent::vision::ImageFrameImpl>();
+  copy->pixel_format = src.pixel_format;
+  copy->channel_id = src.channel_id;
+  copy->time_stamp = src.time_stamp;
+  copy->frame_id = src.frame_id;
+  copy->type = src.type;
+  copy->float_scale = src.float_scale;
+  copy->custom_data_addr = src.custom_data_addr;
+  copy->virt_data_addr = src.virt_data_addr;
+  copy->virt_uv_data_addr = src.virt_uv_data_addr;
+  copy->phy_data_addr = src.phy_data_addr;
+  copy->phy_uv_data_addr = src.phy_uv_data_addr;
+  copy->data_size = src.data_size;
+  copy->data_uv_size = src.data_uv_size;
+  copy->width = src.width;
+  copy->height = src.height;
+  copy->stride = src.stride;
+  copy->channel = src.channel;
+  copy->stride_uv = src.stride_uv;
+  copy->DataBuffer_ = src.DataBuffer_;
+  return copy;
+}
+
+/**
+ * 把 IMU 文本记录的时间戳（首个数值，与 ParseImuSample 的规则一致）加上
+ * offset，其余内容不变
+ */
+inline std::string ShiftImuTimeStamp(const std::string &text,
+                                     uint64_t offset) {
+  for (size_t i = 0; i < text.size(); ++i) {
+    char c = text[i];
+    bool digit = c >= '0' && c <= '9';
+    bool sign = (c == '-' || c == '+' || c == '.') && i + 1 < text.size() &&
+                text[i + 1] >= '0' && text[i + 1] <= '9';
+    if (!digit && !sign) {
+      continue;
+    }
+    if (!digit) {
+      return text;
+    }
+    size_t end = i;
+    uint64_t value = 0;
+    while (end < text.size() && text[end] >= '0' && text[end] <= '9') {
+      value = value * 10 + static_cast<uint64_t>(text[end] - '0');
+      ++end;
+    }
+    return text.substr(0, i) + std::to_string(value + offset) +
+           text.substr(end);
+  }
+  return text;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 回放配置，见 ReplayVidar
+ */
+struct ReplayConfig {
+  /// 录制目录
+  std::string path;
+  /// 回放倍速，<=0 表示不限速
+  double speed = 1.0;
+  bool loop = false;
+  bool preload = false;
+  /// kPGPixelFormatNone 表示不转换
+  PGPixelFormat pixel_format = kPGPixelFormatNone;
+  float disparity_scale = 1.0f;
+  /// 为空时回放全部通道
+  std::vector<int> channel_ids;
+};
+
+/**
+ * @brief 回放录制目录的 VidarInterface 实现，VidarInterface 类型名 "replay"
+ * @note 目录内容：
+ * 1. "<time_stamp>_ns_<channel_id>.png"：图像，与示例程序保存的文件名一致，
+ *    时间戳相同的图像在同一次 RecvData 中返回；8 位 1/3/4 通道分别输出为
+ *    GRAY/BGR/BGRA，16 位单通道输出为 Int16（视差）；
+ * 2. "imu.txt"：可选，每行一条 IMU 文本记录（格式见 ParseImuSample），
+ *    时间戳与图像为同一时钟，随第一组时间戳不早于它的图像返回；
+ * 3. "config.json"：可选，GetConfig 原样返回其内容；
+ * 4. "*.pgrec"：SessionRecorder 录制的分卷（见 vidar_record.hpp），其中的
+ *    图像与 IMU 与上面的文件一起按时间戳回放。图像直接引用映射内存，不做
+ *    pixel_format 转换，保留录制时的 frame_id（循环回放时每轮加上录制的
+ *    frame_id 跨度）。
+ *
+ * Init 配置：
+ * {
+ *    "replay": {
+ *        "path": "/data/session",
+ *        "speed": 1.0,            // 回放倍速，0 表示不限速
+ *        "loop": false,           // 播放完毕后从头开始，时间戳继续递增
+ *        "preload": false,        // Init 时解码全部图像，回放时不再解码
+ *        "pixel_format": "",      // 可选，转换为 gray/bgr/rgb/i420/yv12
+ *        "disparity_scale": 1.0,  // Int16 帧的 float_scale
+ *        "channel_id": [0, 1]     // 可选，只回放这些通道
+ *    },
+ *    "ImageFramePool": {...}      // 可选，各通道缓存池容量，默认 32，
+ *                                 // 格式见 FramePoolGroup::Init
+ * }
+ * RecvData 返回 0 成功，-1 参数错误或等待超时，-2 回放结束，-3 图像读取失败。
+ * UpdateConfig 可以修改 "speed" 与 "loop"。RecvData 线程安全但串行执行，
+ * 按时间戳等待期间不持有内部锁，不阻塞 GetConfig 与 Deinit。
+ */
+class ReplayVidar : public VidarInterface {
+ public:
+  ReplayVidar() = default;
+  ~ReplayVidar() override = default;
+
+  int Init(const string &conf_json) override {
+    cv::FileStorage fs;
+    if (utils::json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    ReplayConfig config;
+    if (ParseConfig(fs["replay"], &config) != 0 ||
+        pools_.Init(conf_json) != 0) {
+      return -1;
+    }
+    return Init(config);
+  }
+
+  /**
+   * @brief  直接使用结构体配置初始化
+   * @retval 0 成功，-1 目录不存在、没有可回放的数据或读取失败
+   */
+  int Init(const ReplayConfig &config) {
+    std::string path = config.path;
+    if (path.empty()) {
+      return -1;
+    }
+    if (path.back() != '/') {
+      path.push_back('/');
+    }
+    const std::vector<int> &channels = config.channel_ids;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClearLocked();
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+      return -1;
+    }
+    std::vector<Entry> entries;
+    std::vector<std::string> record_files;
+    uint64_t min_record_id = UINT64_MAX;
+    uint64_t max_record_id = 0;
+    while (struct dirent *ent = readdir(dir)) {
+      Entry entry;
+      if (detail::EndsWith(ent->d_name, kRecordFileSuffix)) {
+        record_files.push_back(path + ent->d_name);
+        continue;
+      }
+      if (!detail::ParseReplayFileName(ent->d_name, &entry.time_stamp,
+                                       &entry.channel_id)) {
+        continue;
+      }
+      if (!channels.empty() &&
+          std::find(channels.begin(), channels.end(),
+                    static_cast<int>(entry.channel_id)) == channels.end()) {
+        continue;
+      }
+      entry.file = path + ent->d_name;
+      entries.push_back(std::move(entry));
+    }
+    closedir(dir);
+    // 分卷按文件名（即录制顺序）打开
+    std::sort(record_files.begin(), record_files.end());
+    for (auto &file : record_files) {
+      std::unique_ptr<SessionReader> reader(new SessionReader());
+      if (reader->Open(file) != 0) {
+        ClearLocked();
+        return -1;
+      }
+      for (size_t i = 0; i < reader->Size(); ++i) {
+        const RecordIndexEntry &index = reader->Entry(i);
+        ImuRecord imu;
+        if (reader->ReadImu(i, &imu) == 0) {
+          imu_.push_back(ImuLine{index.time_stamp, imu.ToString()});
+          continue;
+        }
+        if (!channels.empty() &&
+            std::find(channels.begin(), channels.end(),
+                      static_cast<int>(index.channel_id)) == channels.end()) {
+          continue;
+        }
+        min_record_id = std::min(min_record_id, index.frame_id);
+        max_record_id = std::max(max_record_id, index.frame_id);
+        Entry entry;
+        entry.time_stamp = index.time_stamp;
+        entry.channel_id = index.channel_id;
+        entry.reader = static_cast<int>(readers_.size());
+        entry.record = i;
+        entries.push_back(std::move(entry));
+      }
+      readers_.push_back(std::move(reader));
+    }
+    if (entries.empty()) {
+      ClearLocked();
+      return -1;
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry &a, const Entry &b) {
+                return a.time_stamp != b.time_stamp
+                           ? a.time_stamp < b.time_stamp
+                           : a.channel_id < b.channel_id;
+              });
+    for (auto &entry : entries) {
+      if (groups_.empty() || groups_.back().time_stamp != entry.time_stamp) {
+        groups_.push_back(Group{entry.time_stamp, {}});
+      }
+      groups_.back().entries.push_back(std::move(entry));
+    }
+    LoadImuLocked(path + "imu.txt");
+    std::stable_sort(imu_.begin(), imu_.end(),
+                     [](const ImuLine &a, const ImuLine &b) {
+                       return a.time_stamp < b.time_stamp;
+                     });
+    if (detail::ReadFileToString(path + "config.json", &config_json_) != 0) {
+      config_json_.clear();
+    }
+    target_format_ = config.pixel_format;
+    disparity_scale_ = config.disparity_scale;
+    if (config.preload) {
+      for (auto &group : groups_) {
+        for (auto &entry : group.entries) {
+          entry.frame = LoadLocked(entry, &heap_pool_);
+          if (!entry.frame) {
+            ClearLocked();
+            return -1;
+          }
+        }
+      }
+    }
+    // 循环回放时两轮之间间隔一个平均帧间隔
+    uint64_t span = groups_.back().time_stamp - groups_.front().time_stamp;
+    loop_span_ = span + (groups_.size() > 1 ? span / (groups_.size() - 1) : 0);
+    record_id_span_ =
+        min_record_id <= max_record_id ? max_record_id - min_record_id + 1 : 0;
+    speed_.store(config.speed);
+    loop_.store(config.loop);
+    inited_ = true;
+    return 0;
+  }
+
+  int Deinit() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ClearLocked();
+    return 0;
+  }
+
+  int RecvData(VidarData *data, int timeout_ms) override {
+    if (data == nullptr) {
+      return -1;
+    }
+    // clock_ 只在持有 recv_mutex_ 时访问，等待期间释放 mutex_
+    std::lock_guard<std::mutex> recv_lock(recv_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!inited_) {
+      return -1;
+    }
+    data->images.clear();
+    data->imu.clear();
+    if (next_ >= groups_.size()) {
+      if (!loop_.load()) {
+        return -2;
+      }
+      next_ = 0;
+      next_imu_ = 0;
+      loop_offset_ += loop_span_;
+      ++loop_count_;
+    }
+    double speed = speed_.load();
+    if (clock_generation_ != generation_) {
+      clock_.Reset(speed);
+      clock_generation_ = generation_;
+    } else if (speed != clock_.Speed()) {
+      clock_.SetSpeed(speed);
+    }
+    uint64_t generation = generation_;
+    uint64_t due = groups_[next_].time_stamp + loop_offset_;
+    lock.unlock();
+    bool ready = clock_.WaitUntil(due, timeout_ms);
+    lock.lock();
+    // 等待期间被 Init/Deinit 重置
+    if (!ready || !inited_ || generation_ != generation) {
+      return -1;
+    }
+    Group &group = groups_[next_];
+    while (next_imu_ < imu_.size() &&
+           imu_[next_imu_].time_stamp <= group.time_stamp) {
+      const std::string &text = imu_[next_imu_++].text;
+      // 与图像时间戳一致，循环回放时 IMU 也加上 loop_offset_
+      data->imu.push_back(loop_offset_ == 0
+                              ? text
+                              : detail::ShiftImuTimeStamp(text, loop_offset_));
+    }
+    ++next_;
+    for (auto &entry : group.entries) {
+      phigent::vision::ImageFramePtr frame;
+      if (entry.frame) {
+        // 共享像素数据，帧头各自独立，调用者持有的上一轮帧不受影响
+        frame = detail::ShallowCopyFrame(
+            *static_cast<phigent::vision::ImageFrameImpl *>(entry.frame.get()));
+      } else {
+        frame = LoadLocked(entry, pools_.Get(entry.channel_id).get());
+      }
+      if (!frame) {
+        return -3;
+      }
+      frame->time_stamp = entry.time_stamp + loop_offset_;
+      if (entry.reader < 0) {
+        frame->frame_id = frame_id_;
+      } else {
+        frame->frame_id += loop_count_ * record_id_span_;
+      }
+      data->images.push_back(frame);
+    }
+    ++frame_id_;
+    return 0;
+  }
+
+  int UpdateConfig(const std::string &conf_json) override {
+    cv::FileStorage fs;
+    if (utils::json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    cv::FileNode node = fs["replay"];
+    if (node.empty()) {
+      return -1;
+    }
+    speed_.store(utils::json::GetDouble(node["speed"], speed_.load()));
+    loop_.store(utils::json::GetBool(node["loop"], loop_.load()));
+    return 0;
+  }
+
+  /**
+   * @brief  返回录制目录中的 config.json
+   * @retval 0 成功，1 录制中没有相机信息，-1 未初始化
+   */
+  int GetConfig(const std::string & /* conf_json */,
+                std::string &return_conf_json) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inited_) {
+      return -1;
+    }
+    if (config_json_.empty()) {
+      return 1;
+    }
+    return_conf_json = config_json_;
+    return 0;
+  }
+
+  /**
+   * @brief  解析 "replay" 配置节点
+   * @retval 0 成功，-1 缺少 path 或格式名无效
+   */
+  static int ParseConfig(const cv::FileNode &node, ReplayConfig *config) {
+    if (node.empty()) {
+      return -1;
+    }
+    config->path = utils::json::GetString(node["path"], "");
+    if (config->path.empty()) {
+      return -1;
+    }
+    std::string name = utils::json::GetString(node["pixel_format"], "");
+    if (!name.empty() && phigent::vision::StrCvtPixelFormat(
+                             config->pixel_format, name, false) != 0) {
+      return -1;
+    }
+    config->speed = utils::json::GetDouble(node["speed"], config->speed);
+    config->loop = utils::json::GetBool(node["loop"], config->loop);
+    config->preload = utils::json::GetBool(node["preload"], config->preload);
+    config->disparity_scale = static_cast<float>(utils::json::GetDouble(
+        node["disparity_scale"], config->disparity_scale));
+    config->channel_ids = utils::json::GetIntArray(node["channel_id"]);
+    return 0;
+  }
+
+  /// 回放的数据组数（每组为时间戳相同的图像）
+  size_t NumGroups() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return groups_.size();
+  }
+
+  /// 各通道输出帧缓存池的统计信息
+  std::map<uint32_t, phigent::vision::ImageFramePoolStats> FramePoolStats()
+      const {
+    return pools_.Stats();
+  }
+
+ private:
+  struct Entry {
+    uint64_t time_stamp = 0;
+    uint32_t channel_id = 0;
+    std::string file;
+    /// 来自 .pgrec 时为 readers_ 下标与记录下标
+    int reader = -1;
+    size_t record = 0;
+    /// preload 时解码的图像，各轮回放共享像素数据
+    phigent::vision::ImageFramePtr frame;
+  };
+  struct Group {
+    uint64_t time_stamp;
+    std::vector<Entry> entries;
+  };
+  struct ImuLine {
+    uint64_t time_stamp;
+    std::string text;
+  };
+
+  void ClearLocked() {
+    inited_ = false;
+    groups_.clear();
+    imu_.clear();
+    readers_.clear();
+    config_json_.clear();
+    next_ = 0;
+    next_imu_ = 0;
+    loop_offset_ = 0;
+    loop_count_ = 0;
+    record_id_span_ = 0;
+    frame_id_ = 0;
+    ++generation_;
+  }
+
+  void LoadImuLocked(const std::string &file_name) {
+    std::string text;
+    if (detail::ReadFileToString(file_name, &text) != 0) {
+      return;
+    }
+    size_t begin = 0;
+    while (begin < text.size()) {
+      size_t end = text.find('\n', begin);
+      if (end == std::string::npos) {
+        end = text.size();
+      }
+      ImuSample sample;
+      if (ParseImuSample(text.data() + begin, end - begin, ImuFormat::kText,
+                         &sample) == 0) {
+        imu_.push_back(ImuLine{sample.time_stamp,
+                               text.substr(begin, end - begin)});
+      }
+      begin = end + 1;
+    }
+  }
+
+  phigent::vision::ImageFramePtr LoadLocked(
+      const Entry &entry, phigent::vision::ImageFramePool *pool) {
+    if (entry.reader >= 0) {
+      return readers_[entry.reader]->ReadFrame(entry.record);
+    }
+    cv::Mat mat = cv::imread(entry.file, cv::IMREAD_UNCHANGED);
+    if (mat.empty()) {
+      return nullptr;
+    }
+    phigent::vision::ImageFramePtr frame =
+        detail::MatToFrame(mat, target_format_, pool);
+    if (!frame) {
+      return nullptr;
+    }
+    frame->channel_id = entry.channel_id;
+    frame->time_stamp = entry.time_stamp;
+    if (frame->pixel_format == kPGPixelFormatInt16) {
+      frame->float_scale = disparity_scale_;
+    }
+    return frame;
+  }
+
+  /// 串行化 RecvData，保护 clock_ 与 clock_generation_
+  std::mutex recv_mutex_;
+  std::mutex mutex_;
+  bool inited_ = false;
+  /// 每次 Init/Deinit 递增，RecvData 据此重置 clock_ 并检测等待期间的重置
+  uint64_t generation_ = 0;
+  uint64_t clock_generation_ = 0;
+  std::vector<Group> groups_;
+  std::vector<ImuLine> imu_;
+  std::vector<std::unique_ptr<SessionReader>> readers_;
+  std::string config_json_;
+  PGPixelFormat target_format_ = kPGPixelFormatNone;
+  float disparity_scale_ = 1.0f;
+  size_t next_ = 0;
+  size_t next_imu_ = 0;
+  uint64_t loop_span_ = 0;
+  uint64_t loop_offset_ = 0;
+  /// 已完成的循环次数与 .pgrec 帧号跨度，循环回放时录制的 frame_id 每轮
+  /// 加上 loop_count_ * record_id_span_
+  uint64_t loop_count_ = 0;
+  uint64_t record_id_span_ = 0;
+  uint64_t frame_id_ = 0;
+  std::atomic<double> speed_{1.0};
+  std::atomic<bool> loop_{false};
+  utils::PaceClock clock_;
+  utils::FramePoolGroup pools_{32};
+  /// preload 的帧长期持有，容量为 0 即直接分配，不占用 pools_
+  phigent::vision::ImageFramePool heap_pool_{0};
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_REPLAY_HPP_
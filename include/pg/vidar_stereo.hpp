@@ -0,0 +1,1045 @@
+/**
+ * @file vidar_stereo.hpp
+ * @brief 主机端双目匹配：census 代价与半全局（SGM）聚合
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_STEREO_HPP_
+#define PG_VIDAR_STEREO_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "pg/utils/thread_pool.hpp"
+#include "vision_type/image_frame_pool.hpp"
+#include "vision_type/simd_dispatch.hpp"
+
+namespace pg {
+namespace vidar {
+
+struct StereoMatcherConfig {
+  /// 最小视差（像素），不小于 0
+  int min_disparity = 0;
+  /// 视差搜索范围（像素），16 的倍数，不超过 256
+  int num_disparities = 128;
+  /// 相邻点视差相差 1 的惩罚，census 代价范围为 0 ~ 62
+  int p1 = 8;
+  /// 相邻点视差相差大于 1 的惩罚，须大于 p1
+  int p2 = 96;
+  /// 除水平与竖直方向外，是否聚合两条向下的对角路径
+  bool diagonal_paths = true;
+  /// 唯一性检查（百分比），次优代价须比最优高出该比例，0 表示不检查
+  int uniqueness_ratio = 10;
+  /// 左右一致性检查允许的视差差（像素），小于 0 表示不检查
+  int lr_max_diff = 1;
+  /// 是否按抛物线拟合输出亚像素视差
+  bool subpixel = true;
+  /// 输出 Int16 视差的 float_scale，与板端一致，1 / float_scale 须为整数
+  float disparity_scale = 1.0f / 16;
+  /// 每个行带向上多聚合的行数，用于预热竖直与对角路径
+  int band_overlap = 32;
+  /// 行带的并行度，0 表示 std::thread::hardware_concurrency()
+  int num_threads = 0;
+};
+
+namespace detail {
+
+/*
+ * census 窗口 9x7，中心以外 62 个邻点，邻点小于中心时该位为 1，
+ * 位序为窗口内先行后列。匹配代价为左右 census 的汉明距离
+ */
+constexpr int kCensusWidth = 9;
+constexpr int kCensusHeight = 7;
+constexpr int kCensusBits = kCensusWidth * kCensusHeight - 1;
+/// 右图超出左边界的视差使用最大代价
+constexpr uint8_t kMaxMatchCost = kCensusBits;
+/// 聚合缓冲中每个点前后的填充，填充值为 0xFFFF，d - 1 与 d + 1 无需判断
+constexpr int kSgmPad = 8;
+
+inline int Popcount64(uint64_t v) {
+  v = v - ((v >> 1) & 0x5555555555555555ull);
+  v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return static_cast<int>((v * 0x0101010101010101ull) >> 56);
+}
+
+inline uint64_t CensusPixel(const uint8_t *const *rows, int width, int x) {
+  const int hw = kCensusWidth / 2;
+  uint8_t center = rows[kCensusHeight / 2][x];
+  uint64_t bits = 0;
+  int bit = 0;
+  for (int dy = 0; dy < kCensusHeight; ++dy) {
+    for (int dx = -hw; dx <= hw; ++dx) {
+      if (dy == kCensusHeight / 2 && dx == 0) {
+        continue;
+      }
+      int nx = std::min(std::max(x + dx, 0), width - 1);
+      if (rows[dy][nx] < center) {
+        bits |= 1ull << bit;
+      }
+      ++bit;
+    }
+  }
+  return bits;
+}
+
+/// 计算一行 [begin, end) 的 census，rows 为窗口内各行（越界的行已钳位）
+inline void CensusRowScalar(const uint8_t *const *rows, int width, int begin,
+                            int end, uint64_t *out) {
+  for (int x = begin; x < end; ++x) {
+    out[x] = CensusPixel(rows, width, x);
+  }
+}
+
+#if defined(PG_SIMD_X86)
+/// 16 个点一组：每个邻点的比较结果按位或入 8 个字节累加器，再转置为 uint64
+PG_TARGET_SSE41 inline void CensusRowSse41(const uint8_t *const *rows,
+                                           int width, uint64_t *out) {
+  const int hw = kCensusWidth / 2;
+  const __m128i sign = _mm_set1_epi8(static_cast<char>(0x80));
+  int x = 0;
+  int end = width - hw - 16;
+  CensusRowScalar(rows, width, 0, std::min(hw, width), out);
+  for (x = hw; x <= end; x += 16) {
+    __m128i center = _mm_xor_si128(
+        _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(rows[kCensusHeight / 2] + x)),
+        sign);
+    __m128i acc[8];
+    for (auto &a : acc) {
+      a = _mm_setzero_si128();
+    }
+    int bit = 0;
+    for (int dy = 0; dy < kCensusHeight; ++dy) {
+      for (int dx = -hw; dx <= hw; ++dx) {
+        if (dy == kCensusHeight / 2 && dx == 0) {
+          continue;
+        }
+        __m128i n = _mm_xor_si128(
+            _mm_loadu_si128(
+                reinterpret_cast<const __m128i *>(rows[dy] + x + dx)),
+            sign);
+        __m128i less = _mm_cmpgt_epi8(center, n);
+        acc[bit >> 3] = _mm_or_si128(
+            acc[bit >> 3],
+            _mm_and_si128(less, _mm_set1_epi8(static_cast<char>(
+                                    1 << (bit & 7)))));
+        ++bit;
+      }
+    }
+    __m128i t0 = _mm_unpacklo_epi8(acc[0], acc[1]);
+    __m128i t1 = _mm_unpackhi_epi8(acc[0], acc[1]);
+    __m128i t2 = _mm_unpacklo_epi8(acc[2], acc[3]);
+    __m128i t3 = _mm_unpackhi_epi8(acc[2], acc[3]);
+    __m128i t4 = _mm_unpacklo_epi8(acc[4], acc[5]);
+    __m128i t5 = _mm_unpackhi_epi8(acc[4], acc[5]);
+    __m128i t6 = _mm_unpacklo_epi8(acc[6], acc[7]);
+    __m128i t7 = _mm_unpackhi_epi8(acc[6], acc[7]);
+    __m128i q[4] = {_mm_unpacklo_epi16(t0, t2), _mm_unpackhi_epi16(t0, t2),
+                    _mm_unpacklo_epi16(t1, t3), _mm_unpackhi_epi16(t1, t3)};
+    __m128i r[4] = {_mm_unpacklo_epi16(t4, t6), _mm_unpackhi_epi16(t4, t6),
+                    _mm_unpacklo_epi16(t5, t7), _mm_unpackhi_epi16(t5, t7)};
+    __m128i *dst = reinterpret_cast<__m128i *>(out + x);
+    for (int k = 0; k < 4; ++k) {
+      _mm_storeu_si128(dst + 2 * k, _mm_unpacklo_epi32(q[k], r[k]));
+      _mm_storeu_si128(dst + 2 * k + 1, _mm_unpackhi_epi32(q[k], r[k]));
+    }
+  }
+  CensusRowScalar(rows, width, std::max(x, std::min(hw, width)), width, out);
+}
+#endif
+
+#if defined(PG_SIMD_NEON)
+inline void CensusRowNeon(const uint8_t *const *rows, int width,
+                          uint64_t *out) {
+  const int hw = kCensusWidth / 2;
+  int x = 0;
+  int end = width - hw - 16;
+  CensusRowScalar(rows, width, 0, std::min(hw, width), out);
+  for (x = hw; x <= end; x += 16) {
+    uint8x16_t center = vld1q_u8(rows[kCensusHeight / 2] + x);
+    uint8x16_t acc[8];
+    for (auto &a : acc) {
+      a = vdupq_n_u8(0);
+    }
+    int bit = 0;
+    for (int dy = 0; dy < kCensusHeight; ++dy) {
+      for (int dx = -hw; dx <= hw; ++dx) {
+        if (dy == kCensusHeight / 2 && dx == 0) {
+          continue;
+        }
+        uint8x16_t less = vcltq_u8(vld1q_u8(rows[dy] + x + dx), center);
+        acc[bit >> 3] = vorrq_u8(
+            acc[bit >> 3],
+            vandq_u8(less, vdupq_n_u8(static_cast<uint8_t>(1 << (bit & 7)))));
+        ++bit;
+      }
+    }
+    // 与 SSE 相同的 8x16 字节转置
+    uint8x16x2_t t01 = vzipq_u8(acc[0], acc[1]);
+    uint8x16x2_t t23 = vzipq_u8(acc[2], acc[3]);
+    uint8x16x2_t t45 = vzipq_u8(acc[4], acc[5]);
+    uint8x16x2_t t67 = vzipq_u8(acc[6], acc[7]);
+    for (int h = 0; h < 2; ++h) {
+      uint16x8x2_t q = vzipq_u16(vreinterpretq_u16_u8(t01.val[h]),
+                                 vreinterpretq_u16_u8(t23.val[h]));
+      uint16x8x2_t r = vzipq_u16(vreinterpretq_u16_u8(t45.val[h]),
+                                 vreinterpretq_u16_u8(t67.val[h]));
+      for (int k = 0; k < 2; ++k) {
+        uint32x4x2_t o = vzipq_u32(vreinterpretq_u32_u16(q.val[k]),
+                                   vreinterpretq_u32_u16(r.val[k]));
+        uint64_t *dst = out + x + 8 * h + 4 * k;
+        vst1q_u64(dst, vreinterpretq_u64_u32(o.val[0]));
+        vst1q_u64(dst + 2, vreinterpretq_u64_u32(o.val[1]));
+      }
+    }
+  }
+  CensusRowScalar(rows, width, std::max(x, std::min(hw, width)), width, out);
+}
+#endif
+
+/// 计算第 y 行的 census
+inline void CensusRow(const uint8_t *image, size_t step, int width,
+                      int height, int y, uint64_t *out) {
+  const uint8_t *rows[kCensusHeight];
+  for (int dy = 0; dy < kCensusHeight; ++dy) {
+    int ry = std::min(std::max(y + dy - kCensusHeight / 2, 0), height - 1);
+    rows[dy] = image + step * ry;
+  }
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+    case phigent::vision::SimdLevel::kSse41:
+      CensusRowSse41(rows, width, out);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case phigent::vision::SimdLevel::kNeon:
+      CensusRowNeon(rows, width, out);
+      return;
+#endif
+    default:
+      CensusRowScalar(rows, width, 0, width, out);
+      return;
+  }
+}
+
+/**
+ * 一行的匹配代价，cost[x * D + k] 为左图 x 与右图 x - min_d - k 的距离。
+ * 右图 census 按行反序存放（rev[i] = right[width - 1 - i]），
+ * 同一 x 的连续视差在内存中连续
+ */
+inline void CostPixelScalar(uint64_t left, const uint64_t *rev, int x,
+                            int width, int min_d, int num_d, uint8_t *cost) {
+  for (int k = 0; k < num_d; ++k) {
+    int xr = x - min_d - k;
+    cost[k] = xr < 0 ? kMaxMatchCost
+                     : static_cast<uint8_t>(Popcount64(left ^ rev[width - 1 -
+                                                                 xr]));
+  }
+}
+
+inline void CostRowScalar(const uint64_t *left, const uint64_t *rev,
+                          int width, int min_d, int num_d, uint8_t *cost) {
+  for (int x = 0; x < width; ++x) {
+    CostPixelScalar(left[x], rev, x, width, min_d, num_d,
+                    cost + static_cast<size_t>(x) * num_d);
+  }
+}
+
+#if defined(PG_SIMD_X86)
+/// 每个 64 位元素的置位数，结果在各 64 位元素的低 16 位
+PG_TARGET_SSE41 inline __m128i Popcount64Sse41(__m128i v) {
+  const __m128i lut =
+      _mm_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m128i low = _mm_set1_epi8(0x0F);
+  __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, low));
+  __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), low));
+  return _mm_sad_epu8(_mm_add_epi8(lo, hi), _mm_setzero_si128());
+}
+
+PG_TARGET_SSE41 inline void CostRowSse41(const uint64_t *left,
+                                         const uint64_t *rev, int width,
+                                         int min_d, int num_d,
+                                         uint8_t *cost) {
+  // s_j 的两个元素为视差 k + 2j 与 k + 2j + 1，合并后按 order 恢复顺序
+  const __m128i order =
+      _mm_setr_epi8(0, 2, 1, 3, 4, 6, 5, 7, 8, 8, 8, 8, 8, 8, 8, 8);
+  for (int x = 0; x < width; ++x) {
+    uint8_t *out = cost + static_cast<size_t>(x) * num_d;
+    if (x < min_d + num_d - 1) {
+      CostPixelScalar(left[x], rev, x, width, min_d, num_d, out);
+      continue;
+    }
+    const uint64_t *base = rev + (width - 1 - x + min_d);
+    __m128i l = _mm_set1_epi64x(static_cast<int64_t>(left[x]));
+    for (int k = 0; k < num_d; k += 8) {
+      __m128i s[4];
+      for (int j = 0; j < 4; ++j) {
+        s[j] = Popcount64Sse41(_mm_xor_si128(
+            l, _mm_loadu_si128(
+                   reinterpret_cast<const __m128i *>(base + k + 2 * j))));
+      }
+      __m128i t = _mm_or_si128(s[0], _mm_slli_epi64(s[1], 32));
+      __m128i u = _mm_or_si128(s[2], _mm_slli_epi64(s[3], 32));
+      __m128i w = _mm_packus_epi32(t, u);
+      w = _mm_shuffle_epi8(_mm_packus_epi16(w, w), order);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(out + k), w);
+    }
+  }
+}
+
+PG_TARGET_AVX2 inline void CostRowAvx2(const uint64_t *left,
+                                       const uint64_t *rev, int width,
+                                       int min_d, int num_d, uint8_t *cost) {
+  const __m256i lut = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2,
+                                       3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2,
+                                       2, 3, 2, 3, 3, 4);
+  const __m256i low = _mm256_set1_epi8(0x0F);
+  // s_j 的 4 个元素为视差 k + 4j ~ k + 4j + 3，合并后按 order 恢复顺序
+  const __m128i order =
+      _mm_setr_epi8(0, 2, 8, 10, 1, 3, 9, 11, 4, 6, 12, 14, 5, 7, 13, 15);
+  for (int x = 0; x < width; ++x) {
+    uint8_t *out = cost + static_cast<size_t>(x) * num_d;
+    if (x < min_d + num_d - 1) {
+      CostPixelScalar(left[x], rev, x, width, min_d, num_d, out);
+      continue;
+    }
+    const uint64_t *base = rev + (width - 1 - x + min_d);
+    __m256i l = _mm256_set1_epi64x(static_cast<int64_t>(left[x]));
+    for (int k = 0; k < num_d; k += 16) {
+      __m256i s[4];
+      for (int j = 0; j < 4; ++j) {
+        __m256i v = _mm256_xor_si256(
+            l, _mm256_loadu_si256(
+                   reinterpret_cast<const __m256i *>(base + k + 4 * j)));
+        __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, low));
+        __m256i hi = _mm256_shuffle_epi8(
+            lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+        s[j] = _mm256_sad_epu8(_mm256_add_epi8(lo, hi),
+                               _mm256_setzero_si256());
+      }
+      __m256i t = _mm256_or_si256(s[0], _mm256_slli_epi64(s[1], 32));
+      __m256i u = _mm256_or_si256(s[2], _mm256_slli_epi64(s[3], 32));
+      __m256i w = _mm256_packus_epi32(t, u);
+      w = _mm256_permute4x64_epi64(_mm256_packus_epi16(w, w), 0x08);
+      _mm_storeu_si128(
+          reinterpret_cast<__m128i *>(out + k),
+          _mm_shuffle_epi8(_mm256_castsi256_si128(w), order));
+    }
+  }
+}
+#endif
+
+#if defined(PG_SIMD_NEON)
+/// 相邻字节两两相加，a 的结果在前
+inline uint8x16_t PairwiseAddNeon(uint8x16_t a, uint8x16_t b) {
+#if defined(__aarch64__)
+  return vpaddq_u8(a, b);
+#else
+  return vcombine_u8(vpadd_u8(vget_low_u8(a), vget_high_u8(a)),
+                     vpadd_u8(vget_low_u8(b), vget_high_u8(b)));
+#endif
+}
+
+inline void CostRowNeon(const uint64_t *left, const uint64_t *rev, int width,
+                        int min_d, int num_d, uint8_t *cost) {
+  for (int x = 0; x < width; ++x) {
+    uint8_t *out = cost + static_cast<size_t>(x) * num_d;
+    if (x < min_d + num_d - 1) {
+      CostPixelScalar(left[x], rev, x, width, min_d, num_d, out);
+      continue;
+    }
+    const uint64_t *base = rev + (width - 1 - x + min_d);
+    uint64x2_t l = vdupq_n_u64(left[x]);
+    for (int k = 0; k < num_d; k += 16) {
+      uint8x16_t c[8];
+      for (int j = 0; j < 8; ++j) {
+        c[j] = vcntq_u8(
+            vreinterpretq_u8_u64(veorq_u64(l, vld1q_u64(base + k + 2 * j))));
+      }
+      // 三次两两相加后每个字节为一个 64 位元素的置位数，顺序不变
+      for (int j = 0; j < 4; ++j) {
+        c[j] = PairwiseAddNeon(c[2 * j], c[2 * j + 1]);
+      }
+      c[0] = PairwiseAddNeon(c[0], c[1]);
+      c[1] = PairwiseAddNeon(c[2], c[3]);
+      vst1q_u8(out + k, PairwiseAddNeon(c[0], c[1]));
+    }
+  }
+}
+#endif
+
+inline void CostRow(const uint64_t *left, const uint64_t *rev, int width,
+                    int min_d, int num_d, uint8_t *cost) {
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+      CostRowAvx2(left, rev, width, min_d, num_d, cost);
+      return;
+    case phigent::vision::SimdLevel::kSse41:
+      CostRowSse41(left, rev, width, min_d, num_d, cost);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case phigent::vision::SimdLevel::kNeon:
+      CostRowNeon(left, rev, width, min_d, num_d, cost);
+      return;
+#endif
+    default:
+      CostRowScalar(left, rev, width, min_d, num_d, cost);
+      return;
+  }
+}
+
+/**
+ * 沿一条路径聚合一个点：
+ * L(d) = C(d) + min(Lp(d), Lp(d - 1) + P1, Lp(d + 1) + P1, min Lp + P2)
+ *        - min Lp
+ * prev 为路径上前一点的 L，prev[-1] 与 prev[D] 为填充值 0xFFFF；
+ * sum 不为空时累加到 sum（first 为 true 时直接写入）。返回 min L
+ */
+struct SgmStep {
+  const uint8_t *cost;
+  const uint16_t *prev;
+  uint16_t prev_min;
+  uint16_t *cur;
+  uint16_t *sum;
+  bool first;
+};
+
+inline uint16_t AggregateScalar(const SgmStep &s, int num_d, int p1, int p2) {
+  int jump = s.prev_min + p2;
+  int min_l = 0xFFFF;
+  for (int d = 0; d < num_d; ++d) {
+    int t = std::min(std::min(static_cast<int>(s.prev[d]), jump),
+                     std::min(s.prev[d - 1], s.prev[d + 1]) + p1);
+    int l = s.cost[d] + t - s.prev_min;
+    s.cur[d] = static_cast<uint16_t>(l);
+    min_l = std::min(min_l, l);
+    if (s.sum != nullptr) {
+      s.sum[d] = static_cast<uint16_t>(s.first ? l : s.sum[d] + l);
+    }
+  }
+  return static_cast<uint16_t>(min_l);
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline uint16_t AggregateSse41(const SgmStep &s, int num_d,
+                                               int p1, int p2) {
+  const __m128i vp1 = _mm_set1_epi16(static_cast<int16_t>(p1));
+  const __m128i jump = _mm_set1_epi16(static_cast<int16_t>(s.prev_min + p2));
+  const __m128i base = _mm_set1_epi16(static_cast<int16_t>(s.prev_min));
+  __m128i min_l = _mm_set1_epi16(-1);
+  for (int d = 0; d < num_d; d += 8) {
+    __m128i c = _mm_cvtepu8_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(s.cost + d)));
+    __m128i lp = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.prev + d));
+    __m128i lm =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.prev + d - 1));
+    __m128i lq =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.prev + d + 1));
+    __m128i t = _mm_min_epu16(_mm_adds_epu16(lm, vp1), _mm_adds_epu16(lq, vp1));
+    t = _mm_min_epu16(_mm_min_epu16(t, lp), jump);
+    __m128i l = _mm_add_epi16(c, _mm_sub_epi16(t, base));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(s.cur + d), l);
+    min_l = _mm_min_epu16(min_l, l);
+    if (s.sum != nullptr) {
+      __m128i *sum = reinterpret_cast<__m128i *>(s.sum + d);
+      _mm_storeu_si128(sum, s.first ? l
+                                    : _mm_add_epi16(_mm_loadu_si128(sum), l));
+    }
+  }
+  return static_cast<uint16_t>(_mm_extract_epi16(_mm_minpos_epu16(min_l), 0));
+}
+
+PG_TARGET_AVX2 inline uint16_t AggregateAvx2(const SgmStep &s, int num_d,
+                                             int p1, int p2) {
+  const __m256i vp1 = _mm256_set1_epi16(static_cast<int16_t>(p1));
+  const __m256i jump =
+      _mm256_set1_epi16(static_cast<int16_t>(s.prev_min + p2));
+  const __m256i base = _mm256_set1_epi16(static_cast<int16_t>(s.prev_min));
+  __m256i min_l = _mm256_set1_epi16(-1);
+  for (int d = 0; d < num_d; d += 16) {
+    __m256i c = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.cost + d)));
+    __m256i lp =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.prev + d));
+    __m256i lm =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.prev + d - 1));
+    __m256i lq =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s.prev + d + 1));
+    __m256i t = _mm256_min_epu16(_mm256_adds_epu16(lm, vp1),
+                                 _mm256_adds_epu16(lq, vp1));
+    t = _mm256_min_epu16(_mm256_min_epu16(t, lp), jump);
+    __m256i l = _mm256_add_epi16(c, _mm256_sub_epi16(t, base));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(s.cur + d), l);
+    min_l = _mm256_min_epu16(min_l, l);
+    if (s.sum != nullptr) {
+      __m256i *sum = reinterpret_cast<__m256i *>(s.sum + d);
+      _mm256_storeu_si256(
+          sum, s.first ? l : _mm256_add_epi16(_mm256_loadu_si256(sum), l));
+    }
+  }
+  __m128i m = _mm_min_epu16(_mm256_castsi256_si128(min_l),
+                            _mm256_extracti128_si256(min_l, 1));
+  return static_cast<uint16_t>(_mm_extract_epi16(_mm_minpos_epu16(m), 0));
+}
+#endif
+
+#if defined(PG_SIMD_NEON)
+inline uint16_t MinNeon(uint16x8_t v) {
+  uint16x4_t m = vmin_u16(vget_low_u16(v), vget_high_u16(v));
+  m = vpmin_u16(m, m);
+  m = vpmin_u16(m, m);
+  return vget_lane_u16(m, 0);
+}
+
+inline uint16_t AggregateNeon(const SgmStep &s, int num_d, int p1, int p2) {
+  const uint16x8_t vp1 = vdupq_n_u16(static_cast<uint16_t>(p1));
+  const uint16x8_t jump = vdupq_n_u16(static_cast<uint16_t>(s.prev_min + p2));
+  const uint16x8_t base = vdupq_n_u16(s.prev_min);
+  uint16x8_t min_l = vdupq_n_u16(0xFFFF);
+  for (int d = 0; d < num_d; d += 8) {
+    uint16x8_t c = vmovl_u8(vld1_u8(s.cost + d));
+    uint16x8_t t = vminq_u16(vqaddq_u16(vld1q_u16(s.prev + d - 1), vp1),
+                             vqaddq_u16(vld1q_u16(s.prev + d + 1), vp1));
+    t = vminq_u16(vminq_u16(t, vld1q_u16(s.prev + d)), jump);
+    uint16x8_t l = vaddq_u16(c, vsubq_u16(t, base));
+    vst1q_u16(s.cur + d, l);
+    min_l = vminq_u16(min_l, l);
+    if (s.sum != nullptr) {
+      vst1q_u16(s.sum + d, s.first ? l : vaddq_u16(vld1q_u16(s.sum + d), l));
+    }
+  }
+  return MinNeon(min_l);
+}
+#endif
+
+inline uint16_t Aggregate(const SgmStep &s, int num_d, int p1, int p2) {
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+      return AggregateAvx2(s, num_d, p1, p2);
+    case phigent::vision::SimdLevel::kSse41:
+      return AggregateSse41(s, num_d, p1, p2);
+#endif
+#if defined(PG_SIMD_NEON)
+    case phigent::vision::SimdLevel::kNeon:
+      return AggregateNeon(s, num_d, p1, p2);
+#endif
+    default:
+      return AggregateScalar(s, num_d, p1, p2);
+  }
+}
+
+/**
+ * 赢家通吃：返回代价和最小的视差下标（相同时取较小的视差），
+ * unique 为除最优及其相邻视差外没有代价和不大于 threshold 的视差
+ */
+inline int SelectDisparityScalar(const uint16_t *sum, int num_d,
+                                 int uniqueness, bool *unique) {
+  int best = 0;
+  for (int d = 1; d < num_d; ++d) {
+    if (sum[d] < sum[best]) {
+      best = d;
+    }
+  }
+  *unique = true;
+  if (uniqueness > 0 && sum[best] > 0) {
+    // sum * (100 - ratio) < best * 100 即 sum <= threshold
+    int threshold = (sum[best] * 100 - 1) / (100 - uniqueness);
+    for (int d = 0; d < num_d; ++d) {
+      if (std::abs(d - best) > 1 && sum[d] <= threshold) {
+        *unique = false;
+        break;
+      }
+    }
+  }
+  return best;
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline int SelectDisparitySse41(const uint16_t *sum,
+                                                int num_d, int uniqueness,
+                                                bool *unique) {
+  // minpos 返回每 8 个中最小值及其最小下标，只在严格更小时替换
+  int best = 0;
+  int best_cost = 0x10000;
+  for (int d = 0; d < num_d; d += 8) {
+    __m128i pos = _mm_minpos_epu16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + d)));
+    int cost = _mm_extract_epi16(pos, 0);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best = d + _mm_extract_epi16(pos, 1);
+    }
+  }
+  *unique = true;
+  if (uniqueness <= 0 || best_cost == 0) {
+    return best;
+  }
+  const __m128i threshold = _mm_set1_epi16(
+      static_cast<int16_t>((best_cost * 100 - 1) / (100 - uniqueness)));
+  const __m128i two = _mm_set1_epi16(2);
+  __m128i index = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+  index = _mm_sub_epi16(index, _mm_set1_epi16(static_cast<int16_t>(best - 1)));
+  __m128i any = _mm_setzero_si128();
+  for (int d = 0; d < num_d; d += 8) {
+    __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(sum + d));
+    __m128i low = _mm_cmpeq_epi16(_mm_min_epu16(s, threshold), s);
+    // 下标 - (best - 1) 按无符号不大于 2 的为最优及其相邻视差
+    __m128i near = _mm_cmpeq_epi16(_mm_min_epu16(index, two), index);
+    any = _mm_or_si128(any, _mm_andnot_si128(near, low));
+    index = _mm_add_epi16(index, _mm_set1_epi16(8));
+  }
+  *unique = _mm_testz_si128(any, any) != 0;
+  return best;
+}
+PG_TARGET_AVX2 inline int SelectDisparityAvx2(const uint16_t *sum, int num_d,
+                                              int uniqueness, bool *unique) {
+  // 先求最小值，再找第一个等于最小值的下标，同时检查唯一性
+  __m256i min_v = _mm256_set1_epi16(-1);
+  for (int d = 0; d < num_d; d += 16) {
+    min_v = _mm256_min_epu16(
+        min_v, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sum + d)));
+  }
+  __m128i m = _mm_minpos_epu16(_mm_min_epu16(
+      _mm256_castsi256_si128(min_v), _mm256_extracti128_si256(min_v, 1)));
+  int best_cost = _mm_extract_epi16(m, 0);
+  const __m256i target = _mm256_set1_epi16(static_cast<int16_t>(best_cost));
+  int best = 0;
+  for (int d = 0; d < num_d; d += 16) {
+    __m256i eq = _mm256_cmpeq_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sum + d)),
+        target);
+    int mask = _mm256_movemask_epi8(eq);
+    if (mask != 0) {
+      best = d + __builtin_ctz(static_cast<unsigned>(mask)) / 2;
+      break;
+    }
+  }
+  *unique = true;
+  if (uniqueness <= 0 || best_cost == 0) {
+    return best;
+  }
+  const __m256i threshold = _mm256_set1_epi16(
+      static_cast<int16_t>((best_cost * 100 - 1) / (100 - uniqueness)));
+  const __m256i two = _mm256_set1_epi16(2);
+  __m256i index = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+                                    13, 14, 15);
+  index = _mm256_sub_epi16(index,
+                           _mm256_set1_epi16(static_cast<int16_t>(best - 1)));
+  __m256i any = _mm256_setzero_si256();
+  for (int d = 0; d < num_d; d += 16) {
+    __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(sum + d));
+    __m256i low = _mm256_cmpeq_epi16(_mm256_min_epu16(s, threshold), s);
+    __m256i near = _mm256_cmpeq_epi16(_mm256_min_epu16(index, two), index);
+    any = _mm256_or_si256(any, _mm256_andnot_si256(near, low));
+    index = _mm256_add_epi16(index, _mm256_set1_epi16(16));
+  }
+  *unique = _mm256_testz_si256(any, any) != 0;
+  return best;
+}
+#endif
+
+inline int SelectDisparity(const uint16_t *sum, int num_d, int uniqueness,
+                           bool *unique) {
+  switch (phigent::vision::GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case phigent::vision::SimdLevel::kAvx2:
+      return SelectDisparityAvx2(sum, num_d, uniqueness, unique);
+    case phigent::vision::SimdLevel::kSse41:
+      return SelectDisparitySse41(sum, num_d, uniqueness, unique);
+#endif
+    default:
+      return SelectDisparityScalar(sum, num_d, uniqueness, unique);
+  }
+}
+
+/// 一个行带的聚合缓冲
+struct SgmBandBuffer {
+  /// 每个点的 L 之间的间隔，含前后填充
+  int pitch = 0;
+  std::vector<uint8_t> cost;
+  std::vector<uint16_t> sum;
+  /// 竖直与两条对角路径的上一行与当前行，每行 width + 2 个点，
+  /// 首尾两点为图像外的虚拟点，L 与 min 恒为 0
+  std::vector<uint16_t> rows[3][2];
+  std::vector<uint16_t> row_min[3][2];
+  /// 水平路径前一点与当前点
+  std::vector<uint16_t> line[2];
+  std::vector<uint64_t> right_rev;
+  std::vector<int16_t> disp;
+  std::vector<int16_t> best;
+  std::vector<uint16_t> right_cost;
+  std::vector<int16_t> right_best;
+
+  void Reset(int width, int num_d) {
+    pitch = num_d + 2 * kSgmPad;
+    size_t points = static_cast<size_t>(width) * num_d;
+    cost.resize(points);
+    sum.resize(points);
+    size_t row_size = static_cast<size_t>(width + 2) * pitch;
+    for (int p = 0; p < 3; ++p) {
+      for (int k = 0; k < 2; ++k) {
+        rows[p][k].assign(row_size, 0xFFFF);
+        row_min[p][k].assign(width + 2, 0);
+        for (int x = 0; x < width + 2; ++x) {
+          std::fill_n(&rows[p][k][static_cast<size_t>(x) * pitch + kSgmPad],
+                      num_d, 0);
+        }
+      }
+    }
+    for (auto &l : line) {
+      l.assign(pitch, 0xFFFF);
+    }
+    right_rev.resize(width);
+    disp.resize(width);
+    best.resize(width);
+    right_cost.resize(width);
+    right_best.resize(width);
+  }
+
+  /// 第 p 条路径在 which 行中 x（-1 ~ width）处的 L
+  uint16_t *RowAt(int p, int which, int x) {
+    return &rows[p][which][static_cast<size_t>(x + 1) * pitch + kSgmPad];
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief 主机端半全局双目匹配，输入为校正后的左右图，输出与板端相同的
+ * Int16 定点视差（raw * float_scale 为像素视差，0 表示无效）
+ * @note census 9x7 代价，沿左右、竖直向下与两条向下的对角路径聚合
+ * （diagonal_paths 为 false 时只有前三条），赢家通吃后做唯一性检查、
+ * 亚像素拟合与左右一致性检查。整帧按行带在内部线程池上并行，每个行带
+ * 向上多聚合 band_overlap 行来预热竖直与对角路径，因此结果与行带数
+ * （即线程数）有微小关系，需要逐位复现时固定 num_threads。
+ * 代价计算与聚合使用 SIMD。Init 之后 Compute 线程安全。
+ */
+class StereoMatcher {
+ public:
+  StereoMatcher() = default;
+  StereoMatcher(const StereoMatcher &) = delete;
+  StereoMatcher &operator=(const StereoMatcher &) = delete;
+
+  /**
+   * @brief  初始化
+   * @param  config: 匹配配置
+   * @retval 0 成功，-1 参数无效
+   */
+  int Init(const StereoMatcherConfig &config = StereoMatcherConfig()) {
+    int scale = config.disparity_scale > 0
+                    ? static_cast<int>(1.0f / config.disparity_scale + 0.5f)
+                    : 0;
+    if (config.min_disparity < 0 || config.num_disparities <= 0 ||
+        config.num_disparities % 16 != 0 || config.num_disparities > 256 ||
+        config.p1 <= 0 || config.p2 <= config.p1 || config.p2 > 4096 ||
+        config.uniqueness_ratio < 0 || config.uniqueness_ratio >= 100 ||
+        config.band_overlap < 0 || scale <= 0 ||
+        (config.min_disparity + config.num_disparities) * scale > 32767) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    scale_ = scale;
+    int threads = utils::ThreadPool::ResolveNumThreads(config.num_threads);
+    if (!pool_ || pool_->NumThreads() != threads) {
+      pool_.reset(new utils::ThreadPool(config.num_threads));
+    }
+    return 0;
+  }
+
+  /// 是否已初始化
+  bool Ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scale_ > 0;
+  }
+
+  /**
+   * @brief  计算视差，输出帧来自缓存池
+   * @param  left: 校正后的左图，GRAY 或 NV12/NV21/I420/YV12（只用亮度）
+   * @param  right: 校正后的右图，格式与尺寸同左图
+   * @param  pool: 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+   * @retval kPGPixelFormatInt16 视差帧，继承左图的
+   * channel_id/time_stamp/frame_id/type；失败返回 nullptr
+   */
+  phigent::vision::ImageFramePtr Compute(
+      phigent::vision::ImageFrame &left, phigent::vision::ImageFrame &right,
+      phigent::vision::ImageFramePool *pool = nullptr) {
+    if (pool == nullptr) {
+      pool = &phigent::vision::DefaultImageFramePool();
+    }
+    auto disparity =
+        pool->Acquire(kPGPixelFormatInt16, left.Width(), left.Height());
+    if (!disparity || Compute(left, right, disparity.get()) != 0) {
+      return nullptr;
+    }
+    return disparity;
+  }
+
+  /**
+   * @brief  计算视差，写入调用方提供的帧
+   * @param  left: 校正后的左图
+   * @param  right: 校正后的右图
+   * @param  *disparity: [out] 与左图同尺寸的 kPGPixelFormatInt16 帧
+   * @retval 0 成功，-1 未初始化，-2 输入格式不支持或左右图不匹配，
+   * -3 输出帧不匹配
+   */
+  int Compute(phigent::vision::ImageFrame &left,
+              phigent::vision::ImageFrame &right,
+              phigent::vision::ImageFrame *disparity) {
+    StereoMatcherConfig config;
+    int scale = 0;
+    std::shared_ptr<utils::ThreadPool> pool;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      config = config_;
+      scale = scale_;
+      pool = pool_;
+    }
+    if (scale <= 0) {
+      return -1;
+    }
+    if (!IsLumaFormat(left.pixel_format) ||
+        !IsLumaFormat(right.pixel_format) || left.Data() == nullptr ||
+        right.Data() == nullptr || left.Width() != right.Width() ||
+        left.Height() != right.Height() || left.Width() == 0 ||
+        left.Height() == 0) {
+      return -2;
+    }
+    if (disparity == nullptr || disparity->Data() == nullptr ||
+        disparity->pixel_format != kPGPixelFormatInt16 ||
+        disparity->Width() != left.Width() ||
+        disparity->Height() != left.Height()) {
+      return -3;
+    }
+    int width = static_cast<int>(left.Width());
+    int height = static_cast<int>(left.Height());
+    std::unique_ptr<Scratch> scratch = AcquireScratch();
+    size_t points = static_cast<size_t>(width) * height;
+    scratch->census[0].resize(points);
+    scratch->census[1].resize(points);
+    const uint8_t *images[2] = {left.Data(), right.Data()};
+    size_t steps[2] = {
+        phigent::vision::FrameRowStep(left.Stride(), left.Width(), 1),
+        phigent::vision::FrameRowStep(right.Stride(), right.Width(), 1)};
+    auto census = [&](int begin, int end) {
+      for (int y = begin; y < end; ++y) {
+        for (int k = 0; k < 2; ++k) {
+          detail::CensusRow(images[k], steps[k], width, height, y,
+                            &scratch->census[k][static_cast<size_t>(y) *
+                                                width]);
+        }
+      }
+    };
+    pool->ParallelFor(0, height, kRowGrain, census);
+
+    int bands = std::max(1, std::min(pool->NumThreads(), height / kRowGrain));
+    if (static_cast<int>(scratch->bands.size()) < bands) {
+      scratch->bands.resize(bands);
+    }
+    size_t dst_step = phigent::vision::FrameRowStep(disparity->Stride(),
+                                                    disparity->Width(), 2);
+    uint8_t *dst = disparity->Data();
+    auto run = [&](int begin, int end) {
+      for (int b = begin; b < end; ++b) {
+        int y0 = static_cast<int>(static_cast<int64_t>(height) * b / bands);
+        int y1 =
+            static_cast<int>(static_cast<int64_t>(height) * (b + 1) / bands);
+        int warm = std::max(0, y0 - config.band_overlap);
+        MatchBand(config, scale, *scratch, width, warm, y0, y1,
+                  &scratch->bands[b], dst, dst_step);
+      }
+    };
+    pool->ParallelFor(0, bands, 1, run);
+    ReleaseScratch(std::move(scratch));
+    disparity->channel_id = left.channel_id;
+    disparity->time_stamp = left.time_stamp;
+    disparity->frame_id = left.frame_id;
+    disparity->type = left.type;
+    disparity->float_scale = 1.0f / scale;
+    return 0;
+  }
+
+ private:
+  /// 每个分块最少行数
+  static constexpr int kRowGrain = 16;
+  /// 缓存的临时缓冲数量上限
+  static constexpr size_t kMaxScratch = 4;
+
+  /// 一次 Compute 的临时缓冲，复用以避免每帧分配
+  struct Scratch {
+    std::vector<uint64_t> census[2];
+    std::vector<detail::SgmBandBuffer> bands;
+  };
+
+  static bool IsLumaFormat(PGPixelFormat format) {
+    return format == kPGPixelFormatRawGRAY || format == kPGPixelFormatRawNV12 ||
+           format == kPGPixelFormatRawNV21 || format == kPGPixelFormatRawI420 ||
+           format == kPGPixelFormatRawYV12;
+  }
+
+  /**
+   * @brief  处理一个行带：从 warm_begin 行开始聚合，输出 [begin, end) 行
+   */
+  static void MatchBand(const StereoMatcherConfig &config, int scale,
+                        const Scratch &scratch, int width, int warm_begin,
+                        int begin, int end, detail::SgmBandBuffer *buf,
+                        uint8_t *dst, size_t dst_step) {
+    const int num_d = config.num_disparities;
+    const int min_d = config.min_disparity;
+    const int paths = config.diagonal_paths ? 3 : 1;
+    // 竖直、左上到右下、右上到左下三条路径中上一点的 x 偏移
+    static constexpr int kDx[3] = {0, -1, 1};
+    buf->Reset(width, num_d);
+    int cur = 0;
+    for (int y = warm_begin; y < end; ++y) {
+      bool output = y >= begin;
+      const uint64_t *left = &scratch.census[0][static_cast<size_t>(y) * width];
+      const uint64_t *right =
+          &scratch.census[1][static_cast<size_t>(y) * width];
+      for (int x = 0; x < width; ++x) {
+        buf->right_rev[x] = right[width - 1 - x];
+      }
+      detail::CostRow(left, buf->right_rev.data(), width, min_d, num_d,
+                      buf->cost.data());
+      int prev = cur ^ 1;
+      // 从左到右：水平路径与向下的路径
+      uint16_t line_min = 0;
+      for (int x = 0; x < width; ++x) {
+        size_t offset = static_cast<size_t>(x) * num_d;
+        detail::SgmStep step;
+        step.cost = &buf->cost[offset];
+        step.sum = output ? &buf->sum[offset] : nullptr;
+        step.first = true;
+        if (output) {
+          std::vector<uint16_t> &line_prev = buf->line[(x & 1) ^ 1];
+          step.prev = &line_prev[detail::kSgmPad];
+          step.prev_min = line_min;
+          if (x == 0) {
+            std::fill_n(&line_prev[detail::kSgmPad], num_d, 0);
+          }
+          step.cur = &buf->line[x & 1][detail::kSgmPad];
+          line_min = detail::Aggregate(step, num_d, config.p1, config.p2);
+          step.first = false;
+        }
+        for (int p = 0; p < paths; ++p) {
+          step.prev = buf->RowAt(p, prev, x + kDx[p]);
+          step.prev_min = buf->row_min[p][prev][x + kDx[p] + 1];
+          step.cur = buf->RowAt(p, cur, x);
+          buf->row_min[p][cur][x + 1] =
+              detail::Aggregate(step, num_d, config.p1, config.p2);
+          step.first = false;
+        }
+      }
+      cur = prev;
+      if (!output) {
+        continue;
+      }
+      // 从右到左，完成一个点的聚合后立即选取视差
+      std::fill(buf->right_cost.begin(), buf->right_cost.end(), 0xFFFF);
+      std::fill(buf->right_best.begin(), buf->right_best.end(), -1);
+      for (int x = width - 1; x >= 0; --x) {
+        size_t offset = static_cast<size_t>(x) * num_d;
+        std::vector<uint16_t> &line_prev = buf->line[(x & 1) ^ 1];
+        if (x == width - 1) {
+          std::fill_n(&line_prev[detail::kSgmPad], num_d, 0);
+          line_min = 0;
+        }
+        detail::SgmStep step;
+        step.cost = &buf->cost[offset];
+        step.prev = &line_prev[detail::kSgmPad];
+        step.prev_min = line_min;
+        step.cur = &buf->line[x & 1][detail::kSgmPad];
+        step.sum = &buf->sum[offset];
+        step.first = false;
+        line_min = detail::Aggregate(step, num_d, config.p1, config.p2);
+        SelectPixel(config, scale, &buf->sum[offset], x, buf);
+      }
+      int16_t *out = reinterpret_cast<int16_t *>(dst + dst_step * y);
+      for (int x = 0; x < width; ++x) {
+        int d = buf->best[x];
+        int xr = x - d;
+        if (d >= 0 && config.lr_max_diff >= 0 && xr >= 0 &&
+            buf->right_best[xr] >= 0 &&
+            std::abs(buf->right_best[xr] - d) > config.lr_max_diff) {
+          buf->disp[x] = 0;
+        }
+        out[x] = buf->disp[x];
+      }
+    }
+  }
+
+  /// 选取 x 处的视差，写入 buf->disp/best 并更新右图的最优视差
+  static void SelectPixel(const StereoMatcherConfig &config, int scale,
+                          const uint16_t *sum, int x,
+                          detail::SgmBandBuffer *buf) {
+    const int num_d = config.num_disparities;
+    bool unique = true;
+    int k = detail::SelectDisparity(sum, num_d, config.uniqueness_ratio,
+                                    &unique);
+    int d = config.min_disparity + k;
+    // 右图越界的视差与不唯一的匹配无效
+    if (!unique || x - d < 0) {
+      buf->disp[x] = 0;
+      buf->best[x] = -1;
+      return;
+    }
+    int raw = d * scale;
+    if (config.subpixel && k > 0 && k < num_d - 1) {
+      int prev = sum[k - 1];
+      int next = sum[k + 1];
+      int denom = std::max(prev + next - 2 * sum[k], 1);
+      raw += ((prev - next) * scale + denom) / (denom * 2);
+    }
+    buf->disp[x] = static_cast<int16_t>(std::max(raw, 0));
+    buf->best[x] = static_cast<int16_t>(d);
+    int xr = x - d;
+    if (sum[k] < buf->right_cost[xr]) {
+      buf->right_cost[xr] = sum[k];
+      buf->right_best[xr] = static_cast<int16_t>(d);
+    }
+  }
+
+  std::unique_ptr<Scratch> AcquireScratch() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scratch_.empty()) {
+      return std::unique_ptr<Scratch>(new Scratch());
+    }
+    std::unique_ptr<Scratch> scratch = std::move(scratch_.back());
+    scratch_.pop_back();
+    return scratch;
+  }
+
+  void ReleaseScratch(std::unique_ptr<Scratch> scratch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (scratch_.size() < kMaxScratch) {
+      scratch_.push_back(std::move(scratch));
+    }
+  }
+
+  mutable std::mutex mutex_;
+  StereoMatcherConfig config_;
+  /// 1 / disparity_scale，0 表示未初始化
+  int scale_ = 0;
+  std::shared_ptr<utils::ThreadPool> pool_;
+  std::vector<std::unique_ptr<Scratch>> scratch_;
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_STEREO_HPP_
@@ -0,0 +1,155 @@
+/**
+ * @file vidar_stream_config.hpp
+ * @brief 不中断数据流的输出配置：通道集合、输出类型与帧率
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_STREAM_CONFIG_HPP_
+#define PG_VIDAR_STREAM_CONFIG_HPP_
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "pg/utils/json_helper.hpp"
+#include "pg/vidar_interface.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 输出配置
+ */
+struct StreamConfig {
+  /// 输出的通道，为空表示 Init 中打开的全部通道
+  std::vector<int> channel_ids;
+  /// 板端输出类型 ORIG/REMAP，为空表示不修改
+  std::string type;
+  /// 每个通道的最高输出帧率，0 表示不限制
+  double fps = 0;
+};
+
+/**
+ * @brief  从 json 读取输出配置，字段与 Init 的 "SourceVideoStream" 一致
+ * @param  conf_json: json 字符串
+ * {
+ *    "SourceVideoStream": {
+ *        "channel_id": [0, 1],
+ *        "type": "REMAP",
+ *        "fps": 10
+ *    }
+ * }
+ * @param  *config: [out] 缺省字段为 StreamConfig 的默认值
+ * @retval 0 成功，-1 json 无效或没有 "SourceVideoStream"，-2 字段值无效
+ */
+inline int ParseStreamConfig(const std::string &conf_json,
+                             StreamConfig *config) {
+  cv::FileStorage fs;
+  if (utils::json::Open(conf_json, &fs) != 0) {
+    return -1;
+  }
+  cv::FileNode node = fs["SourceVideoStream"];
+  if (node.empty()) {
+    return -1;
+  }
+  StreamConfig parsed;
+  parsed.channel_ids = utils::json::GetIntArray(node["channel_id"]);
+  parsed.type = utils::json::GetString(node["type"], "");
+  parsed.fps = utils::json::GetDouble(node["fps"], 0);
+  if (parsed.fps < 0 ||
+      (!parsed.type.empty() && parsed.type != "ORIG" &&
+       parsed.type != "REMAP")) {
+    return -2;
+  }
+  for (int channel_id : parsed.channel_ids) {
+    if (channel_id < 0) {
+      return -2;
+    }
+  }
+  std::sort(parsed.channel_ids.begin(), parsed.channel_ids.end());
+  *config = std::move(parsed);
+  return 0;
+}
+
+/**
+ * @brief 一次输出配置切换的结果
+ */
+struct StreamConfigResult {
+  /// UpdateStreamConfig 返回的配置序号，0 表示尚未切换过
+  uint64_t generation = 0;
+  /// 0 成功，-1 板端拒绝修改输出类型（需要重启板端程序），
+  /// -2 激活板端输出失败，失败时仍沿用之前的配置
+  int status = 0;
+  /// 生效时的主机单调时钟，ns
+  uint64_t applied_ns = 0;
+  /// 新配置下各通道输出的第一帧，(channel_id, frame_id)，按到达顺序
+  std::vector<std::pair<uint32_t, uint64_t>> first_frame_ids;
+};
+
+/**
+ * @brief 按输出配置在主机端筛选图像帧：只保留选中的通道，
+ * 并按 time_stamp 把每个通道降到不超过 fps 的帧率
+ * @note 帧率按时间戳间隔抽取，允许四分之一周期的抖动，
+ * 不会提高设备的原始帧率。非线程安全。
+ */
+class StreamFilter {
+ public:
+  StreamFilter() = default;
+  explicit StreamFilter(const StreamConfig &config) { Reset(config); }
+
+  void Reset(const StreamConfig &config) {
+    channel_ids_ = config.channel_ids;
+    period_ns_ =
+        config.fps > 0 ? static_cast<uint64_t>(1e9 / config.fps) : 0;
+    for (auto &due : next_due_) {
+      due = kNotStarted;
+    }
+  }
+
+  /// 该帧是否输出
+  bool Accept(const phigent::vision::ImageFrame &frame) {
+    int channel_id = static_cast<int>(frame.channel_id);
+    if (!channel_ids_.empty() &&
+        !std::binary_search(channel_ids_.begin(), channel_ids_.end(),
+                            channel_id)) {
+      return false;
+    }
+    if (period_ns_ == 0 || frame.channel_id >= kMaxChannels) {
+      return true;
+    }
+    uint64_t &due = next_due_[frame.channel_id];
+    uint64_t slack = period_ns_ / 4;
+    // 时间戳回退到上一个输出帧之前时（如设备重启）重新计时
+    bool restart = due == kNotStarted || frame.time_stamp + period_ns_ < due;
+    if (!restart && frame.time_stamp + slack < due) {
+      return false;
+    }
+    // 间隔超过一个周期（丢帧）时同样以当前帧重新计时
+    if (restart || frame.time_stamp >= due + period_ns_) {
+      due = frame.time_stamp + period_ns_;
+    } else {
+      due += period_ns_;
+    }
+    return true;
+  }
+
+ private:
+  static constexpr uint32_t kMaxChannels = 16;
+  static constexpr uint64_t kNotStarted = UINT64_MAX;
+
+  std::vector<int> channel_ids_;
+  uint64_t period_ns_ = 0;
+  uint64_t next_due_[kMaxChannels] = {};
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_STREAM_CONFIG_HPP_
@@ -0,0 +1,496 @@
+/**
+ * @file vidar_synthetic.hpp
+ * @brief 生成合成双目/视差/IMU 数据的 VidarInterface 实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef PG_VIDAR_SYNTHETIC_HPP_
+#define PG_VIDAR_SYNTHETIC_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "pg/utils/frame_pool_group.hpp"
+#include "pg/utils/json_helper.hpp"
+#include "pg/utils/pace_clock.hpp"
+#include "pg/vidar_interface.hpp"
+#include "vision_type/image_frame_ops.hpp"
+#include "vision_type/image_frame_pool.hpp"
+
+namespace pg {
+namespace vidar {
+
+/**
+ * @brief 合成数据配置，见 SyntheticVidar
+ */
+struct SyntheticConfig {
+  uint32_t width = 1280;
+  uint32_t height = 720;
+  /// 帧率
+  double fps = 30;
+  /// 左/右图像格式，支持 gray/bgr/rgb/nv12/nv21/i420/yv12
+  PGPixelFormat pixel_format = kPGPixelFormatRawGRAY;
+  int left_channel_id = 0;
+  /// <0 表示不输出右图
+  int right_channel_id = 1;
+  /// <0 表示不输出视差
+  int disparity_channel_id = -1;
+  /// 视差 Int16 定点的 float_scale
+  float disparity_scale = 1.0f / 16;
+  /// 场景为随行号线性变化的视差平面（地面），单位像素
+  int min_disparity = 8;
+  int max_disparity = 96;
+  /// IMU 频率，0 表示不输出
+  double imu_rate = 200;
+  /// 按帧率实时输出，false 时不限速
+  bool realtime = true;
+  /// 输出的帧数，0 表示无限
+  uint64_t frames = 0;
+  /// GetConfig 中标定的焦距（像素）与基线（米）
+  double focal = 700;
+  double baseline_m = 0.12;
+};
+
+namespace detail {
+
+/// 整数哈希，生成块状纹理
+inline uint32_t SyntheticHash(uint32_t x, uint32_t y) {
+  uint32_t h = x * 0x8da6b343u ^ y * 0xd8163841u;
+  h ^= h >> 13;
+  h *= 0x85ebca6bu;
+  return h ^ (h >> 16);
+}
+
+/// 把矩阵写成 cv::FileStorage 的 YAML 格式
+inline void AppendYamlMat(const char *name, int rows, int cols,
+                          const double *data, std::string *out) {
+  char buf[96];
+  snprintf(buf, sizeof(buf),
+           "%s: !!opencv-matrix\n   rows: %d\n   cols: %d\n   dt: d\n"
+           "   data: [ ",
+           name, rows, cols);
+  out->append(buf);
+  for (int i = 0; i < rows * cols; ++i) {
+    snprintf(buf, sizeof(buf), i + 1 < rows * cols ? "%.17g, " : "%.17g ]\n",
+             data[i]);
+    out->append(buf);
+  }
+}
+
+/// json 字符串转义
+inline std::string EscapeJson(const std::string &text) {
+  std::string out;
+  out.reserve(text.size() + 16);
+  for (char c : text) {
+    if (c == '\n') {
+      out.append("\\n");
+    } else if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else {
+      out.push_back(c);
+    }
+  }
+  return out;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 生成合成数据的 VidarInterface 实现，VidarInterface 类型名
+ * "synthetic"，用于没有设备时的压测与性能分析
+ * @note 场景为向右平移的块状纹理，右图为左图按视差平面平移的结果，视差为
+ * 整数，可用作立体匹配的真值；IMU 为重力加小幅正弦扰动。时间戳从 0 开始
+ * 按帧率递增，单位 ns。
+ *
+ * Init 配置，字段与 SyntheticConfig 对应，均可省略：
+ * {
+ *    "synthetic": {
+ *        "width": 1280, "height": 720, "fps": 30,
+ *        "pixel_format": "gray",
+ *        "channel_id": [0, 1],          // 左、右图通道，只给一个时不输出右图
+ *        "disparity_channel_id": 2,     // -1 表示不输出视差
+ *        "disparity_scale": 0.0625,
+ *        "min_disparity": 8, "max_disparity": 96,
+ *        "imu_rate": 200,
+ *        "realtime": true,
+ *        "frames": 0,
+ *        "focal": 700, "baseline": 0.12
+ *    },
+ *    "ImageFramePool": {...}          // 可选，各通道缓存池容量，默认 32，
+ *                                     // 格式见 FramePoolGroup::Init
+ * }
+ * RecvData 返回 0 成功，-1 参数错误或等待超时，-2 已输出 frames 帧。
+ * UpdateConfig 可以修改 "fps" 与 "realtime"。
+ */
+class SyntheticVidar : public VidarInterface {
+ public:
+  SyntheticVidar() = default;
+  ~SyntheticVidar() override = default;
+
+  int Init(const string &conf_json) override {
+    cv::FileStorage fs;
+    if (utils::json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    SyntheticConfig config;
+    if (ParseConfig(fs["synthetic"], &config) != 0 ||
+        pools_.Init(conf_json) != 0) {
+      return -1;
+    }
+    return Init(config);
+  }
+
+  /**
+   * @brief  直接使用结构体配置初始化
+   * @retval 0 成功，-1 配置无效
+   */
+  int Init(const SyntheticConfig &config) {
+    phigent::vision::FrameLayout layout;
+    if (config.width < 2 || config.height < 2 || config.fps <= 0 ||
+        config.left_channel_id < 0 || config.min_disparity < 0 ||
+        config.max_disparity < config.min_disparity ||
+        config.max_disparity >= static_cast<int>(config.width) ||
+        !IsSupportedFormat(config.pixel_format) ||
+        phigent::vision::GetFrameLayout(config.pixel_format, config.width,
+                                        config.height, &layout) != 0) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    fps_.store(config.fps);
+    realtime_.store(config.realtime);
+    frame_index_ = 0;
+    imu_index_ = 0;
+    texture_.resize(config.width + config.max_disparity + 1);
+    clock_.Reset(config.realtime ? 1.0 : 0.0);
+    inited_ = true;
+    return 0;
+  }
+
+  int Deinit() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inited_ = false;
+    return 0;
+  }
+
+  int RecvData(VidarData *data, int timeout_ms) override {
+    if (data == nullptr) {
+      return -1;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inited_) {
+      return -1;
+    }
+    data->images.clear();
+    data->imu.clear();
+    if (config_.frames != 0 && frame_index_ >= config_.frames) {
+      return -2;
+    }
+    double fps = fps_.load();
+    if (fps != config_.fps) {
+      // 保持当前时间戳，之后按新的帧率递增
+      time_base_ = FrameTime(frame_index_);
+      frame_base_ = frame_index_;
+      config_.fps = fps;
+    }
+    double speed = realtime_.load() ? 1.0 : 0.0;
+    if (speed != clock_.Speed()) {
+      clock_.SetSpeed(speed);
+    }
+    uint64_t ts = FrameTime(frame_index_);
+    if (!clock_.WaitUntil(ts, timeout_ms)) {
+      return -1;
+    }
+    Generate(ts, data);
+    AppendImu(ts, data);
+    ++frame_index_;
+    return 0;
+  }
+
+  int UpdateConfig(const std::string &conf_json) override {
+    cv::FileStorage fs;
+    if (utils::json::Open(conf_json, &fs) != 0) {
+      return -1;
+    }
+    cv::FileNode node = fs["synthetic"];
+    if (node.empty()) {
+      return -1;
+    }
+    double fps = utils::json::GetDouble(node["fps"], fps_.load());
+    if (fps <= 0) {
+      return -1;
+    }
+    fps_.store(fps);
+    realtime_.store(utils::json::GetBool(node["realtime"], realtime_.load()));
+    return 0;
+  }
+
+  /**
+   * @brief  返回与合成视差一致的标定，格式见 VidarInterface::GetConfig
+   * @retval 0 成功，-1 未初始化
+   */
+  int GetConfig(const std::string & /* conf_json */,
+                std::string &return_conf_json) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!inited_) {
+      return -1;
+    }
+    double f = config_.focal;
+    double cx = (config_.width - 1) / 2.0;
+    double cy = (config_.height - 1) / 2.0;
+    // 按标定习惯基线以毫米写入
+    double b = config_.baseline_m * 1000;
+    double m[9] = {f, 0, cx, 0, f, cy, 0, 0, 1};
+    double d[5] = {0, 0, 0, 0, 0};
+    double r[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    double t[3] = {-b, 0, 0};
+    double p1[12] = {f, 0, cx, 0, 0, f, cy, 0, 0, 0, 1, 0};
+    double p2[12] = {f, 0, cx, -f * b, 0, f, cy, 0, 0, 0, 1, 0};
+    double q[16] = {1, 0, 0, -cx, 0, 1, 0, -cy, 0, 0, 0, f, 0, 0, 1 / b, 0};
+    std::string calib = "%YAML:1.0\n---\n";
+    char buf[64];
+    snprintf(buf, sizeof(buf), "image_width: %u\nimage_height: %u\n",
+             config_.width, config_.height);
+    calib.append(buf);
+    detail::AppendYamlMat("M1", 3, 3, m, &calib);
+    detail::AppendYamlMat("D1", 1, 5, d, &calib);
+    detail::AppendYamlMat("M2", 3, 3, m, &calib);
+    detail::AppendYamlMat("D2", 1, 5, d, &calib);
+    detail::AppendYamlMat("R", 3, 3, r, &calib);
+    detail::AppendYamlMat("T", 3, 1, t, &calib);
+    detail::AppendYamlMat("R1", 3, 3, r, &calib);
+    detail::AppendYamlMat("R2", 3, 3, r, &calib);
+    detail::AppendYamlMat("P1", 3, 4, p1, &calib);
+    detail::AppendYamlMat("P2", 3, 4, p2, &calib);
+    detail::AppendYamlMat("Q", 4, 4, q, &calib);
+    return_conf_json = "{\n  \"camera\": {\n    \"calib\": \"" +
+                       detail::EscapeJson(calib) +
+                       "\",\n    \"product_number\": \"SYNTHETIC\",\n"
+                       "    \"serial_number\": \"SYNTHETIC0000\",\n"
+                       "    \"shift\": -1,\n    \"version\": \"0.0.0\"\n  }\n}";
+    return 0;
+  }
+
+  /**
+   * @brief  解析 "synthetic" 配置节点，缺省字段保持 config 原值
+   * @retval 0 成功，-1 格式错误
+   */
+  static int ParseConfig(const cv::FileNode &node, SyntheticConfig *config) {
+    if (node.empty()) {
+      return 0;
+    }
+    using utils::json::GetBool;
+    using utils::json::GetDouble;
+    using utils::json::GetInt;
+    config->width = GetInt(node["width"], config->width);
+    config->height = GetInt(node["height"], config->height);
+    config->fps = GetDouble(node["fps"], config->fps);
+    std::string name = utils::json::GetString(node["pixel_format"], "");
+    if (!name.empty() && phigent::vision::StrCvtPixelFormat(
+                             config->pixel_format, name, false) != 0) {
+      return -1;
+    }
+    std::vector<int> channels = utils::json::GetIntArray(node["channel_id"]);
+    if (!channels.empty()) {
+      config->left_channel_id = channels[0];
+      config->right_channel_id = channels.size() > 1 ? channels[1] : -1;
+    }
+    config->disparity_channel_id =
+        GetInt(node["disparity_channel_id"], config->disparity_channel_id);
+    config->disparity_scale = static_cast<float>(
+        GetDouble(node["disparity_scale"], config->disparity_scale));
+    config->min_disparity =
+        GetInt(node["min_disparity"], config->min_disparity);
+    config->max_disparity =
+        GetInt(node["max_disparity"], config->max_disparity);
+    config->imu_rate = GetDouble(node["imu_rate"], config->imu_rate);
+    config->realtime = GetBool(node["realtime"], config->realtime);
+    config->frames = static_cast<uint64_t>(
+        GetDouble(node["frames"], static_cast<double>(config->frames)));
+    config->focal = GetDouble(node["focal"], config->focal);
+    config->baseline_m = GetDouble(node["baseline"], config->baseline_m);
+    return 0;
+  }
+
+  /// 第 row 行的真值视差（像素）
+  int RowDisparity(uint32_t row) const {
+    return config_.min_disparity +
+           static_cast<int>(static_cast<int64_t>(config_.max_disparity -
+                                                 config_.min_disparity) *
+                            row / (config_.height - 1));
+  }
+
+  /// 各通道输出帧缓存池的统计信息
+  std::map<uint32_t, phigent::vision::ImageFramePoolStats> FramePoolStats()
+      const {
+    return pools_.Stats();
+  }
+
+ private:
+  /// 8 位 RGB/灰度与 YUV420，YUV 的色度固定为 128
+  static bool IsSupportedFormat(PGPixelFormat format) {
+    switch (format) {
+      case kPGPixelFormatRawNV12:
+      case kPGPixelFormatRawNV21:
+      case kPGPixelFormatRawI420:
+      case kPGPixelFormatRawYV12:
+        return true;
+      case kPGPixelFormatYUV444:
+        return false;
+      default:
+        return phigent::vision::detail::PackedChannels(format) != 0;
+    }
+  }
+
+  uint64_t FrameTime(uint64_t index) const {
+    return time_base_ +
+           static_cast<uint64_t>((index - frame_base_) * 1e9 / config_.fps);
+  }
+
+  phigent::vision::ImageFramePtr NewFrame(PGPixelFormat format, int channel,
+                                          uint64_t ts) {
+    phigent::vision::ImageFramePtr frame =
+        pools_.Get(static_cast<uint32_t>(channel))
+            ->Acquire(format, config_.width, config_.height);
+    if (frame) {
+      frame->channel_id = static_cast<uint32_t>(channel);
+      frame->time_stamp = ts;
+      frame->frame_id = frame_index_;
+    }
+    return frame;
+  }
+
+  /// 写入一行灰度，按输出格式展开
+  void WriteRow(phigent::vision::ImageFrame *frame, uint32_t row,
+                const uint8_t *gray) {
+    uint32_t w = config_.width;
+    int cn = phigent::vision::detail::PackedChannels(frame->pixel_format);
+    uint8_t *out = frame->Data() + static_cast<size_t>(frame->Stride()) * row;
+    if (cn <= 1) {
+      memcpy(out, gray, w);
+    } else {
+      for (uint32_t x = 0; x < w; ++x) {
+        for (int c = 0; c < cn; ++c) {
+          out[x * cn + c] = gray[x];
+        }
+        if (cn == 4) {
+          bool alpha_first = frame->pixel_format == kPGPixelFormatRawARGB ||
+                             frame->pixel_format == kPGPixelFormatRawABGR;
+          out[x * cn + (alpha_first ? 0 : 3)] = 255;
+        }
+      }
+    }
+  }
+
+  void Generate(uint64_t ts, VidarData *data) {
+    using phigent::vision::ImageFramePtr;
+    uint32_t w = config_.width;
+    uint32_t h = config_.height;
+    PGPixelFormat format = config_.pixel_format;
+    ImageFramePtr left = NewFrame(format, config_.left_channel_id, ts);
+    ImageFramePtr right;
+    ImageFramePtr disp;
+    if (config_.right_channel_id >= 0) {
+      right = NewFrame(format, config_.right_channel_id, ts);
+    }
+    if (config_.disparity_channel_id >= 0) {
+      disp = NewFrame(kPGPixelFormatInt16, config_.disparity_channel_id, ts);
+      if (disp) {
+        disp->float_scale = config_.disparity_scale;
+      }
+    }
+    // 纹理每帧向右平移 2 个像素，8x8 像素的块
+    uint32_t shift = static_cast<uint32_t>(frame_index_ * 2);
+    int16_t disp_scale = static_cast<int16_t>(
+        std::lround(1.0f / std::max(config_.disparity_scale, 1e-6f)));
+    for (uint32_t y = 0; y < h; ++y) {
+      int d = RowDisparity(y);
+      for (size_t x = 0; x < texture_.size(); ++x) {
+        uint32_t u = static_cast<uint32_t>(x) - shift;
+        uint32_t hash = detail::SyntheticHash(u >> 3, y >> 3);
+        // 块内叠加细纹理，避免匹配时出现大片平坦区域
+        texture_[x] = static_cast<uint8_t>(
+            (hash & 0xC0) + ((u * 7 + y * 3 + (hash >> 8)) & 0x3F));
+      }
+      if (left) {
+        WriteRow(left.get(), y, texture_.data());
+      }
+      if (right) {
+        // 校正后右图 x_r = x_l - d，即 right(x) = left(x + d)
+        WriteRow(right.get(), y, texture_.data() + d);
+      }
+      if (disp) {
+        int16_t *row = reinterpret_cast<int16_t *>(
+            disp->Data() + static_cast<size_t>(disp->Stride()) * y);
+        std::fill(row, row + w, static_cast<int16_t>(d * disp_scale));
+      }
+    }
+    for (auto *frame : {left.get(), right.get()}) {
+      if (frame != nullptr && frame->DataUV() != nullptr) {
+        memset(frame->DataUV(), 128, frame->DataUVSize());
+      }
+    }
+    for (auto *frame : {&left, &right, &disp}) {
+      if (*frame) {
+        data->images.push_back(*frame);
+      }
+    }
+  }
+
+  void AppendImu(uint64_t ts, VidarData *data) {
+    if (config_.imu_rate <= 0) {
+      return;
+    }
+    double period = 1e9 / config_.imu_rate;
+    char buf[160];
+    while (true) {
+      uint64_t imu_ts = static_cast<uint64_t>(imu_index_ * period);
+      if (imu_ts > ts) {
+        break;
+      }
+      double t = imu_ts * 1e-9;
+      double wobble = 0.05 * std::sin(2 * CV_PI * 1.5 * t);
+      int n = snprintf(
+          buf, sizeof(buf),
+          "%llu %.6f %.6f %.6f %.6f %.6f %.6f %.2f",
+          static_cast<unsigned long long>(imu_ts), wobble, -wobble * 0.5,
+          9.80665 + wobble * 0.2, 0.01 * std::cos(2 * CV_PI * 0.5 * t),
+          0.002, -0.001, 40.0);
+      data->imu.emplace_back(buf, std::min<size_t>(n, sizeof(buf) - 1));
+      ++imu_index_;
+    }
+  }
+
+  std::mutex mutex_;
+  bool inited_ = false;
+  SyntheticConfig config_;
+  std::atomic<double> fps_{30};
+  std::atomic<bool> realtime_{true};
+  uint64_t frame_index_ = 0;
+  uint64_t frame_base_ = 0;
+  uint64_t time_base_ = 0;
+  uint64_t imu_index_ = 0;
+  std::vector<uint8_t> texture_;
+  utils::PaceClock clock_;
+  utils::FramePoolGroup pools_{32};
+};
+
+}  // namespace vidar
+
+}  // namespace pg
+
+#endif  // PG_VIDAR_SYNTHETIC_HPP_
@@ -200,6 +200,119 @@ inline int StrCvtPixelFormat(PGPixelFormat &format, std::string &name,
   return 0;
 }
 
+/**
+ * \~Chinese @brief 连续存放的图像内存布局
+ * \~Chinese @note 多平面格式的 UV 平面紧跟在 Y 平面之后
+ */
+struct FrameLayout {
+  /// \~Chinese 维度（按 cv::Mat 的通道数计算，YUV420 为 1）
+  uint32_t channel = 0;
+  /// \~Chinese 单个元素的字节数
+  uint32_t elem_size = 1;
+  /// \~Chinese 主平面每行字节数
+  uint32_t stride = 0;
+  /// \~Chinese UV 平面每行字节数
+  uint32_t stride_uv = 0;
+  /// \~Chinese 主平面字节数
+  uint32_t data_size = 0;
+  /// \~Chinese UV 平面字节数
+  uint32_t data_uv_size = 0;
+};
+
+/**
+ * @brief 计算连续存放的图像内存布局
+ *
+ * @param format [in] 图片编码方式
+ * @param width [in] 宽度
+ * @param height [in] 高度
+ * @param layout [out] 内存布局
+ * @return int 0 when success, -1 when format is not a raw pixel format
+ */
+inline int GetFrameLayout(PGPixelFormat format, uint32_t width,
+                          uint32_t height, FrameLayout *layout) {
+  FrameLayout out;
+  switch (format) {
+    case kPGPixelFormatRawGRAY:
+    case kPGPixelFormatUint8:
+    case kPGPixelFormatInt8:
+      out.channel = 1;
+      break;
+    case kPGPixelFormatRawRGB565:
+    case kPGPixelFormatYUYV:
+    case kPGPixelFormatUYVY:
+      out.channel = 2;
+      break;
+    case kPGPixelFormatRawRGB:
+    case kPGPixelFormatRawBGR:
+    case kPGPixelFormatYUV444:
+      out.channel = 3;
+      break;
+    case kPGPixelFormatRawRGBA:
+    case kPGPixelFormatRawBGRA:
+    case kPGPixelFormatRawARGB:
+    case kPGPixelFormatRawABGR:
+      out.channel = 4;
+      break;
+    case kPGPixelFormatInt16:
+      out.channel = 1;
+      out.elem_size = 2;
+      break;
+    case kPGPixelFormatInt32:
+    case kPGPixelFormatFloat32:
+      out.channel = 1;
+      out.elem_size = 4;
+      break;
+    case kPGPixelFormatInt64:
+      out.channel = 1;
+      out.elem_size = 8;
+      break;
+    case kPGPixelFormatRawNV12:
+    case kPGPixelFormatRawNV21:
+      out.channel = 1;
+      out.stride = width;
+      out.stride_uv = (width + 1) / 2 * 2;
+      out.data_size = width * height;
+      out.data_uv_size = out.stride_uv * ((height + 1) / 2);
+      *layout = out;
+      return 0;
+    case kPGPixelFormatRawI420:
+    case kPGPixelFormatRawYV12:
+      out.channel = 1;
+      out.stride = width;
+      out.stride_uv = (width + 1) / 2;
+      out.data_size = width * height;
+      out.data_uv_size = out.stride_uv * ((height + 1) / 2) * 2;
+      *layout = out;
+      return 0;
+    default:
+      return -1;
+  }
+  out.stride = width * out.channel * out.elem_size;
+  out.data_size = out.stride * height;
+  *layout = out;
+  return 0;
+}
+
+/**
+ * @brief 平面每行的字节数
+ * @note \~Chinese 预编译库输出的帧 Stride() 有的以字节为单位，有的以元素
+ * 个数为单位：为 0 时按紧密排列处理，小于一行字节数时按元素个数处理，
+ * 按元素个数仍不足一行时视为无效，按紧密排列处理
+ *
+ * @param stride [in] Stride() 或 StrideUV()
+ * @param width [in] 每行元素个数
+ * @param elem_size [in] 单个元素的字节数
+ * @return size_t 每行字节数
+ */
+inline size_t FrameRowStep(uint32_t stride, uint32_t width, size_t elem_size) {
+  size_t row_bytes = static_cast<size_t>(width) * elem_size;
+  if (stride >= row_bytes) {
+    return stride;
+  }
+  size_t step = static_cast<size_t>(stride) * elem_size;
+  return step >= row_bytes ? step : row_bytes;
+}
+
 }  // namespace vision
 }  // namespace phigent
 
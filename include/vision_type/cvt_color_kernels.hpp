@@ -0,0 +1,357 @@
+/**
+ * @file cvt_color_kernels.hpp
+ * @brief YUV 转 BGR/RGB/GRAY 的行处理 kernel（标量/SSE4.1/AVX2/NEON）
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef VISION_TYPE_CVT_COLOR_KERNELS_HPP_
+#define VISION_TYPE_CVT_COLOR_KERNELS_HPP_
+
+#include <cstdint>
+#include <cstring>
+
+#include "vision_type/simd_dispatch.hpp"
+
+namespace phigent {
+namespace vision {
+namespace cvt {
+
+/*
+ * BT.601 limited range，6 位定点：
+ * Y' = (Y - 16) * 75, C = U - 128, D = V - 128
+ * B = (Y' + 129 * C + 32) >> 6
+ * G = (Y' - 25 * C - 52 * D + 32) >> 6
+ * R = (Y' + 102 * D + 32) >> 6
+ * 中间结果按 int16 饱和运算，所有实现输出逐位一致，与 cv::cvtColor 相差不超过2
+ */
+constexpr int kYuvCoefY = 75;
+constexpr int kYuvCoefUB = 129;
+constexpr int kYuvCoefUG = -25;
+constexpr int kYuvCoefVG = -52;
+constexpr int kYuvCoefVR = 102;
+
+inline int16_t SatS16(int v) {
+  return static_cast<int16_t>(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+inline uint8_t FixedToU8(int16_t v) {
+  int r = SatS16(v + 32) >> 6;
+  return static_cast<uint8_t>(r < 0 ? 0 : (r > 255 ? 255 : r));
+}
+
+/**
+ * @brief 一行 YUV（色度半宽平面）转 BGR/RGB
+ *
+ * @param y [in] 亮度行，width 个像素
+ * @param u [in] U 行，(width + 1) / 2 个像素
+ * @param v [in] V 行，(width + 1) / 2 个像素
+ * @param dst [out] 3 通道输出行
+ * @param rgb [in] true 输出 RGB，false 输出 BGR
+ */
+inline void YuvRowToBgrScalar(const uint8_t *y, const uint8_t *u,
+                              const uint8_t *v, uint8_t *dst, int begin,
+                              int width, bool rgb) {
+  for (int x = begin; x < width; ++x) {
+    int16_t yy = static_cast<int16_t>((y[x] - 16) * kYuvCoefY);
+    int c = u[x >> 1] - 128;
+    int d = v[x >> 1] - 128;
+    uint8_t b = FixedToU8(SatS16(yy + kYuvCoefUB * c));
+    uint8_t g =
+        FixedToU8(SatS16(SatS16(yy + kYuvCoefUG * c) + kYuvCoefVG * d));
+    uint8_t r = FixedToU8(SatS16(yy + kYuvCoefVR * d));
+    uint8_t *p = dst + 3 * x;
+    p[0] = rgb ? r : b;
+    p[1] = g;
+    p[2] = rgb ? b : r;
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void Store3x16Sse(const __m128i &c0, const __m128i &c1,
+                                         const __m128i &c2, uint8_t *dst) {
+  const __m128i m00 = _mm_setr_epi8(0, -128, -128, 1, -128, -128, 2, -128,
+                                    -128, 3, -128, -128, 4, -128, -128, 5);
+  const __m128i m01 = _mm_setr_epi8(-128, 0, -128, -128, 1, -128, -128, 2,
+                                    -128, -128, 3, -128, -128, 4, -128, -128);
+  const __m128i m02 = _mm_setr_epi8(-128, -128, 0, -128, -128, 1, -128, -128,
+                                    2, -128, -128, 3, -128, -128, 4, -128);
+  const __m128i m10 = _mm_setr_epi8(-128, -128, 6, -128, -128, 7, -128, -128,
+                                    8, -128, -128, 9, -128, -128, 10, -128);
+  const __m128i m11 = _mm_setr_epi8(5, -128, -128, 6, -128, -128, 7, -128,
+                                    -128, 8, -128, -128, 9, -128, -128, 10);
+  const __m128i m12 = _mm_setr_epi8(-128, 5, -128, -128, 6, -128, -128, 7,
+                                    -128, -128, 8, -128, -128, 9, -128, -128);
+  const __m128i m20 = _mm_setr_epi8(-128, 11, -128, -128, 12, -128, -128, 13,
+                                    -128, -128, 14, -128, -128, 15, -128, -128);
+  const __m128i m21 = _mm_setr_epi8(-128, -128, 11, -128, -128, 12, -128,
+                                    -128, 13, -128, -128, 14, -128, -128, 15,
+                                    -128);
+  const __m128i m22 = _mm_setr_epi8(10, -128, -128, 11, -128, -128, 12, -128,
+                                    -128, 13, -128, -128, 14, -128, -128, 15);
+  __m128i o0 = _mm_or_si128(
+      _mm_or_si128(_mm_shuffle_epi8(c0, m00), _mm_shuffle_epi8(c1, m01)),
+      _mm_shuffle_epi8(c2, m02));
+  __m128i o1 = _mm_or_si128(
+      _mm_or_si128(_mm_shuffle_epi8(c0, m10), _mm_shuffle_epi8(c1, m11)),
+      _mm_shuffle_epi8(c2, m12));
+  __m128i o2 = _mm_or_si128(
+      _mm_or_si128(_mm_shuffle_epi8(c0, m20), _mm_shuffle_epi8(c1, m21)),
+      _mm_shuffle_epi8(c2, m22));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), o0);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16), o1);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 32), o2);
+}
+
+PG_TARGET_SSE41 inline __m128i FixedToU16Sse(__m128i v) {
+  return _mm_srai_epi16(_mm_adds_epi16(v, _mm_set1_epi16(32)), 6);
+}
+
+PG_TARGET_SSE41 inline void YuvRowToBgrSse41(const uint8_t *y,
+                                             const uint8_t *u,
+                                             const uint8_t *v, uint8_t *dst,
+                                             int width, bool rgb) {
+  const __m128i k16 = _mm_set1_epi16(16);
+  const __m128i k128 = _mm_set1_epi16(128);
+  const __m128i cy = _mm_set1_epi16(kYuvCoefY);
+  const __m128i cub = _mm_set1_epi16(kYuvCoefUB);
+  const __m128i cug = _mm_set1_epi16(kYuvCoefUG);
+  const __m128i cvg = _mm_set1_epi16(kYuvCoefVG);
+  const __m128i cvr = _mm_set1_epi16(kYuvCoefVR);
+  const __m128i zero = _mm_setzero_si128();
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(y + x));
+    __m128i u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(u + x / 2));
+    __m128i v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(v + x / 2));
+    // 色度水平复制到每个像素
+    __m128i u16 = _mm_sub_epi16(_mm_unpacklo_epi8(u8, zero), k128);
+    __m128i v16 = _mm_sub_epi16(_mm_unpacklo_epi8(v8, zero), k128);
+    __m128i cb = _mm_mullo_epi16(u16, cub);
+    __m128i cg = _mm_mullo_epi16(u16, cug);
+    __m128i dg = _mm_mullo_epi16(v16, cvg);
+    __m128i dr = _mm_mullo_epi16(v16, cvr);
+    __m128i out_b[2], out_g[2], out_r[2];
+    for (int half = 0; half < 2; ++half) {
+      __m128i yy = half == 0 ? _mm_unpacklo_epi8(y8, zero)
+                             : _mm_unpackhi_epi8(y8, zero);
+      yy = _mm_mullo_epi16(_mm_sub_epi16(yy, k16), cy);
+      __m128i hb = half == 0 ? _mm_unpacklo_epi16(cb, cb)
+                             : _mm_unpackhi_epi16(cb, cb);
+      __m128i hcg = half == 0 ? _mm_unpacklo_epi16(cg, cg)
+                              : _mm_unpackhi_epi16(cg, cg);
+      __m128i hdg = half == 0 ? _mm_unpacklo_epi16(dg, dg)
+                              : _mm_unpackhi_epi16(dg, dg);
+      __m128i hr = half == 0 ? _mm_unpacklo_epi16(dr, dr)
+                             : _mm_unpackhi_epi16(dr, dr);
+      out_b[half] = FixedToU16Sse(_mm_adds_epi16(yy, hb));
+      out_g[half] =
+          FixedToU16Sse(_mm_adds_epi16(_mm_adds_epi16(yy, hcg), hdg));
+      out_r[half] = FixedToU16Sse(_mm_adds_epi16(yy, hr));
+    }
+    __m128i b = _mm_packus_epi16(out_b[0], out_b[1]);
+    __m128i g = _mm_packus_epi16(out_g[0], out_g[1]);
+    __m128i r = _mm_packus_epi16(out_r[0], out_r[1]);
+    if (rgb) {
+      Store3x16Sse(r, g, b, dst + 3 * x);
+    } else {
+      Store3x16Sse(b, g, r, dst + 3 * x);
+    }
+  }
+  YuvRowToBgrScalar(y, u, v, dst, x, width, rgb);
+}
+
+PG_TARGET_AVX2 inline __m256i FixedToU16Avx2(__m256i v) {
+  return _mm256_srai_epi16(_mm256_adds_epi16(v, _mm256_set1_epi16(32)), 6);
+}
+
+PG_TARGET_AVX2 inline void YuvRowToBgrAvx2(const uint8_t *y, const uint8_t *u,
+                                           const uint8_t *v, uint8_t *dst,
+                                           int width, bool rgb) {
+  const __m256i k16 = _mm256_set1_epi16(16);
+  const __m256i k128 = _mm256_set1_epi16(128);
+  const __m256i cy = _mm256_set1_epi16(kYuvCoefY);
+  const __m256i cub = _mm256_set1_epi16(kYuvCoefUB);
+  const __m256i cug = _mm256_set1_epi16(kYuvCoefUG);
+  const __m256i cvg = _mm256_set1_epi16(kYuvCoefVG);
+  const __m256i cvr = _mm256_set1_epi16(kYuvCoefVR);
+  int x = 0;
+  for (; x + 32 <= width; x += 32) {
+    // 16 个色度样本，每个复制为两个像素后与 32 个亮度对齐
+    __m256i u16 = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(u + x / 2))),
+        k128);
+    __m256i v16 = _mm256_sub_epi16(
+        _mm256_cvtepu8_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(v + x / 2))),
+        k128);
+    __m256i cb = _mm256_mullo_epi16(u16, cub);
+    __m256i cg = _mm256_mullo_epi16(u16, cug);
+    __m256i dg = _mm256_mullo_epi16(v16, cvg);
+    __m256i dr = _mm256_mullo_epi16(v16, cvr);
+    __m256i out_b[2], out_g[2], out_r[2];
+    for (int half = 0; half < 2; ++half) {
+      __m256i yy = _mm256_cvtepu8_epi16(_mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(y + x + 16 * half)));
+      yy = _mm256_mullo_epi16(_mm256_sub_epi16(yy, k16), cy);
+      // 取第 half 组 8 个色度并复制，得到 16 个像素的色度项
+      __m256i hb, hcg, hdg, hr;
+      if (half == 0) {
+        hb = _mm256_permute4x64_epi64(cb, 0x50);
+        hcg = _mm256_permute4x64_epi64(cg, 0x50);
+        hdg = _mm256_permute4x64_epi64(dg, 0x50);
+        hr = _mm256_permute4x64_epi64(dr, 0x50);
+      } else {
+        hb = _mm256_permute4x64_epi64(cb, 0xFA);
+        hcg = _mm256_permute4x64_epi64(cg, 0xFA);
+        hdg = _mm256_permute4x64_epi64(dg, 0xFA);
+        hr = _mm256_permute4x64_epi64(dr, 0xFA);
+      }
+      hb = _mm256_unpacklo_epi16(hb, hb);
+      hcg = _mm256_unpacklo_epi16(hcg, hcg);
+      hdg = _mm256_unpacklo_epi16(hdg, hdg);
+      hr = _mm256_unpacklo_epi16(hr, hr);
+      out_b[half] = FixedToU16Avx2(_mm256_adds_epi16(yy, hb));
+      out_g[half] = FixedToU16Avx2(
+          _mm256_adds_epi16(_mm256_adds_epi16(yy, hcg), hdg));
+      out_r[half] = FixedToU16Avx2(_mm256_adds_epi16(yy, hr));
+    }
+    // packus 按 128 位通道交错，permute 恢复像素顺序
+    __m256i b = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(out_b[0], out_b[1]), 0xD8);
+    __m256i g = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(out_g[0], out_g[1]), 0xD8);
+    __m256i r = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(out_r[0], out_r[1]), 0xD8);
+    const __m256i &c0 = rgb ? r : b;
+    const __m256i &c2 = rgb ? b : r;
+    Store3x16Sse(_mm256_castsi256_si128(c0), _mm256_castsi256_si128(g),
+                 _mm256_castsi256_si128(c2), dst + 3 * x);
+    Store3x16Sse(_mm256_extracti128_si256(c0, 1),
+                 _mm256_extracti128_si256(g, 1),
+                 _mm256_extracti128_si256(c2, 1), dst + 3 * x + 48);
+  }
+  YuvRowToBgrScalar(y, u, v, dst, x, width, rgb);
+}
+#endif  // PG_SIMD_X86
+
+#if defined(PG_SIMD_NEON)
+inline uint8x8_t FixedToU8Neon(int16x8_t v) {
+  return vqmovun_s16(vshrq_n_s16(vqaddq_s16(v, vdupq_n_s16(32)), 6));
+}
+
+inline void YuvRowToBgrNeon(const uint8_t *y, const uint8_t *u,
+                            const uint8_t *v, uint8_t *dst, int width,
+                            bool rgb) {
+  const int16x8_t k16 = vdupq_n_s16(16);
+  const int16x8_t k128 = vdupq_n_s16(128);
+  int x = 0;
+  for (; x + 16 <= width; x += 16) {
+    uint8x16_t y8 = vld1q_u8(y + x);
+    int16x8_t u16 = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + x / 2))), k128);
+    int16x8_t v16 = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + x / 2))), k128);
+    int16x8_t cb = vmulq_n_s16(u16, kYuvCoefUB);
+    int16x8_t cg = vmulq_n_s16(u16, kYuvCoefUG);
+    int16x8_t dg = vmulq_n_s16(v16, kYuvCoefVG);
+    int16x8_t dr = vmulq_n_s16(v16, kYuvCoefVR);
+    int16x8x2_t zb = vzipq_s16(cb, cb);
+    int16x8x2_t zcg = vzipq_s16(cg, cg);
+    int16x8x2_t zdg = vzipq_s16(dg, dg);
+    int16x8x2_t zr = vzipq_s16(dr, dr);
+    uint8x8_t ob[2], og[2], orr[2];
+    for (int half = 0; half < 2; ++half) {
+      uint8x8_t yh = half == 0 ? vget_low_u8(y8) : vget_high_u8(y8);
+      int16x8_t yy = vmulq_n_s16(
+          vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(yh)), k16), kYuvCoefY);
+      ob[half] = FixedToU8Neon(vqaddq_s16(yy, zb.val[half]));
+      og[half] = FixedToU8Neon(
+          vqaddq_s16(vqaddq_s16(yy, zcg.val[half]), zdg.val[half]));
+      orr[half] = FixedToU8Neon(vqaddq_s16(yy, zr.val[half]));
+    }
+    uint8x16x3_t out;
+    uint8x16_t b = vcombine_u8(ob[0], ob[1]);
+    uint8x16_t r = vcombine_u8(orr[0], orr[1]);
+    out.val[0] = rgb ? r : b;
+    out.val[1] = vcombine_u8(og[0], og[1]);
+    out.val[2] = rgb ? b : r;
+    vst3q_u8(dst + 3 * x, out);
+  }
+  YuvRowToBgrScalar(y, u, v, dst, x, width, rgb);
+}
+#endif  // PG_SIMD_NEON
+
+/**
+ * @brief 一行 YUV（色度半宽平面）转 BGR/RGB，按运行时指令集分发
+ *
+ * @param y [in] 亮度行
+ * @param u [in] U 行
+ * @param v [in] V 行
+ * @param dst [out] 3 通道输出行
+ * @param width [in] 像素数
+ * @param rgb [in] true 输出 RGB，false 输出 BGR
+ */
+inline void YuvRowToBgr(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                        uint8_t *dst, int width, bool rgb) {
+  switch (GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      YuvRowToBgrAvx2(y, u, v, dst, width, rgb);
+      return;
+    case SimdLevel::kSse41:
+      YuvRowToBgrSse41(y, u, v, dst, width, rgb);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      YuvRowToBgrNeon(y, u, v, dst, width, rgb);
+      return;
+#endif
+    default:
+      YuvRowToBgrScalar(y, u, v, dst, 0, width, rgb);
+      return;
+  }
+}
+
+/// 交错的色度行（NV12 为 UV，NV21 为 VU）拆分为两个平面
+inline void SplitChromaRow(const uint8_t *uv, uint8_t *first, uint8_t *second,
+                           int count) {
+  for (int i = 0; i < count; ++i) {
+    first[i] = uv[2 * i];
+    second[i] = uv[2 * i + 1];
+  }
+}
+
+/**
+ * @brief 打包格式的行（YUYV/UYVY）拆分为 Y、U、V 平面
+ *
+ * @param src [in] 打包行
+ * @param y [out] width 个亮度
+ * @param u [out] (width + 1) / 2 个 U
+ * @param v [out] (width + 1) / 2 个 V
+ * @param width [in] 像素数
+ * @param uyvy [in] true 为 UYVY，false 为 YUYV
+ */
+inline void SplitPackedYuvRow(const uint8_t *src, uint8_t *y, uint8_t *u,
+                              uint8_t *v, int width, bool uyvy) {
+  int y_off = uyvy ? 1 : 0;
+  int c_off = uyvy ? 0 : 1;
+  for (int x = 0; x < width; ++x) {
+    y[x] = src[2 * x + y_off];
+  }
+  for (int i = 0; i < (width + 1) / 2; ++i) {
+    u[i] = src[4 * i + c_off];
+    v[i] = src[4 * i + c_off + 2];
+  }
+}
+
+}  // namespace cvt
+}  // namespace vision
+}  // namespace phigent
+
+#endif  // VISION_TYPE_CVT_COLOR_KERNELS_HPP_
@@ -0,0 +1,333 @@
+/**
+ * @file image_frame_ops.hpp
+ * @brief ImageFrame 的颜色转换、裁剪缩放实现
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef VISION_TYPE_IMAGE_FRAME_OPS_HPP_
+#define VISION_TYPE_IMAGE_FRAME_OPS_HPP_
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "vision_type/base_type.hpp"
+#include "vision_type/cvt_color_kernels.hpp"
+#include "vision_type/image_frame_pool.hpp"
+#include "vision_type/resize_kernels.hpp"
+
+namespace phigent {
+namespace vision {
+
+namespace detail {
+
+/// YUV 源图像各平面的访问方式
+struct YuvSource {
+  const uint8_t *y = nullptr;
+  /// 半宽色度平面；interleaved 时指向交错的色度平面
+  const uint8_t *u = nullptr;
+  const uint8_t *v = nullptr;
+  size_t y_step = 0;
+  size_t uv_step = 0;
+  /// NV12/NV21：色度交错存放
+  bool interleaved = false;
+  /// NV21：交错色度中 V 在前
+  bool v_first = false;
+  /// YUYV/UYVY：亮度色度打包存放
+  bool packed = false;
+  bool uyvy = false;
+};
+
+inline int GetYuvSource(ImageFrame &src, YuvSource *out) {
+  uint32_t w = src.Width();
+  uint32_t h = src.Height();
+  uint8_t *data = src.Data();
+  if (data == nullptr || w == 0 || h == 0) {
+    return -1;
+  }
+  uint32_t cw = (w + 1) / 2;
+  YuvSource s;
+  s.y = data;
+  switch (src.pixel_format) {
+    case kPGPixelFormatRawNV12:
+    case kPGPixelFormatRawNV21:
+      s.y_step = FrameRowStep(src.Stride(), w, 1);
+      s.uv_step = src.StrideUV() != 0 ? FrameRowStep(src.StrideUV(), cw, 2)
+                                      : s.y_step;
+      s.u = src.DataUV() != nullptr ? src.DataUV() : data + s.y_step * h;
+      s.interleaved = true;
+      s.v_first = src.pixel_format == kPGPixelFormatRawNV21;
+      break;
+    case kPGPixelFormatRawI420:
+    case kPGPixelFormatRawYV12: {
+      s.y_step = FrameRowStep(src.Stride(), w, 1);
+      s.uv_step = src.StrideUV() != 0 ? FrameRowStep(src.StrideUV(), cw, 1)
+                                      : (s.y_step + 1) / 2;
+      const uint8_t *first =
+          src.DataUV() != nullptr ? src.DataUV() : data + s.y_step * h;
+      const uint8_t *second = first + s.uv_step * ((h + 1) / 2);
+      bool yv12 = src.pixel_format == kPGPixelFormatRawYV12;
+      s.u = yv12 ? second : first;
+      s.v = yv12 ? first : second;
+      break;
+    }
+    case kPGPixelFormatYUYV:
+    case kPGPixelFormatUYVY:
+      s.y_step = FrameRowStep(src.Stride(), w, 2);
+      s.packed = true;
+      s.uyvy = src.pixel_format == kPGPixelFormatUYVY;
+      break;
+    default:
+      return -1;
+  }
+  *out = s;
+  return 0;
+}
+
+inline std::vector<uint8_t> &CvtScratch() {
+  thread_local std::vector<uint8_t> scratch;
+  return scratch;
+}
+
+/// 单平面 8 位格式的通道数，不支持时返回 0
+inline int PackedChannels(PGPixelFormat format) {
+  switch (format) {
+    case kPGPixelFormatRawGRAY:
+    case kPGPixelFormatUint8:
+      return 1;
+    case kPGPixelFormatRawBGR:
+    case kPGPixelFormatRawRGB:
+    case kPGPixelFormatYUV444:
+      return 3;
+    case kPGPixelFormatRawBGRA:
+    case kPGPixelFormatRawRGBA:
+    case kPGPixelFormatRawARGB:
+    case kPGPixelFormatRawABGR:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+inline void CopyFrameInfo(ImageFrame &src, ImageFrame *dst) {
+  dst->channel_id = src.channel_id;
+  dst->time_stamp = src.time_stamp;
+  dst->frame_id = src.frame_id;
+  dst->type = src.type;
+}
+
+}  // namespace detail
+
+/**
+ * @brief 颜色转换，支持 NV12/NV21/I420/YV12/YUYV/UYVY 转 BGR/RGB/GRAY，
+ * 以及 GRAY 转 BGR/RGB。YUV 转 BGR/RGB 使用 BT.601 limited range，
+ * 按运行时检测的指令集（AVX2/SSE4.1/NEON/标量）分发
+ *
+ * @param src [in] 源图像，Stride()/DataUV()/StrideUV() 均被使用
+ * @param target_format [in] kPGPixelFormatRawBGR/RGB/GRAY
+ * @param pool [in] 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+ * @return ImageFramePtr 输出帧，继承 channel_id/time_stamp/frame_id/type；
+ * 不支持的转换返回 nullptr
+ */
+inline ImageFramePtr CvtColorFrame(ImageFrame &src,
+                                   PGPixelFormat target_format,
+                                   ImageFramePool *pool = nullptr) {
+  bool to_gray = target_format == kPGPixelFormatRawGRAY;
+  bool rgb = target_format == kPGPixelFormatRawRGB;
+  if (!to_gray && !rgb && target_format != kPGPixelFormatRawBGR) {
+    return nullptr;
+  }
+  int w = static_cast<int>(src.Width());
+  int h = static_cast<int>(src.Height());
+  if (pool == nullptr) {
+    pool = &DefaultImageFramePool();
+  }
+  if (src.pixel_format == kPGPixelFormatRawGRAY) {
+    if (to_gray || src.Data() == nullptr) {
+      return nullptr;
+    }
+    ImageFramePtr dst = pool->Acquire(target_format, w, h);
+    if (!dst) {
+      return nullptr;
+    }
+    size_t step = FrameRowStep(src.Stride(), w, 1);
+    size_t dst_step = FrameRowStep(dst->Stride(), w, 3);
+    for (int r = 0; r < h; ++r) {
+      const uint8_t *in = src.Data() + step * r;
+      uint8_t *out = dst->Data() + dst_step * r;
+      for (int x = 0; x < w; ++x) {
+        out[3 * x] = out[3 * x + 1] = out[3 * x + 2] = in[x];
+      }
+    }
+    detail::CopyFrameInfo(src, dst.get());
+    return dst;
+  }
+  detail::YuvSource s;
+  if (detail::GetYuvSource(src, &s) != 0) {
+    return nullptr;
+  }
+  ImageFramePtr dst = pool->Acquire(target_format, w, h);
+  if (!dst) {
+    return nullptr;
+  }
+  size_t dst_step = FrameRowStep(dst->Stride(), w, to_gray ? 1 : 3);
+  int cw = (w + 1) / 2;
+  auto &scratch = detail::CvtScratch();
+  if (scratch.size() < static_cast<size_t>(w + 2 * cw)) {
+    scratch.resize(w + 2 * cw);
+  }
+  uint8_t *tmp_y = scratch.data();
+  uint8_t *tmp_u = tmp_y + w;
+  uint8_t *tmp_v = tmp_u + cw;
+  int split_row = -1;
+  for (int r = 0; r < h; ++r) {
+    const uint8_t *y = s.y + s.y_step * r;
+    const uint8_t *u = nullptr;
+    const uint8_t *v = nullptr;
+    uint8_t *out = dst->Data() + dst_step * r;
+    if (s.packed) {
+      if (to_gray) {
+        cvt::SplitPackedYuvRow(y, out, tmp_u, tmp_v, w, s.uyvy);
+        continue;
+      }
+      cvt::SplitPackedYuvRow(y, tmp_y, tmp_u, tmp_v, w, s.uyvy);
+      y = tmp_y;
+      u = tmp_u;
+      v = tmp_v;
+    } else if (to_gray) {
+      memcpy(out, y, w);
+      continue;
+    } else if (s.interleaved) {
+      if (split_row != r / 2) {
+        const uint8_t *uv = s.u + s.uv_step * (r / 2);
+        cvt::SplitChromaRow(uv, s.v_first ? tmp_v : tmp_u,
+                            s.v_first ? tmp_u : tmp_v, cw);
+        split_row = r / 2;
+      }
+      u = tmp_u;
+      v = tmp_v;
+    } else {
+      u = s.u + s.uv_step * (r / 2);
+      v = s.v + s.uv_step * (r / 2);
+    }
+    cvt::YuvRowToBgr(y, u, v, out, w, rgb);
+  }
+  detail::CopyFrameInfo(src, dst.get());
+  return dst;
+}
+
+/**
+ * @brief 裁剪并缩放，单次遍历完成，YUV420 格式直接在 Y/UV 平面上处理，
+ * 输出格式与输入相同。整数倍缩小使用区域平均，其他情况使用双线性插值，
+ * 按运行时检测的指令集分发
+ * @note YUV420 格式的 roi_x/roi_y 向下取偶数以保持色度对齐
+ *
+ * @param src [in] 源图像，支持 GRAY/BGR/RGB/4 通道/NV12/NV21/I420/YV12
+ * @param target_w [in] 输出宽度，为 0 时与 ROI 相同
+ * @param target_h [in] 输出高度，为 0 时与 ROI 相同
+ * @param roi_x [in] ROI 左上角 x
+ * @param roi_y [in] ROI 左上角 y
+ * @param roi_w [in] ROI 宽度，为 0 时到图像右边缘
+ * @param roi_h [in] ROI 高度，为 0 时到图像下边缘
+ * @param pool [in] 输出帧所用的缓存池，为空时使用 DefaultImageFramePool()
+ * @return ImageFramePtr 输出帧，继承 channel_id/time_stamp/frame_id/type；
+ * ROI 越界或格式不支持时返回 nullptr
+ */
+inline ImageFramePtr ResizeFrame(ImageFrame &src, uint32_t target_w,
+                                 uint32_t target_h, uint32_t roi_x,
+                                 uint32_t roi_y, uint32_t roi_w,
+                                 uint32_t roi_h,
+                                 ImageFramePool *pool = nullptr) {
+  uint32_t width = src.Width();
+  uint32_t height = src.Height();
+  PGPixelFormat format = src.pixel_format;
+  bool semi_planar =
+      format == kPGPixelFormatRawNV12 || format == kPGPixelFormatRawNV21;
+  bool planar =
+      format == kPGPixelFormatRawI420 || format == kPGPixelFormatRawYV12;
+  if (semi_planar || planar) {
+    roi_x &= ~1u;
+    roi_y &= ~1u;
+  }
+  if (src.Data() == nullptr || roi_x >= width || roi_y >= height) {
+    return nullptr;
+  }
+  if (roi_w == 0) {
+    roi_w = width - roi_x;
+  }
+  if (roi_h == 0) {
+    roi_h = height - roi_y;
+  }
+  if (roi_w > width - roi_x || roi_h > height - roi_y) {
+    return nullptr;
+  }
+  if (target_w == 0) {
+    target_w = roi_w;
+  }
+  if (target_h == 0) {
+    target_h = roi_h;
+  }
+  int cn = detail::PackedChannels(format);
+  if (cn == 0 && !semi_planar && !planar) {
+    return nullptr;
+  }
+  if (pool == nullptr) {
+    pool = &DefaultImageFramePool();
+  }
+  ImageFramePtr dst = pool->Acquire(format, target_w, target_h);
+  if (!dst) {
+    return nullptr;
+  }
+  if (cn > 0) {
+    size_t step = FrameRowStep(src.Stride(), width, cn);
+    resize::ResizePlane(src.Data() + step * roi_y + roi_x * cn, step, cn,
+                        roi_w, roi_h, dst->Data(),
+                        FrameRowStep(dst->Stride(), target_w, cn), target_w,
+                        target_h);
+    detail::CopyFrameInfo(src, dst.get());
+    return dst;
+  }
+  detail::YuvSource s;
+  if (detail::GetYuvSource(src, &s) != 0) {
+    return nullptr;
+  }
+  resize::ResizePlane(s.y + s.y_step * roi_y + roi_x, s.y_step, 1, roi_w,
+                      roi_h, dst->Data(),
+                      FrameRowStep(dst->Stride(), target_w, 1), target_w,
+                      target_h);
+  uint32_t cx = roi_x / 2;
+  uint32_t cy = roi_y / 2;
+  int src_cw = static_cast<int>((roi_w + 1) / 2);
+  int src_ch = static_cast<int>((roi_h + 1) / 2);
+  int dst_cw = static_cast<int>((target_w + 1) / 2);
+  int dst_ch = static_cast<int>((target_h + 1) / 2);
+  size_t dst_uv_step =
+      FrameRowStep(dst->StrideUV(), dst_cw, semi_planar ? 2 : 1);
+  uint8_t *dst_uv = dst->DataUV();
+  if (semi_planar) {
+    resize::ResizePlane(s.u + s.uv_step * cy + cx * 2, s.uv_step, 2, src_cw,
+                        src_ch, dst_uv, dst_uv_step, dst_cw, dst_ch);
+  } else {
+    // 两个色度平面按存放顺序对应，YV12 输出仍为 V 在前
+    bool yv12 = format == kPGPixelFormatRawYV12;
+    const uint8_t *first = yv12 ? s.v : s.u;
+    const uint8_t *second = yv12 ? s.u : s.v;
+    uint8_t *dst_second = dst_uv + dst_uv_step * dst_ch;
+    resize::ResizePlane(first + s.uv_step * cy + cx, s.uv_step, 1, src_cw,
+                        src_ch, dst_uv, dst_uv_step, dst_cw, dst_ch);
+    resize::ResizePlane(second + s.uv_step * cy + cx, s.uv_step, 1, src_cw,
+                        src_ch, dst_second, dst_uv_step, dst_cw, dst_ch);
+  }
+  detail::CopyFrameInfo(src, dst.get());
+  return dst;
+}
+
+}  // namespace vision
+}  // namespace phigent
+
+#endif  // VISION_TYPE_IMAGE_FRAME_OPS_HPP_
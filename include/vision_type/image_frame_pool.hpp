@@ -0,0 +1,284 @@
+/**
+ * @file image_frame_pool.hpp
+ * @brief 可回收的 ImageFrameImpl/DataBuffer 缓存池
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef VISION_TYPE_IMAGE_FRAME_POOL_HPP_
+#define VISION_TYPE_IMAGE_FRAME_POOL_HPP_
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "vision_type/base_type.hpp"
+
+namespace phigent {
+namespace vision {
+
+/**
+ * \~Chinese @brief 缓存池统计信息
+ */
+struct ImageFramePoolStats {
+  /// \~Chinese 复用了空闲缓存的次数
+  uint64_t hits = 0;
+  /// \~Chinese 需要重新分配内存的次数（池耗尽或缓存容量不足）
+  uint64_t misses = 0;
+  /// \~Chinese 当前被占用的缓存数
+  size_t in_use = 0;
+  /// \~Chinese 历史最大同时占用数
+  size_t high_water_mark = 0;
+  /// \~Chinese 缓存池容量
+  size_t capacity = 0;
+};
+
+namespace detail {
+
+/// shared_ptr 控制块预留空间，避免每次分配控制块
+constexpr size_t kFramePoolArenaSize = 128;
+constexpr size_t kFramePoolAlignment = 64;
+
+struct FramePoolState;
+
+struct FramePoolSlot {
+  ImageFrameImpl frame;
+  DataBufferPtr buffer;
+  size_t buffer_capacity = 0;
+  alignas(std::max_align_t) unsigned char arena[kFramePoolArenaSize];
+};
+
+struct FramePoolState {
+  explicit FramePoolState(size_t capacity) {
+    slots.reserve(capacity);
+    free_slots.reserve(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+      slots.emplace_back(new FramePoolSlot());
+      free_slots.push_back(slots.back().get());
+    }
+  }
+
+  FramePoolSlot *Pop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free_slots.empty()) {
+      return nullptr;
+    }
+    FramePoolSlot *slot = free_slots.back();
+    free_slots.pop_back();
+    size_t used = slots.size() - free_slots.size();
+    if (used > high_water_mark) {
+      high_water_mark = used;
+    }
+    return slot;
+  }
+
+  void Recycle(FramePoolSlot *slot) {
+    slot->frame.DataBuffer_.reset();
+    // 外部仍持有 DataBuffer 时不能复用这块内存，下次使用时重新分配
+    if (slot->buffer && (slot->buffer.use_count() != 1 ||
+                         slot->buffer->data.use_count() != 1)) {
+      slot->buffer.reset();
+      slot->buffer_capacity = 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    free_slots.push_back(slot);
+  }
+
+  std::vector<std::unique_ptr<FramePoolSlot>> slots;
+  std::vector<FramePoolSlot *> free_slots;
+  size_t high_water_mark = 0;
+  std::atomic<uint64_t> hits{0};
+  std::atomic<uint64_t> misses{0};
+  std::mutex mutex;
+};
+
+/// 空删除器，帧对象属于缓存池
+struct FramePoolNoopDeleter {
+  void operator()(ImageFrame *) const {}
+};
+
+/**
+ * 为 shared_ptr 控制块提供内存；控制块释放（最后一个 shared_ptr/weak_ptr
+ * 销毁）时把缓存归还给缓存池
+ */
+template <typename T>
+struct FramePoolSlotAllocator {
+  using value_type = T;
+
+  FramePoolSlotAllocator(FramePoolSlot *_slot,
+                         std::shared_ptr<FramePoolState> _state)
+      : slot(_slot), state(std::move(_state)) {}
+  template <typename U>
+  FramePoolSlotAllocator(const FramePoolSlotAllocator<U> &other)
+      : slot(other.slot), state(other.state) {}
+
+  T *allocate(size_t n) {
+    if (n * sizeof(T) <= kFramePoolArenaSize &&
+        alignof(T) <= alignof(std::max_align_t)) {
+      return reinterpret_cast<T *>(slot->arena);
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t) {
+    if (reinterpret_cast<unsigned char *>(p) != slot->arena) {
+      ::operator delete(p);
+    }
+    state->Recycle(slot);
+  }
+
+  FramePoolSlot *slot;
+  std::shared_ptr<FramePoolState> state;
+};
+
+template <typename T, typename U>
+bool operator==(const FramePoolSlotAllocator<T> &a,
+                const FramePoolSlotAllocator<U> &b) {
+  return a.slot == b.slot;
+}
+template <typename T, typename U>
+bool operator!=(const FramePoolSlotAllocator<T> &a,
+                const FramePoolSlotAllocator<U> &b) {
+  return a.slot != b.slot;
+}
+
+inline DataBufferPtr AllocAlignedDataBuffer(size_t size) {
+  size_t aligned_size =
+      (size + kFramePoolAlignment - 1) / kFramePoolAlignment *
+      kFramePoolAlignment;
+  void *mem = nullptr;
+  if (posix_memalign(&mem, kFramePoolAlignment,
+                     aligned_size > 0 ? aligned_size : kFramePoolAlignment)) {
+    return nullptr;
+  }
+  auto buffer = std::make_shared<DataBuffer>();
+  buffer->data = std::shared_ptr<char>(static_cast<char *>(mem), free);
+  buffer->data_size = size;
+  return buffer;
+}
+
+}  // namespace detail
+
+/**
+ * \~Chinese @brief 固定容量的图像帧缓存池
+ * @note Acquire 返回的 ImageFramePtr 及其 DataBuffer 在最后一个引用释放后
+ * 自动归还缓存池，稳态下不发生堆分配；缓存池耗尽时退化为普通分配并计入
+ * misses。若外部单独持有 GetDataBuffer() 的返回值，该块内存不会被复用。
+ * 缓存池对象可以先于其分配出的帧销毁。线程安全。
+ */
+class ImageFramePool {
+ public:
+  explicit ImageFramePool(size_t capacity)
+      : state_(std::make_shared<detail::FramePoolState>(capacity)) {}
+
+  /**
+   * @brief 获取一帧连续存放的图像
+   *
+   * @param format [in] 图片编码方式
+   * @param width [in] 宽度
+   * @param height [in] 高度
+   * @return ImageFramePtr 失败时返回 nullptr
+   */
+  ImageFramePtr Acquire(PGPixelFormat format, uint32_t width,
+                        uint32_t height) {
+    FrameLayout layout;
+    if (GetFrameLayout(format, width, height, &layout) != 0) {
+      return nullptr;
+    }
+    size_t size = static_cast<size_t>(layout.data_size) + layout.data_uv_size;
+    ImageFrameImpl *frame = nullptr;
+    DataBufferPtr buffer;
+    ImageFramePtr out;
+    detail::FramePoolSlot *slot = state_->Pop();
+    if (slot != nullptr) {
+      if (!slot->buffer || slot->buffer_capacity < size) {
+        slot->buffer = detail::AllocAlignedDataBuffer(size);
+        slot->buffer_capacity = slot->buffer ? size : 0;
+        state_->misses.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        state_->hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (!slot->buffer) {
+        state_->Recycle(slot);
+        return nullptr;
+      }
+      frame = &slot->frame;
+      buffer = slot->buffer;
+      out = ImageFramePtr(
+          frame, detail::FramePoolNoopDeleter(),
+          detail::FramePoolSlotAllocator<ImageFrame>(slot, state_));
+    } else {
+      state_->misses.fetch_add(1, std::memory_order_relaxed);
+      buffer = detail::AllocAlignedDataBuffer(size);
+      if (!buffer) {
+        return nullptr;
+      }
+      auto heap_frame = std::make_shared<ImageFrameImpl>();
+      frame = heap_frame.get();
+      out = heap_frame;
+    }
+    buffer->data_size = size;
+    buffer->elemSize = layout.elem_size;
+    uint8_t *data = reinterpret_cast<uint8_t *>(buffer->data.get());
+    frame->pixel_format = format;
+    frame->channel_id = 0;
+    frame->time_stamp = 0;
+    frame->frame_id = 0;
+    frame->type.clear();
+    frame->float_scale = 1.0f;
+    frame->custom_data_addr = nullptr;
+    frame->virt_data_addr = data;
+    frame->virt_uv_data_addr =
+        layout.data_uv_size > 0 ? data + layout.data_size : nullptr;
+    frame->phy_data_addr = nullptr;
+    frame->phy_uv_data_addr = nullptr;
+    frame->data_size = layout.data_size;
+    frame->data_uv_size = layout.data_uv_size;
+    frame->width = width;
+    frame->height = height;
+    frame->stride = layout.stride;
+    frame->channel = layout.channel;
+    frame->stride_uv = layout.stride_uv;
+    frame->DataBuffer_ = std::move(buffer);
+    return out;
+  }
+
+  /// \~Chinese 统计信息
+  ImageFramePoolStats Stats() const {
+    ImageFramePoolStats stats;
+    stats.hits = state_->hits.load(std::memory_order_relaxed);
+    stats.misses = state_->misses.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    stats.capacity = state_->slots.size();
+    stats.in_use = stats.capacity - state_->free_slots.size();
+    stats.high_water_mark = state_->high_water_mark;
+    return stats;
+  }
+
+  /// \~Chinese 缓存池容量
+  size_t Capacity() const { return state_->slots.size(); }
+
+ private:
+  std::shared_ptr<detail::FramePoolState> state_;
+};
+
+using ImageFramePoolPtr = std::shared_ptr<ImageFramePool>;
+
+/// \~Chinese 进程内共享的缓存池，用于 CvtColorFrame/ResizeFrame 的输出
+inline ImageFramePool &DefaultImageFramePool() {
+  static ImageFramePool pool(16);
+  return pool;
+}
+
+}  // namespace vision
+}  // namespace phigent
+
+#endif  // VISION_TYPE_IMAGE_FRAME_POOL_HPP_
@@ -0,0 +1,500 @@
+/**
+ * @file resize_kernels.hpp
+ * @brief 8 位平面的裁剪缩放 kernel（双线性/整数倍区域平均）
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef VISION_TYPE_RESIZE_KERNELS_HPP_
+#define VISION_TYPE_RESIZE_KERNELS_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "vision_type/simd_dispatch.hpp"
+
+namespace phigent {
+namespace vision {
+namespace resize {
+
+/*
+ * 双线性插值使用 7 位定点权重：
+ * 水平 H = P0 * (128 - wx) + P1 * wx，保存为 int16
+ * 垂直 V = H0 + ((H1 - H0) * (wy << 8) + 0x4000) >> 15（即 pmulhrsw）
+ * 输出 (V + 64) >> 7，所有实现输出逐位一致
+ */
+constexpr int kLinearBits = 7;
+constexpr int kLinearOne = 1 << kLinearBits;
+
+/// 区域平均的最大面积，保证倒数乘法与整数除法结果一致
+constexpr int kMaxAreaSize = 4096;
+/// 区域平均的最大垂直倍数，保证按列累加 ky 行时不溢出 uint16
+constexpr int kMaxAreaRows = 65535 / 255;
+
+/// 单个方向的插值表
+struct LinearTable {
+  std::vector<int32_t> ofs0;
+  std::vector<int32_t> ofs1;
+  std::vector<int16_t> weight;
+};
+
+/**
+ * @brief 计算像素中心对齐的插值表（与 cv::INTER_LINEAR 一致），越界时
+ * 钳位到边缘，不会读取 [0, src_len) 以外的数据
+ */
+inline void BuildLinearTable(int src_len, int dst_len, LinearTable *table) {
+  table->ofs0.resize(dst_len);
+  table->ofs1.resize(dst_len);
+  table->weight.resize(dst_len);
+  double scale = static_cast<double>(src_len) / dst_len;
+  for (int i = 0; i < dst_len; ++i) {
+    double f = (i + 0.5) * scale - 0.5;
+    int i0 = static_cast<int>(std::floor(f));
+    int w = static_cast<int>(std::lround((f - i0) * kLinearOne));
+    if (w >= kLinearOne) {
+      ++i0;
+      w = 0;
+    }
+    if (i0 < 0) {
+      i0 = 0;
+      w = 0;
+    }
+    if (i0 >= src_len - 1) {
+      i0 = src_len - 1;
+      w = 0;
+    }
+    table->ofs0[i] = i0;
+    table->ofs1[i] = i0 + 1 < src_len ? i0 + 1 : i0;
+    table->weight[i] = static_cast<int16_t>(w);
+  }
+}
+
+inline int16_t SatS16(int v) {
+  return static_cast<int16_t>(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+inline void VerticalLinearRowScalar(const int16_t *h0, const int16_t *h1,
+                                    int16_t wy, uint8_t *dst, int begin,
+                                    int count) {
+  int wq = wy << 8;
+  for (int i = begin; i < count; ++i) {
+    int d = static_cast<int16_t>(h1[i] - h0[i]);
+    int v = SatS16(h0[i] + ((d * wq + 0x4000) >> 15));
+    int r = SatS16(v + kLinearOne / 2) >> kLinearBits;
+    dst[i] = static_cast<uint8_t>(r < 0 ? 0 : (r > 255 ? 255 : r));
+  }
+}
+
+inline void AccumulateRowScalar(const uint8_t *src, uint16_t *acc, int begin,
+                                int count) {
+  for (int i = begin; i < count; ++i) {
+    acc[i] = static_cast<uint16_t>(acc[i] + src[i]);
+  }
+}
+
+/// 水平 2 倍区域平均，CN 为 1 或 2，面积为 2 的 shift 次方
+inline void AreaReduceRowX2Scalar(const uint16_t *acc, int cn, int shift,
+                                  uint8_t *out, int begin, int count) {
+  int half = 1 << (shift - 1);
+  for (int j = begin; j < count; ++j) {
+    int i = (j / cn) * 2 * cn + j % cn;
+    out[j] = static_cast<uint8_t>((acc[i] + acc[i + cn] + half) >> shift);
+  }
+}
+
+#if defined(PG_SIMD_X86)
+PG_TARGET_SSE41 inline void AreaReduceRowX2Sse41(const uint16_t *acc, int cn,
+                                                 int shift, uint8_t *out,
+                                                 int count) {
+  // CN 为 2 时先把 [u0 v0 u1 v1] 重排为 [u0 u1 v0 v1]，再相邻相加
+  const __m128i order = cn == 2 ? _mm_setr_epi8(0, 1, 4, 5, 2, 3, 6, 7, 8, 9,
+                                                12, 13, 10, 11, 14, 15)
+                                : _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                                                10, 11, 12, 13, 14, 15);
+  const __m128i half = _mm_set1_epi16(static_cast<int16_t>(1 << (shift - 1)));
+  const __m128i sh = _mm_cvtsi32_si128(shift);
+  int j = 0;
+  for (; j + 16 <= count; j += 16) {
+    const __m128i *in = reinterpret_cast<const __m128i *>(acc + 2 * j);
+    __m128i s[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i a = _mm_shuffle_epi8(_mm_loadu_si128(in + 2 * k), order);
+      __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(in + 2 * k + 1), order);
+      s[k] = _mm_srl_epi16(_mm_add_epi16(_mm_hadd_epi16(a, b), half), sh);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + j),
+                     _mm_packus_epi16(s[0], s[1]));
+  }
+  AreaReduceRowX2Scalar(acc, cn, shift, out, j, count);
+}
+
+PG_TARGET_SSE41 inline void VerticalLinearRowSse41(const int16_t *h0,
+                                                   const int16_t *h1,
+                                                   int16_t wy, uint8_t *dst,
+                                                   int count) {
+  const __m128i wq = _mm_set1_epi16(static_cast<int16_t>(wy << 8));
+  const __m128i half = _mm_set1_epi16(kLinearOne / 2);
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m128i out[2];
+    for (int k = 0; k < 2; ++k) {
+      __m128i a =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(h0 + i + 8 * k));
+      __m128i b =
+          _mm_loadu_si128(reinterpret_cast<const __m128i *>(h1 + i + 8 * k));
+      __m128i v = _mm_adds_epi16(a, _mm_mulhrs_epi16(_mm_sub_epi16(b, a), wq));
+      out[k] = _mm_srai_epi16(_mm_adds_epi16(v, half), kLinearBits);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                     _mm_packus_epi16(out[0], out[1]));
+  }
+  VerticalLinearRowScalar(h0, h1, wy, dst, i, count);
+}
+
+PG_TARGET_AVX2 inline void VerticalLinearRowAvx2(const int16_t *h0,
+                                                 const int16_t *h1,
+                                                 int16_t wy, uint8_t *dst,
+                                                 int count) {
+  const __m256i wq = _mm256_set1_epi16(static_cast<int16_t>(wy << 8));
+  const __m256i half = _mm256_set1_epi16(kLinearOne / 2);
+  int i = 0;
+  for (; i + 32 <= count; i += 32) {
+    __m256i out[2];
+    for (int k = 0; k < 2; ++k) {
+      __m256i a = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(h0 + i + 16 * k));
+      __m256i b = _mm256_loadu_si256(
+          reinterpret_cast<const __m256i *>(h1 + i + 16 * k));
+      __m256i v = _mm256_adds_epi16(
+          a, _mm256_mulhrs_epi16(_mm256_sub_epi16(b, a), wq));
+      out[k] = _mm256_srai_epi16(_mm256_adds_epi16(v, half), kLinearBits);
+    }
+    // packus 按 128 位通道交错，permute 恢复顺序
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi16(out[0], out[1]), 0xD8);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), packed);
+  }
+  VerticalLinearRowScalar(h0, h1, wy, dst, i, count);
+}
+
+PG_TARGET_SSE41 inline void AccumulateRowSse41(const uint8_t *src,
+                                               uint16_t *acc, int count) {
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m128i s = _mm_cvtepu8_epi16(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i)));
+    __m128i *a = reinterpret_cast<__m128i *>(acc + i);
+    _mm_storeu_si128(a, _mm_add_epi16(_mm_loadu_si128(a), s));
+  }
+  AccumulateRowScalar(src, acc, i, count);
+}
+
+PG_TARGET_AVX2 inline void AccumulateRowAvx2(const uint8_t *src,
+                                             uint16_t *acc, int count) {
+  int i = 0;
+  for (; i + 16 <= count; i += 16) {
+    __m256i s = _mm256_cvtepu8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+    __m256i *a = reinterpret_cast<__m256i *>(acc + i);
+    _mm256_storeu_si256(a, _mm256_add_epi16(_mm256_loadu_si256(a), s));
+  }
+  AccumulateRowScalar(src, acc, i, count);
+}
+#endif  // PG_SIMD_X86
+
+#if defined(PG_SIMD_NEON)
+inline void VerticalLinearRowNeon(const int16_t *h0, const int16_t *h1,
+                                  int16_t wy, uint8_t *dst, int count) {
+  const int16x8_t wq = vdupq_n_s16(static_cast<int16_t>(wy << 8));
+  const int16x8_t half = vdupq_n_s16(kLinearOne / 2);
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    int16x8_t a = vld1q_s16(h0 + i);
+    int16x8_t b = vld1q_s16(h1 + i);
+    // vqrdmulh 与 pmulhrsw 的舍入一致
+    int16x8_t v = vqaddq_s16(a, vqrdmulhq_s16(vsubq_s16(b, a), wq));
+    v = vshrq_n_s16(vqaddq_s16(v, half), kLinearBits);
+    vst1_u8(dst + i, vqmovun_s16(v));
+  }
+  VerticalLinearRowScalar(h0, h1, wy, dst, i, count);
+}
+
+inline void AreaReduceRowX2Neon(const uint16_t *acc, int cn, int shift,
+                                uint8_t *out, int count) {
+  const int16x8_t sh = vdupq_n_s16(static_cast<int16_t>(-shift));
+  int j = 0;
+  for (; j + 8 <= count; j += 8) {
+    uint16x8_t a = vld1q_u16(acc + 2 * j);
+    uint16x8_t b = vld1q_u16(acc + 2 * j + 8);
+    uint16x8_t sum;
+    if (cn == 2) {
+      // 以 32 位为单位拆分奇偶，得到相邻像素的同一通道
+      uint32x4x2_t p =
+          vuzpq_u32(vreinterpretq_u32_u16(a), vreinterpretq_u32_u16(b));
+      sum = vaddq_u16(vreinterpretq_u16_u32(p.val[0]),
+                      vreinterpretq_u16_u32(p.val[1]));
+    } else {
+      uint16x8x2_t p = vuzpq_u16(a, b);
+      sum = vaddq_u16(p.val[0], p.val[1]);
+    }
+    // vrshl 负移位为带舍入的右移
+    vst1_u8(out + j, vqmovn_u16(vrshlq_u16(sum, sh)));
+  }
+  AreaReduceRowX2Scalar(acc, cn, shift, out, j, count);
+}
+
+inline void AccumulateRowNeon(const uint8_t *src, uint16_t *acc, int count) {
+  int i = 0;
+  for (; i + 8 <= count; i += 8) {
+    vst1q_u16(acc + i, vaddw_u8(vld1q_u16(acc + i), vld1_u8(src + i)));
+  }
+  AccumulateRowScalar(src, acc, i, count);
+}
+#endif  // PG_SIMD_NEON
+
+/**
+ * @brief 两行水平插值结果做垂直插值并输出
+ *
+ * @param h0 [in] 上一行水平插值结果
+ * @param h1 [in] 下一行水平插值结果
+ * @param wy [in] 下一行的权重，[0, 128)
+ * @param dst [out] 输出行
+ * @param count [in] 元素数（宽度 * 通道数）
+ */
+inline void VerticalLinearRow(const int16_t *h0, const int16_t *h1,
+                              int16_t wy, uint8_t *dst, int count) {
+  switch (GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      VerticalLinearRowAvx2(h0, h1, wy, dst, count);
+      return;
+    case SimdLevel::kSse41:
+      VerticalLinearRowSse41(h0, h1, wy, dst, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      VerticalLinearRowNeon(h0, h1, wy, dst, count);
+      return;
+#endif
+    default:
+      VerticalLinearRowScalar(h0, h1, wy, dst, 0, count);
+      return;
+  }
+}
+
+/// acc[i] += src[i]
+inline void AccumulateRow(const uint8_t *src, uint16_t *acc, int count) {
+  switch (GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+      AccumulateRowAvx2(src, acc, count);
+      return;
+    case SimdLevel::kSse41:
+      AccumulateRowSse41(src, acc, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      AccumulateRowNeon(src, acc, count);
+      return;
+#endif
+    default:
+      AccumulateRowScalar(src, acc, 0, count);
+      return;
+  }
+}
+
+/// 水平 2 倍区域平均，count 为输出元素数（宽度 * 通道数）
+inline void AreaReduceRowX2(const uint16_t *acc, int cn, int shift,
+                            uint8_t *out, int count) {
+  switch (GetSimdLevel()) {
+#if defined(PG_SIMD_X86)
+    case SimdLevel::kAvx2:
+    case SimdLevel::kSse41:
+      AreaReduceRowX2Sse41(acc, cn, shift, out, count);
+      return;
+#endif
+#if defined(PG_SIMD_NEON)
+    case SimdLevel::kNeon:
+      AreaReduceRowX2Neon(acc, cn, shift, out, count);
+      return;
+#endif
+    default:
+      AreaReduceRowX2Scalar(acc, cn, shift, out, 0, count);
+      return;
+  }
+}
+
+/// 区域平均的水平部分：acc 中每 kx 个像素求和并除以面积
+template <int CN>
+inline void AreaReduceRow(const uint16_t *acc, int kx, int dst_w, int area,
+                          uint64_t inv, uint8_t *out) {
+  for (int x = 0; x < dst_w; ++x) {
+    const uint16_t *a = acc + x * kx * CN;
+    for (int c = 0; c < CN; ++c) {
+      uint32_t sum = area / 2;
+      for (int k = 0; k < kx; ++k) {
+        sum += a[k * CN + c];
+      }
+      out[x * CN + c] = static_cast<uint8_t>((sum * inv) >> 32);
+    }
+  }
+}
+
+template <int CN>
+inline void AreaResizePlane(const uint8_t *src, size_t src_step, int src_w,
+                            int kx, int ky, uint8_t *dst, size_t dst_step,
+                            int dst_w, int dst_h) {
+  thread_local std::vector<uint16_t> acc;
+  int count = src_w * CN;
+  acc.resize(count);
+  int area = kx * ky;
+  // 向上取整的倒数，area <= kMaxAreaSize 时 (s * inv) >> 32 == s / area
+  uint64_t inv = ((uint64_t(1) << 32) + area - 1) / area;
+  // 常见的水平 2 倍、面积为 2 的幂且累加不溢出 uint16 的情况走 SIMD
+  int shift = 0;
+  while ((1 << shift) < area) {
+    ++shift;
+  }
+  bool x2 = CN <= 2 && kx == 2 && (1 << shift) == area && ky <= 64;
+  for (int y = 0; y < dst_h; ++y) {
+    const uint8_t *in = src + src_step * y * ky;
+    memset(acc.data(), 0, count * sizeof(uint16_t));
+    for (int k = 0; k < ky; ++k) {
+      AccumulateRow(in + src_step * k, acc.data(), count);
+    }
+    if (x2) {
+      AreaReduceRowX2(acc.data(), CN, shift, dst + dst_step * y, dst_w * CN);
+    } else {
+      AreaReduceRow<CN>(acc.data(), kx, dst_w, area, inv,
+                        dst + dst_step * y);
+    }
+  }
+}
+
+/// 水平插值一行，CN 为交错通道数（NV12 色度为 2）
+template <int CN>
+inline void HorizontalLinearRow(const uint8_t *src, const LinearTable &xt,
+                                int dst_w, int16_t *dst) {
+  const int32_t *ofs0 = xt.ofs0.data();
+  const int32_t *ofs1 = xt.ofs1.data();
+  const int16_t *weight = xt.weight.data();
+  for (int x = 0; x < dst_w; ++x) {
+    const uint8_t *p0 = src + ofs0[x] * CN;
+    const uint8_t *p1 = src + ofs1[x] * CN;
+    int w1 = weight[x];
+    int w0 = kLinearOne - w1;
+    for (int c = 0; c < CN; ++c) {
+      dst[x * CN + c] = static_cast<int16_t>(p0[c] * w0 + p1[c] * w1);
+    }
+  }
+}
+
+template <int CN>
+inline void LinearResizePlane(const uint8_t *src, size_t src_step, int src_w,
+                              int src_h, uint8_t *dst, size_t dst_step,
+                              int dst_w, int dst_h) {
+  thread_local LinearTable xt;
+  thread_local LinearTable yt;
+  thread_local std::vector<int16_t> rows;
+  BuildLinearTable(src_w, dst_w, &xt);
+  BuildLinearTable(src_h, dst_h, &yt);
+  int row = dst_w * CN;
+  rows.resize(static_cast<size_t>(row) * 2);
+  int16_t *buf[2] = {rows.data(), rows.data() + row};
+  int buf_row[2] = {-1, -1};
+  for (int y = 0; y < dst_h; ++y) {
+    int y0 = yt.ofs0[y];
+    int y1 = yt.ofs1[y];
+    // 两行缓存按源行号复用，缩小时每个源行最多做一次水平插值
+    if (buf_row[0] != y0) {
+      if (buf_row[1] == y0) {
+        std::swap(buf[0], buf[1]);
+        std::swap(buf_row[0], buf_row[1]);
+      } else {
+        HorizontalLinearRow<CN>(src + src_step * y0, xt, dst_w, buf[0]);
+        buf_row[0] = y0;
+      }
+    }
+    if (buf_row[1] != y1) {
+      HorizontalLinearRow<CN>(src + src_step * y1, xt, dst_w, buf[1]);
+      buf_row[1] = y1;
+    }
+    VerticalLinearRow(buf[0], buf[1], yt.weight[y], dst + dst_step * y, row);
+  }
+}
+
+template <int CN>
+inline void ResizePlaneImpl(const uint8_t *src, size_t src_step, int src_w,
+                            int src_h, uint8_t *dst, size_t dst_step,
+                            int dst_w, int dst_h) {
+  int kx = src_w / dst_w;
+  int ky = src_h / dst_h;
+  if (kx * dst_w == src_w && ky * dst_h == src_h && kx * ky > 1 &&
+      kx * ky <= kMaxAreaSize && ky <= kMaxAreaRows) {
+    AreaResizePlane<CN>(src, src_step, src_w, kx, ky, dst, dst_step, dst_w,
+                        dst_h);
+  } else {
+    LinearResizePlane<CN>(src, src_step, src_w, src_h, dst, dst_step, dst_w,
+                          dst_h);
+  }
+}
+
+/**
+ * @brief 裁剪缩放一个 8 位平面。缩小倍数为整数、面积不超过 kMaxAreaSize 且
+ * 垂直倍数不超过 kMaxAreaRows 时使用区域平均（与 cv::INTER_AREA 一致，
+ * 抗混叠），尺寸不变时直接拷贝，其他情况使用双线性插值
+ *
+ * @param src [in] ROI 左上角
+ * @param src_step [in] 源行字节数
+ * @param cn [in] 交错通道数，1~4
+ * @param src_w [in] ROI 宽度（像素）
+ * @param src_h [in] ROI 高度
+ * @param dst [out] 输出平面
+ * @param dst_step [in] 输出行字节数
+ * @param dst_w [in] 输出宽度（像素）
+ * @param dst_h [in] 输出高度
+ */
+inline void ResizePlane(const uint8_t *src, size_t src_step, int cn,
+                        int src_w, int src_h, uint8_t *dst, size_t dst_step,
+                        int dst_w, int dst_h) {
+  if (src_w == dst_w && src_h == dst_h) {
+    for (int y = 0; y < dst_h; ++y) {
+      memcpy(dst + dst_step * y, src + src_step * y, dst_w * cn);
+    }
+    return;
+  }
+  switch (cn) {
+    case 1:
+      ResizePlaneImpl<1>(src, src_step, src_w, src_h, dst, dst_step, dst_w,
+                         dst_h);
+      break;
+    case 2:
+      ResizePlaneImpl<2>(src, src_step, src_w, src_h, dst, dst_step, dst_w,
+                         dst_h);
+      break;
+    case 3:
+      ResizePlaneImpl<3>(src, src_step, src_w, src_h, dst, dst_step, dst_w,
+                         dst_h);
+      break;
+    case 4:
+      ResizePlaneImpl<4>(src, src_step, src_w, src_h, dst, dst_step, dst_w,
+                         dst_h);
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace resize
+}  // namespace vision
+}  // namespace phigent
+
+#endif  // VISION_TYPE_RESIZE_KERNELS_HPP_
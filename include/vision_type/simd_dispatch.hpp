@@ -0,0 +1,102 @@
+/**
+ * @file simd_dispatch.hpp
+ * @brief SIMD 指令集运行时检测
+ * @version 0.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026 PhiGent
+ *
+ */
+
+#ifndef VISION_TYPE_SIMD_DISPATCH_HPP_
+#define VISION_TYPE_SIMD_DISPATCH_HPP_
+
+#include <atomic>
+
+// 定义 PG_DISABLE_SIMD 时所有 kernel 使用标量实现
+#if !defined(PG_DISABLE_SIMD) && (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define PG_SIMD_X86 1
+#include <immintrin.h>
+#define PG_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define PG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if !defined(PG_DISABLE_SIMD) && (defined(__ARM_NEON) || defined(__aarch64__))
+#define PG_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace phigent {
+namespace vision {
+
+/**
+ * \~Chinese @brief 可用的 SIMD 指令集
+ */
+enum class SimdLevel {
+  kScalar = 0,
+  kSse41 = 1,
+  kAvx2 = 2,
+  kNeon = 3,
+};
+
+namespace detail {
+
+inline SimdLevel DetectSimdLevel() {
+#if defined(PG_SIMD_X86)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return SimdLevel::kSse41;
+  }
+  return SimdLevel::kScalar;
+#elif defined(PG_SIMD_NEON)
+  return SimdLevel::kNeon;
+#else
+  return SimdLevel::kScalar;
+#endif
+}
+
+inline std::atomic<int> &SimdLevelOverride() {
+  static std::atomic<int> level{-1};
+  return level;
+}
+
+}  // namespace detail
+
+/// \~Chinese 当前使用的 SIMD 指令集，首次调用时检测
+inline SimdLevel GetSimdLevel() {
+  int level = detail::SimdLevelOverride().load(std::memory_order_relaxed);
+  if (level >= 0) {
+    return static_cast<SimdLevel>(level);
+  }
+  static const SimdLevel detected = detail::DetectSimdLevel();
+  return detected;
+}
+
+/**
+ * @brief 限制使用的指令集（用于对比测试），不能高于 CPU 支持的指令集
+ *
+ * @param level [in] 指令集
+ * @return int 0 when success
+ */
+inline int SetSimdLevel(SimdLevel level) {
+  static const SimdLevel detected = detail::DetectSimdLevel();
+  if (level != SimdLevel::kScalar &&
+      (level == SimdLevel::kNeon) != (detected == SimdLevel::kNeon)) {
+    return -1;
+  }
+  if (static_cast<int>(level) > static_cast<int>(detected)) {
+    return -1;
+  }
+  detail::SimdLevelOverride().store(static_cast<int>(level),
+                                    std::memory_order_relaxed);
+  return 0;
+}
+
+}  // namespace vision
+}  // namespace phigent
+
+#endif  // VISION_TYPE_SIMD_DISPATCH_HPP_
@@ -5,8 +5,8 @@
 
 #include "glog/logging.h"
 #include "opencv2/opencv.hpp"
-#include "pg/utils/opencv_helper.hpp"
-#include "pg/vidar_interface.hpp"
+#include "pg/utils/async_frame_writer.hpp"
+#include "pg/vidar_backend.hpp"
 
 static std::string ReadTextFile(const std::string &file_name) {
   FILE *fd = fopen(file_name.c_str(), "r");
@@ -53,13 +53,16 @@ class FpsCounter {
 
 int main(int argc, char const *argv[]) {
   if (argc < 2) {
-    printf("usage: %s <path to config file>", argv[0]);
+    printf("usage: %s <path to config file> <path to flow file> [type]",
+           argv[0]);
     return -1;
   }
   const char *cfg_file_name = argv[1];
   const char *flow_file_name = argv[2];
   using namespace pg::vidar;
-  std::unique_ptr<VidarInterface> vidar(VidarInterface::Create());
+  // type: default（设备）、replay（回放录制目录）、synthetic（合成数据）
+  std::unique_ptr<VidarInterface> vidar(
+      CreateVidarInterface(argc > 3 ? argv[3] : "default"));
   auto conf_json = ReadTextFile(cfg_file_name);
   auto flow_json = ReadTextFile(flow_file_name);
   int Init_Status = vidar->Init(conf_json);
@@ -70,6 +73,8 @@ int main(int argc, char const *argv[]) {
         "and connectioned of USB";
     return 0;
   }
+  // 图像在后台线程编码保存，Output fps 反映的是 SDK 的吞吐
+  pg::utils::AsyncFrameWriter frame_writer;
   FpsCounter fps_counter;
   FpsCounter imu_counter;
   VidarData vidar_data;
@@ -92,21 +97,16 @@ int main(int argc, char const *argv[]) {
     if (counter % 100 == 0) {
       LOG(INFO) << "Output fps=" << fps_counter.Compute();
       fps_counter.Update(0, std::chrono::high_resolution_clock::now());
+      auto stats = frame_writer.Stats();
+      LOG(INFO) << "Frame writer written=" << stats.written
+                << " dropped=" << stats.dropped
+                << " encode_avg_us=" << stats.encode_us_avg
+                << " encode_max_us=" << stats.encode_us_max;
     }
-    
+
     for (auto &img : vidar_data.images) {
-     cv::Mat raw_mat, bgr_mat;
-      pg::utils::helper::ImageFrame2CvMat(*img, raw_mat, false, false);
-      if (kPGPixelFormatRawI420 == img->pixel_format) {
-        cv::cvtColor(raw_mat, bgr_mat, cv::COLOR_YUV2BGR_I420);
-      } else if (kPGPixelFormatRawGRAY == img->pixel_format) {
-        cv::cvtColor(raw_mat, bgr_mat, cv::COLOR_GRAY2BGR);
-      }
-      // cv::imshow(std::to_string(img->channel_id), bgr_mat);
-      cv::imwrite(std::to_string(img->time_stamp) + "_ns_" +
-                     std::to_string(img->channel_id) + ".png",
-                 bgr_mat);
-      LOG(INFO) << "recv channel_id=" << img->channel_id;
+      frame_writer.Enqueue(img);
+      VLOG(1) << "recv channel_id=" << img->channel_id;
     }
     
     for (auto &imu : vidar_data.imu) {
@@ -118,11 +118,11 @@ int main(int argc, char const *argv[]) {
         imu_counter.Update(0, std::chrono::high_resolution_clock::now());
       }
     }
-    auto key = cv::waitKey(5);
-    if (key == 'x' || counter > 1000) {
+    if (counter > 1000) {
       break;
     }
   }
+  frame_writer.Flush();
   vidar->Deinit();
 
   return 0;